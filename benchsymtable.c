@@ -0,0 +1,914 @@
+/*--------------------------------------------------------------------*/
+/* benchsymtable.c                                                    */
+/* Author: Chinmayi R                                                 */
+/*--------------------------------------------------------------------*/
+
+/* clock_gettime and CLOCK_MONOTONIC are POSIX, not C99. */
+#define _POSIX_C_SOURCE 199309L
+
+#include "symtable.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+
+/*--------------------------------------------------------------------*/
+
+/* Sink for results that are computed only to be timed, so that the
+   compiler cannot drop the computation. */
+static volatile size_t uSink;
+
+/*--------------------------------------------------------------------*/
+
+/* Return the current monotonic wall-clock time in nanoseconds. */
+
+static double nowNs(void)
+{
+   struct timespec sTime;
+   clock_gettime(CLOCK_MONOTONIC, &sTime);
+   return (double)sTime.tv_sec * 1e9 + (double)sTime.tv_nsec;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Put iBindingCount bindings into a new SymTable object, timing each
+   SymTable_put() call.  Write to stdout the total time, the mean time
+   per put, the slowest put (which is the one that triggers the
+   largest resize), the number of puts that took longer than
+   100 microseconds, and the time SymTable_free() takes to tear the
+   table down. */
+
+static void benchInsertSpikes(int iBindingCount)
+{
+   enum {MAX_KEY_LENGTH = 16};
+   const double SPIKE_NS = 100000.0;
+
+   SymTable_T oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   int i;
+   int iSpikes = 0;
+   double dStart;
+   double dElapsed;
+   double dTotal = 0.0;
+   double dMax = 0.0;
+
+   oSymTable = SymTable_new();
+   assert(oSymTable != NULL);
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      dStart = nowNs();
+      SymTable_put(oSymTable, acKey, NULL);
+      dElapsed = nowNs() - dStart;
+      dTotal += dElapsed;
+      if (dElapsed > dMax)
+         dMax = dElapsed;
+      if (dElapsed > SPIKE_NS)
+         iSpikes++;
+   }
+
+   dStart = nowNs();
+   SymTable_free(oSymTable);
+   dElapsed = nowNs() - dStart;
+
+   printf("insert  n=%-9d total=%10.3f ms  mean=%8.1f ns  "
+      "max=%10.1f us  spikes>100us=%-4d free=%9.3f ms\n",
+      iBindingCount, dTotal / 1e6, dTotal / iBindingCount,
+      dMax / 1e3, iSpikes, dElapsed / 1e6);
+   fflush(stdout);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return -1, 0 or 1 as the double that pv1 points to is less than,
+   equal to or greater than the one pv2 points to. */
+
+static int compareDoubles(const void *pv1, const void *pv2)
+{
+   double d1 = *(const double*)pv1;
+   double d2 = *(const double*)pv2;
+   return (d1 > d2) - (d1 < d2);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Put iBindingCount bindings into a new SymTable object that resizes
+   incrementally if iIncremental, or all at once otherwise, timing each
+   SymTable_put() call.  Write to stdout the median, 99th, 99.9th
+   percentile and slowest put, then a histogram of put times in
+   power-of-two nanosecond bins.  Write nothing if the implementation
+   does not support the requested mode. */
+
+static void benchInsertLatency(int iBindingCount, int iIncremental)
+{
+   enum {MAX_KEY_LENGTH = 16, BIN_COUNT = 40};
+
+   SymTable_T oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   double *pdTimes;
+   int aiBins[BIN_COUNT];
+   int i;
+   int iBin;
+   double dStart;
+   double dBound;
+
+   oSymTable = SymTable_new();
+   assert(oSymTable != NULL);
+   if (! SymTable_setIncrementalResize(oSymTable, iIncremental))
+   {
+      SymTable_free(oSymTable);
+      return;
+   }
+   pdTimes = malloc((size_t)iBindingCount * sizeof(*pdTimes));
+   assert(pdTimes != NULL);
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      dStart = nowNs();
+      SymTable_put(oSymTable, acKey, NULL);
+      pdTimes[i] = nowNs() - dStart;
+   }
+   SymTable_free(oSymTable);
+
+   memset(aiBins, 0, sizeof(aiBins));
+   for (i = 0; i < iBindingCount; i++)
+   {
+      dBound = 2.0;
+      for (iBin = 0; iBin < BIN_COUNT - 1 && pdTimes[i] >= dBound; iBin++)
+         dBound *= 2.0;
+      aiBins[iBin]++;
+   }
+   qsort(pdTimes, (size_t)iBindingCount, sizeof(*pdTimes), compareDoubles);
+
+   printf("latency n=%-9d resize=%-11s p50=%8.0f ns  p99=%8.0f ns  "
+      "p99.9=%8.0f ns  max=%10.0f ns\n",
+      iBindingCount, iIncremental ? "incremental" : "at-once",
+      pdTimes[iBindingCount / 2], pdTimes[iBindingCount / 100 * 99],
+      pdTimes[iBindingCount / 1000 * 999], pdTimes[iBindingCount - 1]);
+   dBound = 2.0;
+   for (iBin = 0; iBin < BIN_COUNT; iBin++, dBound *= 2.0)
+      if (aiBins[iBin] != 0)
+         printf("        < %12.0f ns %10d\n", dBound, aiBins[iBin]);
+   fflush(stdout);
+
+   free(pdTimes);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Put iBindingCount bindings into a new SymTable object, then time
+   iRounds rounds of SymTable_get() over all keys in a scattered order,
+   first for keys that are present and then for keys that are absent.
+   Write the mean time per lookup to stdout. */
+
+static void benchLookups(int iBindingCount, int iRounds)
+{
+   enum {MAX_KEY_LENGTH = 16};
+   const unsigned STRIDE = 40503u;
+
+   SymTable_T oSymTable;
+   char (*pacKeys)[MAX_KEY_LENGTH];
+   unsigned uIndex;
+   int i;
+   int iRound;
+   int iFound = 0;
+   double dStart;
+   double dHit;
+   double dMiss;
+
+   pacKeys = malloc((size_t)iBindingCount * MAX_KEY_LENGTH);
+   assert(pacKeys != NULL);
+   oSymTable = SymTable_new();
+   assert(oSymTable != NULL);
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(pacKeys[i], "id_%u", (unsigned)i * 2654435761u);
+      SymTable_put(oSymTable, pacKeys[i], pacKeys[i]);
+   }
+
+   dStart = nowNs();
+   for (iRound = 0; iRound < iRounds; iRound++)
+      for (i = 0; i < iBindingCount; i++)
+      {
+         uIndex = ((unsigned)i * STRIDE + (unsigned)iRound)
+            % (unsigned)iBindingCount;
+         iFound += SymTable_get(oSymTable, pacKeys[uIndex]) != NULL;
+      }
+   dHit = nowNs() - dStart;
+
+   /* The same keys with a different first character are all absent. */
+   for (i = 0; i < iBindingCount; i++)
+      pacKeys[i][0] = 'X';
+
+   dStart = nowNs();
+   for (iRound = 0; iRound < iRounds; iRound++)
+      for (i = 0; i < iBindingCount; i++)
+      {
+         uIndex = ((unsigned)i * STRIDE + (unsigned)iRound)
+            % (unsigned)iBindingCount;
+         iFound += SymTable_get(oSymTable, pacKeys[uIndex]) != NULL;
+      }
+   dMiss = nowNs() - dStart;
+
+   assert(iFound == iBindingCount * iRounds);
+   printf("lookup  n=%-9d hit=%8.1f ns  miss=%8.1f ns\n",
+      iBindingCount, dHit / ((double)iBindingCount * iRounds),
+      dMiss / ((double)iBindingCount * iRounds));
+   fflush(stdout);
+
+   SymTable_free(oSymTable);
+   free(pacKeys);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* For each hash function, write to stdout the throughput of
+   SymTable_hashKey() in GB/s for keys of each length in KEY_LENGTHS,
+   and then how iBindingCount keys like those of benchLookups() spread
+   over the table's buckets when reduced modulo its bucket count: the
+   number of buckets holding 0, 1, 2, ... keys, and the longest chain. */
+
+static void benchHashFunctions(int iBindingCount)
+{
+   enum {MAX_KEY_LENGTH = 16, BYTES_PER_LENGTH = 1 << 26, MAX_CHAIN = 5};
+   static const size_t KEY_LENGTHS[] = {8, 16, 64, 1024};
+   enum {KEY_LENGTH_COUNT = sizeof(KEY_LENGTHS) / sizeof(KEY_LENGTHS[0])};
+   static const enum SymTable_HashFunction HASH_FUNCTIONS[] = {
+      SYMTABLE_HASH_LEGACY, SYMTABLE_HASH_WORD, SYMTABLE_HASH_KEYED};
+   static const char *const HASH_NAMES[] = {"legacy", "word", "keyed"};
+   enum {HASH_FUNCTION_COUNT =
+      sizeof(HASH_FUNCTIONS) / sizeof(HASH_FUNCTIONS[0])};
+
+   SymTable_T oSymTable;
+   struct SymTable_Stats sStats;
+   char acBuffer[1024];
+   char acKey[MAX_KEY_LENGTH];
+   unsigned *puCounts;
+   int aiChains[MAX_CHAIN + 1];
+   unsigned uLongest;
+   size_t uSum;
+   size_t u;
+   size_t uHashes;
+   int iFunction;
+   int iLength;
+   int i;
+   double dStart;
+   double dElapsed;
+
+   for (u = 0; u < sizeof(acBuffer); u++)
+      acBuffer[u] = (char)('a' + u * 7 % 26);
+
+   for (iFunction = 0; iFunction < HASH_FUNCTION_COUNT; iFunction++)
+   {
+      oSymTable = SymTable_newWithHash(HASH_FUNCTIONS[iFunction]);
+      assert(oSymTable != NULL);
+
+      printf("hash    %-6s", HASH_NAMES[iFunction]);
+      for (iLength = 0; iLength < KEY_LENGTH_COUNT; iLength++)
+      {
+         uHashes = BYTES_PER_LENGTH / KEY_LENGTHS[iLength];
+         uSum = 0;
+         dStart = nowNs();
+         for (u = 0; u < uHashes; u++)
+         {
+            /* Vary the first byte so no call can be hoisted. */
+            acBuffer[0] = (char)u;
+            uSum += SymTable_hashKey(oSymTable, acBuffer, KEY_LENGTHS[iLength]);
+         }
+         dElapsed = nowNs() - dStart;
+         uSink = uSum;
+         printf("  %4lub=%6.2f GB/s", (unsigned long)KEY_LENGTHS[iLength],
+            (double)(uHashes * KEY_LENGTHS[iLength]) / dElapsed);
+      }
+      printf("\n");
+
+      for (i = 0; i < iBindingCount; i++)
+      {
+         sprintf(acKey, "id_%u", (unsigned)i * 2654435761u);
+         SymTable_put(oSymTable, acKey, NULL);
+      }
+      SymTable_getStats(oSymTable, &sStats);
+      puCounts = calloc(sStats.uBucketCount, sizeof(*puCounts));
+      assert(puCounts != NULL);
+      for (i = 0; i < iBindingCount; i++)
+      {
+         sprintf(acKey, "id_%u", (unsigned)i * 2654435761u);
+         puCounts[SymTable_hashKey(oSymTable, acKey, strlen(acKey))
+            % sStats.uBucketCount]++;
+      }
+
+      memset(aiChains, 0, sizeof(aiChains));
+      uLongest = 0;
+      for (u = 0; u < sStats.uBucketCount; u++)
+      {
+         aiChains[puCounts[u] < MAX_CHAIN ? puCounts[u] : MAX_CHAIN]++;
+         if (puCounts[u] > uLongest)
+            uLongest = puCounts[u];
+      }
+      printf("chains  %-6s n=%-9d buckets=%-9lu", HASH_NAMES[iFunction],
+         iBindingCount, (unsigned long)sStats.uBucketCount);
+      for (i = 0; i <= MAX_CHAIN; i++)
+         printf(" %s%d:%-8d", i == MAX_CHAIN ? ">=" : "", i, aiChains[i]);
+      printf(" longest=%u\n", uLongest);
+      fflush(stdout);
+
+      free(puCounts);
+      SymTable_free(oSymTable);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Put iBindingCount bindings into a new SymTable object, then look up
+   every key in a scattered order, once with a loop over SymTable_get()
+   and once with SymTable_getBatch() for each batch size in
+   BATCH_SIZES.  Write the mean time per lookup to stdout. */
+
+static void benchBatches(int iBindingCount)
+{
+   enum {MAX_KEY_LENGTH = 16};
+   static const int BATCH_SIZES[] = {1, 8, 64, 1024};
+   enum {BATCH_SIZE_COUNT = sizeof(BATCH_SIZES) / sizeof(BATCH_SIZES[0])};
+   const unsigned STRIDE = 40503u;
+
+   SymTable_T oSymTable;
+   char (*pacKeys)[MAX_KEY_LENGTH];
+   const char **ppcOrder;
+   void **ppvValues;
+   int i;
+   int iSize;
+   int iBatch;
+   int iFound = 0;
+   double dStart;
+   double dElapsed;
+
+   pacKeys = malloc((size_t)iBindingCount * MAX_KEY_LENGTH);
+   ppcOrder = malloc((size_t)iBindingCount * sizeof(*ppcOrder));
+   ppvValues = malloc((size_t)iBindingCount * sizeof(*ppvValues));
+   assert(pacKeys != NULL && ppcOrder != NULL && ppvValues != NULL);
+   oSymTable = SymTable_new();
+   assert(oSymTable != NULL);
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(pacKeys[i], "id_%u", (unsigned)i * 2654435761u);
+      SymTable_put(oSymTable, pacKeys[i], pacKeys[i]);
+   }
+   for (i = 0; i < iBindingCount; i++)
+      ppcOrder[i] = pacKeys[((unsigned)i * STRIDE) % (unsigned)iBindingCount];
+
+   dStart = nowNs();
+   for (i = 0; i < iBindingCount; i++)
+      ppvValues[i] = SymTable_get(oSymTable, ppcOrder[i]);
+   dElapsed = nowNs() - dStart;
+   for (i = 0; i < iBindingCount; i++)
+      iFound += ppvValues[i] != NULL;
+   printf("batch   n=%-9d scalar       %8.1f ns\n",
+      iBindingCount, dElapsed / iBindingCount);
+
+   for (iSize = 0; iSize < BATCH_SIZE_COUNT; iSize++)
+   {
+      dStart = nowNs();
+      for (i = 0; i < iBindingCount; i += iBatch)
+      {
+         iBatch = iBindingCount - i < BATCH_SIZES[iSize]
+            ? iBindingCount - i : BATCH_SIZES[iSize];
+         SymTable_getBatch(oSymTable, ppcOrder + i, (size_t)iBatch,
+            ppvValues + i);
+      }
+      dElapsed = nowNs() - dStart;
+      for (i = 0; i < iBindingCount; i++)
+         iFound += ppvValues[i] != NULL;
+      printf("batch   n=%-9d size=%-7d %8.1f ns\n",
+         iBindingCount, BATCH_SIZES[iSize], dElapsed / iBindingCount);
+   }
+   fflush(stdout);
+
+   assert(iFound == iBindingCount * (BATCH_SIZE_COUNT + 1));
+   SymTable_free(oSymTable);
+   free(ppvValues);
+   free(ppcOrder);
+   free(pacKeys);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Count the binding pcKey in the size_t pvExtra. */
+
+static void countBinding(const char *pcKey, void *pvValue, void *pvExtra)
+{
+   (void)pcKey;
+   (void)pvValue;
+   (*(size_t*)pvExtra)++;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Put iBindingCount bindings into a SymTable object, then write to
+   stdout the time SymTable_mapRange() takes to visit all of them in
+   key order, and the average time of SymTable_mapPrefix() queries that
+   each select a handful of them. */
+
+static void benchOrdered(int iBindingCount)
+{
+   enum {MAX_KEY_LENGTH = 16, QUERY_COUNT = 100, PREFIX_LENGTH = 7};
+
+   SymTable_T oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   size_t uCount = 0;
+   int i;
+   double dStart;
+   double dElapsed;
+
+   oSymTable = SymTable_new();
+   assert(oSymTable != NULL);
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "id_%u", (unsigned)i * 2654435761u);
+      SymTable_put(oSymTable, acKey, NULL);
+   }
+
+   dStart = nowNs();
+   SymTable_mapRange(oSymTable, NULL, NULL, countBinding, &uCount);
+   dElapsed = nowNs() - dStart;
+   assert(uCount == (size_t)iBindingCount);
+   printf("ordered n=%-9d sorted scan  %8.1f ns/key\n",
+      iBindingCount, dElapsed / iBindingCount);
+
+   uCount = 0;
+   dStart = nowNs();
+   for (i = 0; i < QUERY_COUNT; i++)
+   {
+      sprintf(acKey, "id_%u", (unsigned)i * 2654435761u);
+      acKey[PREFIX_LENGTH] = '\0';
+      SymTable_mapPrefix(oSymTable, acKey, countBinding, &uCount);
+   }
+   dElapsed = nowNs() - dStart;
+   uSink = uCount;
+   printf("ordered n=%-9d prefix query %8.1f us (%.1f keys)\n",
+      iBindingCount, dElapsed / QUERY_COUNT / 1e3,
+      (double)uCount / QUERY_COUNT);
+   fflush(stdout);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Write to stdout the time per binding that SymTable_map() and an
+   iterator take to visit every binding of a SymTable object holding
+   uCount bindings, after it reserved room for uReserve. */
+
+static void benchIteration(size_t uCount, size_t uReserve)
+{
+   enum {MAX_KEY_LENGTH = 24};
+
+   SymTable_T oSymTable;
+   struct SymTable_Iter sIter;
+   char acKey[MAX_KEY_LENGTH];
+   size_t uVisited = 0;
+   size_t u;
+   void *pvValue;
+   double dStart;
+   double dMap;
+   double dIter;
+
+   oSymTable = SymTable_new();
+   assert(oSymTable != NULL);
+   SymTable_reserve(oSymTable, uReserve);
+   for (u = 0; u < uCount; u++)
+   {
+      sprintf(acKey, "it%lu", (unsigned long)u);
+      SymTable_put(oSymTable, acKey, NULL);
+   }
+
+   dStart = nowNs();
+   SymTable_map(oSymTable, countBinding, &uVisited);
+   dMap = nowNs() - dStart;
+
+   dStart = nowNs();
+   SymTable_iterBegin(oSymTable, &sIter);
+   while (SymTable_iterNext(oSymTable, &sIter, NULL, &pvValue))
+      uVisited++;
+   dIter = nowNs() - dStart;
+   assert(uVisited == 2 * uCount);
+   uSink = uVisited;
+
+   printf("iterate n=%-9lu reserved=%-9lu map %6.1f ns/key  iter %6.1f ns/key\n",
+      (unsigned long)uCount, (unsigned long)uReserve,
+      dMap / (double)uCount, dIter / (double)uCount);
+   fflush(stdout);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Add a checksum of the bytes of pcKey to the size_t pvAccumulator,
+   standing in for the work of serializing a binding. */
+
+static void checksumBinding(const char *pcKey, void *pvValue,
+   void *pvAccumulator, void *pvExtra)
+{
+   size_t uSum = 0;
+
+   (void)pvValue;
+   (void)pvExtra;
+   while (*pcKey != '\0')
+      uSum = uSum * 31 + (unsigned char)*pcKey++;
+   *(size_t*)pvAccumulator += uSum;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Add the size_t pvAccumulator to the size_t pvResult. */
+
+static void mergeChecksums(void *pvResult, const void *pvAccumulator,
+   void *pvExtra)
+{
+   (void)pvExtra;
+   *(size_t*)pvResult += *(const size_t*)pvAccumulator;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Put iBindingCount bindings into a SymTable object, then write to
+   stdout the time SymTable_mapReduce() takes to checksum all of them
+   with 1 to MAX_THREADS threads, and the speedup over one thread. */
+
+static void benchParallel(int iBindingCount)
+{
+   enum {MAX_KEY_LENGTH = 16, MAX_THREADS = 16};
+
+   SymTable_T oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   size_t uThreads;
+   size_t uResult;
+   int i;
+   double dStart;
+   double dElapsed;
+   double dSingle = 0.0;
+
+   oSymTable = SymTable_new();
+   assert(oSymTable != NULL);
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "par%d", i);
+      SymTable_put(oSymTable, acKey, NULL);
+   }
+
+   /* Warm the caches so that the one-thread run is not the only cold
+      one. */
+   uResult = 0;
+   SymTable_mapReduce(oSymTable, checksumBinding, mergeChecksums,
+      sizeof(uResult), &uResult, NULL, 1);
+
+   for (uThreads = 1; uThreads <= MAX_THREADS; uThreads *= 2)
+   {
+      uResult = 0;
+      dStart = nowNs();
+      SymTable_mapReduce(oSymTable, checksumBinding, mergeChecksums,
+         sizeof(uResult), &uResult, NULL, uThreads);
+      dElapsed = nowNs() - dStart;
+      if (uThreads == 1)
+         dSingle = dElapsed;
+      uSink = uResult;
+      printf("parallel n=%-9d threads=%-3lu %8.2f ms  speedup %5.2f\n",
+         iBindingCount, (unsigned long)uThreads, dElapsed / 1e6,
+         dSingle / dElapsed);
+   }
+   fflush(stdout);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Put iBindingCount bindings into a SymTable object, look each of them
+   up and look up as many absent keys, and write to stdout what the
+   instrumentation of an implementation built with SYMTABLE_STATS saw. */
+
+static void benchInstrumentation(int iBindingCount)
+{
+   enum {MAX_KEY_LENGTH = 24};
+
+   SymTable_T oSymTable;
+   struct SymTable_Stats sStats;
+   char acKey[MAX_KEY_LENGTH];
+   int iFound = 0;
+   int i;
+
+   oSymTable = SymTable_new();
+   assert(oSymTable != NULL);
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "stat%d", i);
+      SymTable_put(oSymTable, acKey, NULL);
+   }
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "stat%d", i);
+      iFound += SymTable_contains(oSymTable, acKey);
+      sprintf(acKey, "absent%d", i);
+      iFound += SymTable_contains(oSymTable, acKey);
+   }
+   uSink = (size_t)iFound;
+
+   SymTable_getStats(oSymTable, &sStats);
+   if (sStats.iInstrumented)
+   {
+      printf("stats   n=%-9d lookups %lu hits %lu misses %lu"
+         " probes mean %.2f max %lu\n", iBindingCount,
+         (unsigned long)sStats.uLookups, (unsigned long)sStats.uHits,
+         (unsigned long)sStats.uMisses, sStats.dMeanProbes,
+         (unsigned long)sStats.uMaxProbes);
+      printf("stats   n=%-9d resizes %lu in %.2f ms, %lu bytes\n",
+         iBindingCount, (unsigned long)sStats.uResizeCount,
+         sStats.dResizeNs / 1e6, (unsigned long)sStats.uBytesAllocated);
+      printf("stats   n=%-9d chains", iBindingCount);
+      for (i = 0; i < SYMTABLE_STATS_CHAIN_LENGTHS; i++)
+         printf(" %lu", (unsigned long)sStats.auChainLengths[i]);
+      printf("\n");
+      fflush(stdout);
+   }
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* A Position object follows a SymTable_map() walk in search of pcKey:
+   uIndex counts the bindings visited before it, and iFound is set once
+   it is reached. */
+
+struct Position
+{
+   const char *pcKey;
+   size_t uIndex;
+   int iFound;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Advance the Position pvExtra past pcKey, unless pcKey is the key it
+   searches for or follows it. */
+
+static void findPosition(const char *pcKey, void *pvValue, void *pvExtra)
+{
+   struct Position *psPosition = (struct Position*)pvExtra;
+
+   (void)pvValue;
+   if (psPosition->iFound)
+      return;
+   if (strcmp(pcKey, psPosition->pcKey) == 0)
+      psPosition->iFound = 1;
+   else
+      psPosition->uIndex++;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Fill piTrace with iTraceLength indices below iKeyCount drawn with
+   Zipfian (s = 1) frequencies. The most frequent indices are spread
+   out rather than clustered at 0. */
+
+static void makeZipfTrace(int *piTrace, int iTraceLength, int iKeyCount)
+{
+   double *pdCumulative;
+   double dTotal = 0.0;
+   double dDraw;
+   int iLow;
+   int iHigh;
+   int iMid;
+   int i;
+
+   pdCumulative = malloc((size_t)iKeyCount * sizeof(*pdCumulative));
+   assert(pdCumulative != NULL);
+   for (i = 0; i < iKeyCount; i++)
+   {
+      dTotal += 1.0 / (i + 1);
+      pdCumulative[i] = dTotal;
+   }
+
+   srand(1);
+   for (i = 0; i < iTraceLength; i++)
+   {
+      dDraw = (double)rand() / ((double)RAND_MAX + 1.0) * dTotal;
+      iLow = 0;
+      iHigh = iKeyCount - 1;
+      while (iLow < iHigh)
+      {
+         iMid = (iLow + iHigh) / 2;
+         if (pdCumulative[iMid] <= dDraw)
+            iLow = iMid + 1;
+         else
+            iHigh = iMid;
+      }
+      piTrace[i] = (iLow * 7 + 3) % iKeyCount;
+   }
+   free(pdCumulative);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Run a Zipfian trace of lookups against small SymTable objects in each
+   self-organizing mode the implementation accepts, and write to stdout
+   the time per lookup. For a list, which SymTable_map() walks in search
+   order, also write the key comparisons per lookup. */
+
+static void benchReorder(void)
+{
+   enum {MAX_KEY_LENGTH = 16, TRACE_LENGTH = 200000};
+   static const int SCOPE_SIZES[] = {8, 16, 64};
+   enum {SCOPE_SIZE_COUNT = sizeof(SCOPE_SIZES) / sizeof(SCOPE_SIZES[0])};
+   static const enum SymTable_Reorder REORDERS[] = {
+      SYMTABLE_REORDER_NONE, SYMTABLE_REORDER_MOVE_TO_FRONT,
+      SYMTABLE_REORDER_TRANSPOSE};
+   static const char *const REORDER_NAMES[] = {"none", "mtf", "transpose"};
+   enum {REORDER_COUNT = sizeof(REORDERS) / sizeof(REORDERS[0])};
+
+   SymTable_T oSymTable;
+   char (*pacKeys)[MAX_KEY_LENGTH];
+   const char **ppcTrace;
+   int *piTrace;
+   struct Position sPosition;
+   size_t uCompares;
+   int iListOrder;
+   int iSize;
+   int iCount;
+   int iReorder;
+   int iFound;
+   int i;
+   double dStart;
+   double dElapsed;
+
+   ppcTrace = malloc(TRACE_LENGTH * sizeof(*ppcTrace));
+   piTrace = malloc(TRACE_LENGTH * sizeof(*piTrace));
+   assert(ppcTrace != NULL && piTrace != NULL);
+
+   for (iSize = 0; iSize < SCOPE_SIZE_COUNT; iSize++)
+   {
+      iCount = SCOPE_SIZES[iSize];
+      pacKeys = malloc((size_t)iCount * MAX_KEY_LENGTH);
+      assert(pacKeys != NULL);
+      for (i = 0; i < iCount; i++)
+         sprintf(pacKeys[i], "sym%d", i);
+      makeZipfTrace(piTrace, TRACE_LENGTH, iCount);
+      for (i = 0; i < TRACE_LENGTH; i++)
+         ppcTrace[i] = pacKeys[piTrace[i]];
+
+      for (iReorder = 0; iReorder < REORDER_COUNT; iReorder++)
+      {
+         oSymTable = SymTable_new();
+         assert(oSymTable != NULL);
+         iListOrder = SymTable_setReorder(oSymTable,
+            SYMTABLE_REORDER_MOVE_TO_FRONT);
+         if (! SymTable_setReorder(oSymTable, REORDERS[iReorder]))
+         {
+            SymTable_free(oSymTable);
+            continue;
+         }
+         for (i = 0; i < iCount; i++)
+            SymTable_put(oSymTable, pacKeys[i], pacKeys[i]);
+
+         /* Count comparisons on one copy of the table... */
+         uCompares = 0;
+         if (iListOrder)
+            for (i = 0; i < TRACE_LENGTH; i++)
+            {
+               sPosition.pcKey = ppcTrace[i];
+               sPosition.uIndex = 0;
+               sPosition.iFound = 0;
+               SymTable_map(oSymTable, findPosition, &sPosition);
+               uCompares += sPosition.uIndex + 1;
+               SymTable_get(oSymTable, ppcTrace[i]);
+            }
+         SymTable_free(oSymTable);
+
+         /* ...and time the same lookups on a fresh one. */
+         oSymTable = SymTable_new();
+         assert(oSymTable != NULL);
+         SymTable_setReorder(oSymTable, REORDERS[iReorder]);
+         for (i = 0; i < iCount; i++)
+            SymTable_put(oSymTable, pacKeys[i], pacKeys[i]);
+         iFound = 0;
+         dStart = nowNs();
+         for (i = 0; i < TRACE_LENGTH; i++)
+            iFound += SymTable_get(oSymTable, ppcTrace[i]) != NULL;
+         dElapsed = nowNs() - dStart;
+         assert(iFound == TRACE_LENGTH);
+         SymTable_free(oSymTable);
+
+         if (iListOrder)
+            printf("reorder n=%-9d %-12s %8.1f ns %6.2f compares\n",
+               iCount, REORDER_NAMES[iReorder], dElapsed / TRACE_LENGTH,
+               (double)uCompares / TRACE_LENGTH);
+         else
+            printf("reorder n=%-9d %-12s %8.1f ns\n",
+               iCount, REORDER_NAMES[iReorder], dElapsed / TRACE_LENGTH);
+      }
+      fflush(stdout);
+      free(pacKeys);
+   }
+   free(piTrace);
+   free(ppcTrace);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Create, fill, search and free many small SymTable objects, as a
+   compiler does for nested scopes, and write to stdout the time per
+   scope for several scope sizes. */
+
+static void benchScopes(void)
+{
+   enum {MAX_KEY_LENGTH = 16, SCOPE_COUNT = 100000, MAX_SCOPE_SIZE = 64};
+   static const int SCOPE_SIZES[] = {0, 4, 12, 64};
+   enum {SCOPE_SIZE_COUNT = sizeof(SCOPE_SIZES) / sizeof(SCOPE_SIZES[0])};
+
+   SymTable_T oSymTable;
+   char aacKeys[MAX_SCOPE_SIZE][MAX_KEY_LENGTH];
+   int iSize;
+   int iScope;
+   int iFound = 0;
+   int i;
+   double dStart;
+   double dElapsed;
+
+   for (i = 0; i < MAX_SCOPE_SIZE; i++)
+      sprintf(aacKeys[i], "local%d", i);
+
+   for (iSize = 0; iSize < SCOPE_SIZE_COUNT; iSize++)
+   {
+      dStart = nowNs();
+      for (iScope = 0; iScope < SCOPE_COUNT; iScope++)
+      {
+         oSymTable = SymTable_new();
+         assert(oSymTable != NULL);
+         for (i = 0; i < SCOPE_SIZES[iSize]; i++)
+            SymTable_put(oSymTable, aacKeys[i], aacKeys[i]);
+         for (i = 0; i < SCOPE_SIZES[iSize]; i++)
+            iFound += SymTable_get(oSymTable, aacKeys[i]) != NULL;
+         SymTable_free(oSymTable);
+      }
+      dElapsed = nowNs() - dStart;
+      printf("scopes  size=%-6d %8.1f ns/scope\n",
+         SCOPE_SIZES[iSize], dElapsed / SCOPE_COUNT);
+   }
+   fflush(stdout);
+   uSink = (size_t)iFound;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Run the SymTable benchmarks.  argv[1] is the number of bindings to
+   put into the largest SymTable object.  Exit with EXIT_FAILURE if
+   argv[1] is missing or not numeric.  Otherwise return 0. */
+
+int main(int argc, char *argv[])
+{
+   int iBindingCount;
+   int iCount;
+
+   if (argc != 2)
+   {
+      fprintf(stderr, "Usage: %s bindingcount\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   if ((sscanf(argv[1], "%d", &iBindingCount) != 1)
+       || (iBindingCount <= 0))
+   {
+      fprintf(stderr, "bindingcount must be a positive number\n");
+      exit(EXIT_FAILURE);
+   }
+
+   for (iCount = 1000; iCount < iBindingCount; iCount *= 10)
+      benchInsertSpikes(iCount);
+   benchInsertSpikes(iBindingCount);
+
+   benchInsertLatency(iBindingCount, 0);
+   benchInsertLatency(iBindingCount, 1);
+
+   for (iCount = 1000; iCount < iBindingCount; iCount *= 10)
+      benchLookups(iCount, iBindingCount / iCount);
+   benchLookups(iBindingCount, 1);
+
+   benchBatches(iBindingCount);
+
+   benchHashFunctions(iBindingCount);
+   benchOrdered(iBindingCount);
+   benchIteration((size_t)iBindingCount, 0);
+   benchIteration((size_t)iBindingCount / 100 + 1, (size_t)iBindingCount);
+   benchParallel(iBindingCount);
+   benchInstrumentation(iBindingCount);
+
+   benchReorder();
+   benchScopes();
+
+   return 0;
+}
@@ -0,0 +1,476 @@
+/*--------------------------------------------------------------------*/
+/* benchsymtablereplay.c                                              */
+/* Author: Chinmayi R                                                 */
+/*--------------------------------------------------------------------*/
+
+/* clock_gettime and CLOCK_MONOTONIC are POSIX, not C99. */
+#define _POSIX_C_SOURCE 199309L
+
+#include "symtable.h"
+#include "symtabletrace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+
+/*--------------------------------------------------------------------*/
+
+/* Number of untimed replays that precede the timed ones, and the
+   default number of timed ones. */
+enum {WARMUP_COUNT = 1};
+enum {DEFAULT_REPETITIONS = 5};
+
+/* Number of clock reads over which the cost of one is measured. */
+enum {CLOCK_SAMPLES = 1000};
+
+/*--------------------------------------------------------------------*/
+
+/* Sink for results that are computed only to be timed, so that the
+   compiler cannot drop the computation. */
+static volatile size_t uSink;
+
+/*--------------------------------------------------------------------*/
+
+/* An Op object is one call of a trace, ready to replay:
+   - eOp: the operation.
+   - uTable: the id of the table it applies to.
+   - pcKey: its key, NUL-terminated, or NULL. */
+
+struct Op
+{
+   enum SymTableTrace_Op eOp;
+   size_t uTable;
+   const char *pcKey;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A Trace object holds a whole trace in memory:
+   - psOps: the calls, in order.
+   - uOpCount: the number of calls.
+   - uTableCount: the number of tables the calls create.
+   - pcKeys: the storage of every key of psOps.
+   - auCounts: the number of calls of each SymTableTrace_Op.
+   - dRecordedNs: the time the recorded calls spanned. */
+
+struct Trace
+{
+   struct Op *psOps;
+   size_t uOpCount;
+   size_t uTableCount;
+   char *pcKeys;
+   size_t auCounts[SYMTABLETRACE_OP_COUNT];
+   double dRecordedNs;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Return the current monotonic wall-clock time in nanoseconds. */
+
+static double nowNs(void)
+{
+   struct timespec sTime;
+   clock_gettime(CLOCK_MONOTONIC, &sTime);
+   return (double)sTime.tv_sec * 1e9 + (double)sTime.tv_nsec;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return -1, 0 or 1 as the double that pv1 points to is less than,
+   equal to or greater than the one pv2 points to. */
+
+static int compareDoubles(const void *pv1, const void *pv2)
+{
+   double d1 = *(const double*)pv1;
+   double d2 = *(const double*)pv2;
+   return (d1 > d2) - (d1 < d2);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Write pcMessage about the trace pcPath to stderr and exit with
+   EXIT_FAILURE. */
+
+static void fail(const char *pcPath, const char *pcMessage)
+{
+   fprintf(stderr, "%s: %s\n", pcPath, pcMessage);
+   exit(EXIT_FAILURE);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a buffer holding the whole file pcPath, and store its size in
+   *puSize. Exit with EXIT_FAILURE if it cannot be read. */
+
+static unsigned char *readFile(const char *pcPath, size_t *puSize)
+{
+   FILE *psFile;
+   unsigned char *pucBuffer = NULL;
+   unsigned char *pucGrown;
+   size_t uCapacity = 0;
+   size_t uSize = 0;
+
+   psFile = fopen(pcPath, "rb");
+   if (psFile == NULL)
+      fail(pcPath, "cannot open trace");
+   for (;;)
+   {
+      if (uSize == uCapacity)
+      {
+         uCapacity = uCapacity == 0 ? 65536 : uCapacity * 2;
+         pucGrown = realloc(pucBuffer, uCapacity);
+         if (pucGrown == NULL)
+            fail(pcPath, "trace does not fit in memory");
+         pucBuffer = pucGrown;
+      }
+      uSize += fread(pucBuffer + uSize, 1, uCapacity - uSize, psFile);
+      if (uSize < uCapacity)
+         break;
+   }
+   if (ferror(psFile))
+      fail(pcPath, "cannot read trace");
+   fclose(psFile);
+   *puSize = uSize;
+   return pucBuffer;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Load the trace pcPath into *psTrace. Check that each call applies to
+   a table that exists at that point, so that the replay cannot fail.
+   Keep the calls before a truncated or corrupt record, as a process
+   that crashed while recording leaves, and warn on stderr. Exit with
+   EXIT_FAILURE if the trace cannot be read or is inconsistent. */
+
+static void loadTrace(const char *pcPath, struct Trace *psTrace)
+{
+   struct SymTableTrace_Record sRecord;
+   unsigned char *pucBuffer;
+   char *pcLive;
+   char *pcKey;
+   size_t uSize;
+   size_t uOffset;
+   size_t uUsed;
+   size_t uRecords = 0;
+   size_t uKeyBytes = 0;
+   size_t uEnd;
+   size_t u;
+
+   pucBuffer = readFile(pcPath, &uSize);
+   if (uSize < SYMTABLETRACE_MAGIC_LENGTH
+       || memcmp(pucBuffer, SYMTABLETRACE_MAGIC, SYMTABLETRACE_MAGIC_LENGTH) != 0)
+      fail(pcPath, "not a SymTable trace");
+
+   /* Count the records and the bytes of their keys... */
+   for (uOffset = SYMTABLETRACE_MAGIC_LENGTH; uOffset < uSize; uOffset += uUsed)
+   {
+      uUsed = SymTableTrace_decode(pucBuffer + uOffset, uSize - uOffset, &sRecord);
+      if (uUsed == 0)
+      {
+         fprintf(stderr, "%s: trace is truncated or corrupt after %lu records\n",
+            pcPath, (unsigned long)uRecords);
+         break;
+      }
+      uRecords++;
+      if (sRecord.key != NULL)
+         uKeyBytes += sRecord.keyLength + 1;
+   }
+   uEnd = uOffset;
+
+   /* ...and then copy them out, checking the table of each. */
+   psTrace->psOps = malloc((uRecords + 1) * sizeof(struct Op));
+   psTrace->pcKeys = malloc(uKeyBytes + 1);
+   pcLive = calloc(uRecords + 1, 1);
+   if (psTrace->psOps == NULL || psTrace->pcKeys == NULL || pcLive == NULL)
+      fail(pcPath, "trace does not fit in memory");
+   memset(psTrace->auCounts, 0, sizeof(psTrace->auCounts));
+   psTrace->uOpCount = uRecords;
+   psTrace->uTableCount = 0;
+   psTrace->dRecordedNs = 0.0;
+   pcKey = psTrace->pcKeys;
+
+   uOffset = SYMTABLETRACE_MAGIC_LENGTH;
+   for (u = 0; u < uRecords; u++)
+   {
+      uUsed = SymTableTrace_decode(pucBuffer + uOffset, uEnd - uOffset, &sRecord);
+      assert(uUsed != 0);
+      uOffset += uUsed;
+
+      if (sRecord.op == SYMTABLETRACE_NEW)
+      {
+         /* Each table's id is the number of tables created before it. */
+         if (sRecord.table != psTrace->uTableCount)
+            fail(pcPath, "trace creates tables out of order");
+         pcLive[psTrace->uTableCount++] = 1;
+      }
+      else if (sRecord.table >= psTrace->uTableCount || !pcLive[sRecord.table])
+         fail(pcPath, "trace uses a table that does not exist");
+      else if (sRecord.op == SYMTABLETRACE_FREE)
+         pcLive[sRecord.table] = 0;
+
+      psTrace->psOps[u].eOp = sRecord.op;
+      psTrace->psOps[u].uTable = sRecord.table;
+      psTrace->psOps[u].pcKey = NULL;
+      if (sRecord.key != NULL)
+      {
+         memcpy(pcKey, sRecord.key, sRecord.keyLength);
+         pcKey[sRecord.keyLength] = '\0';
+         psTrace->psOps[u].pcKey = pcKey;
+         pcKey += sRecord.keyLength + 1;
+      }
+      psTrace->auCounts[sRecord.op]++;
+      psTrace->dRecordedNs += (double)sRecord.delta;
+   }
+
+   free(pcLive);
+   free(pucBuffer);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Count the binding pcKey in the size_t that pvExtra points to. */
+
+static void countBinding(const char *pcKey, void *pvValue, void *pvExtra)
+{
+   (void)pcKey;
+   (void)pvValue;
+   (*(size_t*)pvExtra)++;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Apply *psOp to the tables of aoTables, with each key bound to
+   itself. Return a value that depends on its result. A getorput call
+   is replayed with the core interface, which every implementation
+   has. */
+
+static size_t applyOp(const struct Op *psOp, SymTable_T *aoTables)
+{
+   SymTable_T oSymTable = aoTables[psOp->uTable];
+   size_t uCount = 0;
+
+   switch (psOp->eOp)
+   {
+      case SYMTABLETRACE_NEW:
+         aoTables[psOp->uTable] = SymTable_new();
+         assert(aoTables[psOp->uTable] != NULL);
+         return 0;
+      case SYMTABLETRACE_FREE:
+         SymTable_free(oSymTable);
+         aoTables[psOp->uTable] = NULL;
+         return 0;
+      case SYMTABLETRACE_LENGTH:
+         return SymTable_getLength(oSymTable);
+      case SYMTABLETRACE_PUT:
+         return (size_t)SymTable_put(oSymTable, psOp->pcKey, psOp->pcKey);
+      case SYMTABLETRACE_REPLACE:
+         return SymTable_replace(oSymTable, psOp->pcKey, psOp->pcKey) != NULL;
+      case SYMTABLETRACE_CONTAINS:
+         return (size_t)SymTable_contains(oSymTable, psOp->pcKey);
+      case SYMTABLETRACE_GET:
+         return SymTable_get(oSymTable, psOp->pcKey) != NULL;
+      case SYMTABLETRACE_REMOVE:
+         return SymTable_remove(oSymTable, psOp->pcKey) != NULL;
+      case SYMTABLETRACE_MAP:
+         SymTable_map(oSymTable, countBinding, &uCount);
+         return uCount;
+      case SYMTABLETRACE_GET_OR_PUT:
+         if (SymTable_contains(oSymTable, psOp->pcKey))
+            return 1;
+         return (size_t)SymTable_put(oSymTable, psOp->pcKey, psOp->pcKey);
+      default:
+         assert(0);
+         return 0;
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Free the tables of aoTables that *psTrace leaves unfreed. */
+
+static void freeTables(const struct Trace *psTrace, SymTable_T *aoTables)
+{
+   size_t u;
+
+   for (u = 0; u < psTrace->uTableCount; u++)
+   {
+      if (aoTables[u] != NULL)
+         SymTable_free(aoTables[u]);
+      aoTables[u] = NULL;
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Replay *psTrace at full speed with the tables of aoTables, which are
+   all NULL, and return the time it took in nanoseconds. If pdLatencies
+   is not NULL, also time each call into it. Free the tables the trace
+   leaves unfreed afterwards, untimed. */
+
+static double replay(const struct Trace *psTrace, SymTable_T *aoTables,
+   double *pdLatencies)
+{
+   size_t uResult = 0;
+   size_t u;
+   double dStart;
+   double dBefore;
+   double dElapsed;
+
+   dStart = nowNs();
+   if (pdLatencies == NULL)
+      for (u = 0; u < psTrace->uOpCount; u++)
+         uResult += applyOp(&psTrace->psOps[u], aoTables);
+   else
+      for (u = 0; u < psTrace->uOpCount; u++)
+      {
+         dBefore = nowNs();
+         uResult += applyOp(&psTrace->psOps[u], aoTables);
+         pdLatencies[u] = nowNs() - dBefore;
+      }
+   dElapsed = nowNs() - dStart;
+
+   uSink = uResult;
+   freeTables(psTrace, aoTables);
+   return dElapsed;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the median time of a clock read, in nanoseconds, which each
+   latency that replay measures includes. */
+
+static double clockOverhead(void)
+{
+   double adSamples[CLOCK_SAMPLES];
+   double dBefore;
+   int i;
+
+   for (i = 0; i < CLOCK_SAMPLES; i++)
+   {
+      dBefore = nowNs();
+      adSamples[i] = nowNs() - dBefore;
+   }
+   qsort(adSamples, CLOCK_SAMPLES, sizeof(double), compareDoubles);
+   return adSamples[CLOCK_SAMPLES / 2];
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Write to stdout a line of the latency distribution of the uCount
+   calls named pcName whose times are in pdTimes, which is sorted. */
+
+static void printLatencies(const char *pcName, const double *pdTimes,
+   size_t uCount)
+{
+   if (uCount == 0)
+      return;
+   printf("latency %-9s n=%-9lu p50=%8.1f p90=%8.1f p99=%8.1f "
+      "p99.9=%9.1f max=%10.1f ns\n", pcName, (unsigned long)uCount,
+      pdTimes[(size_t)(0.5 * (double)uCount)],
+      pdTimes[(size_t)(0.9 * (double)uCount)],
+      pdTimes[(size_t)(0.99 * (double)uCount)],
+      pdTimes[(size_t)(0.999 * (double)uCount)],
+      pdTimes[uCount - 1]);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Replay the SymTable trace argv[1], which a program built with
+   SYMTABLE_TRACE recorded, against the implementation this program is
+   linked with, once untimed and then argv[2] times, or 5 if it is
+   absent. Write to stdout what the trace holds, the time and
+   throughput of the replays, and the latency distribution of each
+   kind of call, which one further replay measures. Exit with
+   EXIT_FAILURE if the arguments are malformed or the trace cannot be
+   read. Otherwise return 0. */
+
+int main(int argc, char *argv[])
+{
+   struct Trace sTrace;
+   SymTable_T *aoTables;
+   double *pdLatencies;
+   double *pdTimes;
+   double *pdSorted;
+   int iRepetitions = DEFAULT_REPETITIONS;
+   int iRun;
+   size_t uCount;
+   size_t u;
+   int iOp;
+
+   if (argc != 2 && argc != 3)
+   {
+      fprintf(stderr, "Usage: %s tracefile [repetitions]\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   if ((argc == 3)
+       && ((sscanf(argv[2], "%d", &iRepetitions) != 1)
+           || (iRepetitions <= 0)))
+   {
+      fprintf(stderr, "repetitions must be a positive number\n");
+      exit(EXIT_FAILURE);
+   }
+
+   loadTrace(argv[1], &sTrace);
+   aoTables = calloc(sTrace.uTableCount + 1, sizeof(SymTable_T));
+   pdTimes = malloc((size_t)iRepetitions * sizeof(double));
+   pdLatencies = malloc((sTrace.uOpCount + 1) * sizeof(double));
+   pdSorted = malloc((sTrace.uOpCount + 1) * sizeof(double));
+   if (aoTables == NULL || pdTimes == NULL || pdLatencies == NULL
+       || pdSorted == NULL)
+   {
+      fprintf(stderr, "%s: trace does not fit in memory\n", argv[1]);
+      exit(EXIT_FAILURE);
+   }
+
+   printf("trace   %s: %lu calls on %lu tables over %.3f ms\n", argv[1],
+      (unsigned long)sTrace.uOpCount, (unsigned long)sTrace.uTableCount,
+      sTrace.dRecordedNs / 1e6);
+   printf("trace  ");
+   for (iOp = 0; iOp < SYMTABLETRACE_OP_COUNT; iOp++)
+      printf(" %s %lu", SymTableTrace_opName((enum SymTableTrace_Op)iOp),
+         (unsigned long)sTrace.auCounts[iOp]);
+   printf("\n");
+   fflush(stdout);
+
+   for (iRun = -WARMUP_COUNT; iRun < iRepetitions; iRun++)
+   {
+      if (iRun < 0)
+         replay(&sTrace, aoTables, NULL);
+      else
+         pdTimes[iRun] = replay(&sTrace, aoTables, NULL);
+   }
+   qsort(pdTimes, (size_t)iRepetitions, sizeof(double), compareDoubles);
+   printf("replay  repetitions=%d min=%.3f ms median=%.3f ms "
+      "%.2f Mcalls/s %.1f ns/call\n", iRepetitions, pdTimes[0] / 1e6,
+      pdTimes[iRepetitions / 2] / 1e6,
+      sTrace.uOpCount == 0 ? 0.0 : (double)sTrace.uOpCount / pdTimes[0] * 1e3,
+      sTrace.uOpCount == 0 ? 0.0 : pdTimes[0] / (double)sTrace.uOpCount);
+   fflush(stdout);
+
+   replay(&sTrace, aoTables, pdLatencies);
+   for (iOp = 0; iOp < SYMTABLETRACE_OP_COUNT; iOp++)
+   {
+      uCount = 0;
+      for (u = 0; u < sTrace.uOpCount; u++)
+         if (sTrace.psOps[u].eOp == (enum SymTableTrace_Op)iOp)
+            pdSorted[uCount++] = pdLatencies[u];
+      qsort(pdSorted, uCount, sizeof(double), compareDoubles);
+      printLatencies(SymTableTrace_opName((enum SymTableTrace_Op)iOp),
+         pdSorted, uCount);
+   }
+   memcpy(pdSorted, pdLatencies, sTrace.uOpCount * sizeof(double));
+   qsort(pdSorted, sTrace.uOpCount, sizeof(double), compareDoubles);
+   printLatencies("all", pdSorted, sTrace.uOpCount);
+   printf("latency includes %.1f ns per call of clock overhead\n",
+      clockOverhead());
+
+   free(pdSorted);
+   free(pdLatencies);
+   free(pdTimes);
+   free(aoTables);
+   free(sTrace.psOps);
+   free(sTrace.pcKeys);
+   return 0;
+}
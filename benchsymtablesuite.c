@@ -0,0 +1,737 @@
+/*--------------------------------------------------------------------*/
+/* benchsymtablesuite.c                                               */
+/* Author: Chinmayi R                                                 */
+/*--------------------------------------------------------------------*/
+
+/* clock_gettime, CLOCK_MONOTONIC and fork are POSIX, not C99. */
+#define _POSIX_C_SOURCE 199309L
+
+#include "symtable.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+/*--------------------------------------------------------------------*/
+
+/* Length of the buffers that hold short generated keys. */
+enum {MAX_KEY_LENGTH = 24};
+
+/* Length of the long keys, which share all but their last few
+   characters. */
+enum {LONG_KEY_LENGTH = 128};
+
+/* Number of consecutive operations timed together. The percentiles
+   are of the mean time per operation of each block, so that the cost
+   of reading the clock does not swamp a lookup that takes a few
+   nanoseconds, while a resize still shows up as a slow block. */
+enum {BLOCK_SIZE = 16};
+
+/* Number of bindings in each scope of the scopes workload. */
+enum {SCOPE_SIZE = 8};
+
+/* Number of untimed repetitions of each workload that precede the
+   timed ones, and the default number of timed ones. */
+enum {WARMUP_COUNT = 1};
+enum {DEFAULT_REPETITIONS = 5};
+
+/* One in this many lookups of the misses workload finds its key. */
+enum {HIT_PERIOD = 10};
+
+/*--------------------------------------------------------------------*/
+
+/* Sink for results that are computed only to be timed, so that the
+   compiler cannot drop the computation. */
+static volatile size_t uSink;
+
+/*--------------------------------------------------------------------*/
+
+/* A Keys object holds every key and access trace the workloads use,
+   generated once before any of them runs:
+   - iCount: the number of bindings in each table.
+   - ppcKeys: iCount keys, in insertion order.
+   - ppcSequential: iCount consecutive integers, as testLargeTable
+     generates them.
+   - ppcLong: iCount keys of nearly LONG_KEY_LENGTH characters.
+   - ppcAbsent: iCount keys that are never put into a table.
+   - piUniform: iCount indices drawn uniformly below iCount.
+   - piZipf: iCount indices drawn with Zipfian frequencies. */
+
+struct Keys
+{
+   int iCount;
+   char **ppcKeys;
+   char **ppcSequential;
+   char **ppcLong;
+   char **ppcAbsent;
+   int *piUniform;
+   int *piZipf;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A Timer object times one repetition of a workload in blocks of
+   BLOCK_SIZE operations:
+   - pdBlocks: the mean time per operation of each block, in ns.
+   - uBlockCount: the number of blocks in pdBlocks.
+   - uOps: the number of operations so far.
+   - uMaxOps: the number of operations pdBlocks has room for.
+   - dBlockStart: the time at which the current block began.
+   - dStart: the time at which the repetition began.
+   - dElapsed: the length of the repetition, in ns, once it ends. */
+
+struct Timer
+{
+   double *pdBlocks;
+   size_t uBlockCount;
+   size_t uOps;
+   size_t uMaxOps;
+   double dBlockStart;
+   double dStart;
+   double dElapsed;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A Workload object names a benchmark and the function that performs
+   one repetition of it with the keys of *psKeys under *psTimer.
+   uOpsPerBinding is an upper bound on the operations it performs per
+   binding. */
+
+struct Workload
+{
+   const char *pcName;
+   void (*pfRun)(const struct Keys *psKeys, struct Timer *psTimer);
+   size_t uOpsPerBinding;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Return the current monotonic wall-clock time in nanoseconds. */
+
+static double nowNs(void)
+{
+   struct timespec sTime;
+   clock_gettime(CLOCK_MONOTONIC, &sTime);
+   return (double)sTime.tv_sec * 1e9 + (double)sTime.tv_nsec;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return -1, 0 or 1 as the double that pv1 points to is less than,
+   equal to or greater than the one pv2 points to. */
+
+static int compareDoubles(const void *pv1, const void *pv2)
+{
+   double d1 = *(const double*)pv1;
+   double d2 = *(const double*)pv2;
+   return (d1 > d2) - (d1 < d2);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the peak resident set size of the process so far, in
+   kilobytes, or 0 if it is unknown. Each workload runs in a process of
+   its own, so this is the peak of that workload. */
+
+static long peakRssKb(void)
+{
+   struct rusage sUsage;
+
+   if (getrusage(RUSAGE_SELF, &sUsage) != 0)
+      return 0;
+   return (long)sUsage.ru_maxrss;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Begin a repetition of a workload on *psTimer. */
+
+static void startTimer(struct Timer *psTimer)
+{
+   psTimer->uBlockCount = 0;
+   psTimer->uOps = 0;
+   psTimer->dStart = nowNs();
+   psTimer->dBlockStart = psTimer->dStart;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Count an operation of the repetition that *psTimer times, ending the
+   current block if it is full. */
+
+static void tickTimer(struct Timer *psTimer)
+{
+   double dNow;
+
+   assert(psTimer->uOps < psTimer->uMaxOps);
+   if (++psTimer->uOps % BLOCK_SIZE != 0)
+      return;
+   dNow = nowNs();
+   psTimer->pdBlocks[psTimer->uBlockCount++] =
+      (dNow - psTimer->dBlockStart) / BLOCK_SIZE;
+   psTimer->dBlockStart = dNow;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* End the repetition that *psTimer times, keeping the partial last
+   block if there is one. */
+
+static void stopTimer(struct Timer *psTimer)
+{
+   double dNow = nowNs();
+   size_t uRemainder = psTimer->uOps % BLOCK_SIZE;
+
+   if (uRemainder != 0)
+      psTimer->pdBlocks[psTimer->uBlockCount++] =
+         (dNow - psTimer->dBlockStart) / (double)uRemainder;
+   psTimer->dElapsed = dNow - psTimer->dStart;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new SymTable object that binds each of the first iCount
+   keys of ppcKeys to itself. */
+
+static SymTable_T newFilledTable(char **ppcKeys, int iCount)
+{
+   SymTable_T oSymTable;
+   int i;
+
+   oSymTable = SymTable_new();
+   assert(oSymTable != NULL);
+   for (i = 0; i < iCount; i++)
+      SymTable_put(oSymTable, ppcKeys[i], ppcKeys[i]);
+   return oSymTable;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Look up the keys of ppcKeys that piTrace names in a table of all of
+   them, timing each lookup with *psTimer. */
+
+static void runLookups(char **ppcKeys, const int *piTrace, int iCount,
+   struct Timer *psTimer)
+{
+   SymTable_T oSymTable;
+   size_t uFound = 0;
+   int i;
+
+   oSymTable = newFilledTable(ppcKeys, iCount);
+   startTimer(psTimer);
+   for (i = 0; i < iCount; i++)
+   {
+      uFound += SymTable_get(oSymTable, ppcKeys[piTrace[i]]) != NULL;
+      tickTimer(psTimer);
+   }
+   stopTimer(psTimer);
+   assert(uFound == (size_t)iCount);
+   uSink = uFound;
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Look up keys drawn uniformly from a table. */
+
+static void runUniform(const struct Keys *psKeys, struct Timer *psTimer)
+{
+   runLookups(psKeys->ppcKeys, psKeys->piUniform, psKeys->iCount, psTimer);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Look up keys drawn with Zipfian frequencies from a table, as a
+   compiler looks up a few hot identifiers most of the time. */
+
+static void runZipf(const struct Keys *psKeys, struct Timer *psTimer)
+{
+   runLookups(psKeys->ppcKeys, psKeys->piZipf, psKeys->iCount, psTimer);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Look up long keys that differ only at their ends, drawn uniformly
+   from a table. */
+
+static void runLongKeys(const struct Keys *psKeys, struct Timer *psTimer)
+{
+   runLookups(psKeys->ppcLong, psKeys->piUniform, psKeys->iCount, psTimer);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Put consecutive integer keys into a new table and then get each of
+   them in the same order, as testLargeTable does. Both the puts,
+   with the resizes they cause, and the gets are timed. */
+
+static void runSequential(const struct Keys *psKeys, struct Timer *psTimer)
+{
+   SymTable_T oSymTable;
+   size_t uFound = 0;
+   int i;
+
+   oSymTable = SymTable_new();
+   assert(oSymTable != NULL);
+   startTimer(psTimer);
+   for (i = 0; i < psKeys->iCount; i++)
+   {
+      SymTable_put(oSymTable, psKeys->ppcSequential[i], NULL);
+      tickTimer(psTimer);
+   }
+   for (i = 0; i < psKeys->iCount; i++)
+   {
+      uFound += SymTable_contains(oSymTable, psKeys->ppcSequential[i]);
+      tickTimer(psTimer);
+   }
+   stopTimer(psTimer);
+   assert(uFound == (size_t)psKeys->iCount);
+   uSink = uFound;
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Look up keys in a table, most of which it does not contain: one
+   lookup in HIT_PERIOD finds its key. */
+
+static void runMisses(const struct Keys *psKeys, struct Timer *psTimer)
+{
+   SymTable_T oSymTable;
+   size_t uFound = 0;
+   int i;
+
+   oSymTable = newFilledTable(psKeys->ppcKeys, psKeys->iCount);
+   startTimer(psTimer);
+   for (i = 0; i < psKeys->iCount; i++)
+   {
+      if (i % HIT_PERIOD == 0)
+         uFound += SymTable_contains(oSymTable,
+            psKeys->ppcKeys[psKeys->piUniform[i]]);
+      else
+         uFound += SymTable_contains(oSymTable, psKeys->ppcAbsent[i]);
+      tickTimer(psTimer);
+   }
+   stopTimer(psTimer);
+   assert(uFound == (size_t)(psKeys->iCount + HIT_PERIOD - 1) / HIT_PERIOD);
+   uSink = uFound;
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Slide a window of half the keys across all of them: fill a table
+   with the first half, and then repeatedly remove its oldest binding
+   and put the next key. Each remove and each put is an operation. */
+
+static void runChurn(const struct Keys *psKeys, struct Timer *psTimer)
+{
+   SymTable_T oSymTable;
+   int iWindow = psKeys->iCount / 2;
+   size_t uRemoved = 0;
+   int i;
+
+   oSymTable = newFilledTable(psKeys->ppcKeys, iWindow);
+   startTimer(psTimer);
+   for (i = 0; i + iWindow < psKeys->iCount; i++)
+   {
+      uRemoved += SymTable_remove(oSymTable, psKeys->ppcKeys[i]) != NULL;
+      tickTimer(psTimer);
+      SymTable_put(oSymTable, psKeys->ppcKeys[i + iWindow],
+         psKeys->ppcKeys[i + iWindow]);
+      tickTimer(psTimer);
+   }
+   stopTimer(psTimer);
+   assert(uRemoved == (size_t)i);
+   assert(SymTable_getLength(oSymTable) == (size_t)iWindow);
+   uSink = uRemoved;
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Create a table, put SCOPE_SIZE bindings into it, look each of them
+   up and free it, as a compiler does for a block scope. Each scope is
+   an operation. */
+
+static void runScopes(const struct Keys *psKeys, struct Timer *psTimer)
+{
+   SymTable_T oSymTable;
+   int iScopeCount = psKeys->iCount / SCOPE_SIZE;
+   size_t uFound = 0;
+   int iScope;
+   int i;
+
+   startTimer(psTimer);
+   for (iScope = 0; iScope < iScopeCount; iScope++)
+   {
+      oSymTable = SymTable_new();
+      assert(oSymTable != NULL);
+      for (i = 0; i < SCOPE_SIZE; i++)
+         SymTable_put(oSymTable, psKeys->ppcKeys[i], NULL);
+      for (i = 0; i < SCOPE_SIZE; i++)
+         uFound += SymTable_contains(oSymTable, psKeys->ppcKeys[i]);
+      SymTable_free(oSymTable);
+      tickTimer(psTimer);
+   }
+   stopTimer(psTimer);
+   assert(uFound == (size_t)iScopeCount * SCOPE_SIZE);
+   uSink = uFound;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The workloads, in the order in which they run. */
+
+static const struct Workload WORKLOADS[] = {
+   {"uniform", runUniform, 1},
+   {"zipf", runZipf, 1},
+   {"sequential", runSequential, 2},
+   {"longkey", runLongKeys, 1},
+   {"misses", runMisses, 1},
+   {"churn", runChurn, 2},
+   {"scopes", runScopes, 1}
+};
+enum {WORKLOAD_COUNT = sizeof(WORKLOADS) / sizeof(WORKLOADS[0])};
+
+/*--------------------------------------------------------------------*/
+
+/* Fill piTrace with iTraceLength indices below iKeyCount drawn with
+   Zipfian (s = 1) frequencies. The most frequent indices are spread
+   out rather than clustered at 0. */
+
+static void makeZipfTrace(int *piTrace, int iTraceLength, int iKeyCount)
+{
+   double *pdCumulative;
+   double dTotal = 0.0;
+   double dDraw;
+   int iLow;
+   int iHigh;
+   int iMid;
+   int i;
+
+   pdCumulative = malloc((size_t)iKeyCount * sizeof(*pdCumulative));
+   assert(pdCumulative != NULL);
+   for (i = 0; i < iKeyCount; i++)
+   {
+      dTotal += 1.0 / (i + 1);
+      pdCumulative[i] = dTotal;
+   }
+
+   for (i = 0; i < iTraceLength; i++)
+   {
+      dDraw = (double)rand() / ((double)RAND_MAX + 1.0) * dTotal;
+      iLow = 0;
+      iHigh = iKeyCount - 1;
+      while (iLow < iHigh)
+      {
+         iMid = (iLow + iHigh) / 2;
+         if (pdCumulative[iMid] <= dDraw)
+            iLow = iMid + 1;
+         else
+            iHigh = iMid;
+      }
+      piTrace[i] = (int)(((long)iLow * 7 + 3) % iKeyCount);
+   }
+   free(pdCumulative);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new array of iCount keys, each of which is the format
+   pcFormat applied to pcPrefix and its index, and no longer than
+   iMaxLength - 1 characters. */
+
+static char **makeKeys(int iCount, const char *pcFormat,
+   const char *pcPrefix, int iMaxLength)
+{
+   char **ppcKeys;
+   char *pcBuffer;
+   int i;
+
+   ppcKeys = malloc((size_t)iCount * sizeof(*ppcKeys));
+   pcBuffer = malloc((size_t)iCount * (size_t)iMaxLength);
+   assert(ppcKeys != NULL && pcBuffer != NULL);
+   for (i = 0; i < iCount; i++)
+   {
+      ppcKeys[i] = pcBuffer + (size_t)i * (size_t)iMaxLength;
+      sprintf(ppcKeys[i], pcFormat, pcPrefix, i);
+   }
+   return ppcKeys;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Free an array of keys that makeKeys returned. */
+
+static void freeKeys(char **ppcKeys)
+{
+   free(ppcKeys[0]);
+   free(ppcKeys);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Fill *psKeys with keys and traces for tables of iCount bindings.
+   The traces are the same on every run. */
+
+static void makeAllKeys(struct Keys *psKeys, int iCount)
+{
+   char acPrefix[LONG_KEY_LENGTH];
+   int i;
+
+   /* Leave room for the 10 digits of the largest int. */
+   memset(acPrefix, 'x', LONG_KEY_LENGTH - 12);
+   acPrefix[LONG_KEY_LENGTH - 12] = '\0';
+
+   psKeys->iCount = iCount;
+   psKeys->ppcKeys = makeKeys(iCount, "%ssym%d", "", MAX_KEY_LENGTH);
+   psKeys->ppcSequential = makeKeys(iCount, "%s%d", "", MAX_KEY_LENGTH);
+   psKeys->ppcAbsent = makeKeys(iCount, "%sabsent%d", "", MAX_KEY_LENGTH);
+   psKeys->ppcLong = makeKeys(iCount, "%s%010d", acPrefix, LONG_KEY_LENGTH);
+
+   psKeys->piUniform = malloc((size_t)iCount * sizeof(int));
+   psKeys->piZipf = malloc((size_t)iCount * sizeof(int));
+   assert(psKeys->piUniform != NULL && psKeys->piZipf != NULL);
+   srand(1);
+   for (i = 0; i < iCount; i++)
+      psKeys->piUniform[i] = (int)((double)rand()
+         / ((double)RAND_MAX + 1.0) * iCount);
+   makeZipfTrace(psKeys->piZipf, iCount, iCount);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Free the keys and traces of *psKeys. */
+
+static void freeAllKeys(struct Keys *psKeys)
+{
+   freeKeys(psKeys->ppcKeys);
+   freeKeys(psKeys->ppcSequential);
+   freeKeys(psKeys->ppcAbsent);
+   freeKeys(psKeys->ppcLong);
+   free(psKeys->piUniform);
+   free(psKeys->piZipf);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the value below which a fraction dFraction of the uCount
+   sorted values of pdSorted fall. */
+
+static double percentile(const double *pdSorted, size_t uCount,
+   double dFraction)
+{
+   size_t uIndex = (size_t)(dFraction * (double)uCount);
+
+   assert(uCount > 0);
+   if (uIndex >= uCount)
+      uIndex = uCount - 1;
+   return pdSorted[uIndex];
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Run *psWorkload WARMUP_COUNT times untimed and iRepetitions times
+   timed with the keys of *psKeys, and write one record of the results
+   to stdout, as a JSON object if iJson or as a CSV row otherwise.
+   pcBackend names the implementation. */
+
+static void runWorkload(const struct Workload *psWorkload,
+   const struct Keys *psKeys, int iRepetitions, const char *pcBackend,
+   int iJson)
+{
+   struct Timer sTimer;
+   double *pdBlocks;
+   double *pdNsPerOp;
+   size_t uBlocksPerRun;
+   size_t uBlockCount = 0;
+   size_t uOps = 0;
+   int iRun;
+
+   sTimer.uMaxOps = psWorkload->uOpsPerBinding * (size_t)psKeys->iCount;
+   uBlocksPerRun = sTimer.uMaxOps / BLOCK_SIZE + 1;
+   pdBlocks = malloc((size_t)iRepetitions * uBlocksPerRun * sizeof(double));
+   pdNsPerOp = malloc((size_t)iRepetitions * sizeof(double));
+   assert(pdBlocks != NULL && pdNsPerOp != NULL);
+
+   for (iRun = -WARMUP_COUNT; iRun < iRepetitions; iRun++)
+   {
+      sTimer.pdBlocks = pdBlocks + (iRun < 0 ? 0 : uBlockCount);
+      psWorkload->pfRun(psKeys, &sTimer);
+      if (iRun < 0)
+         continue;
+      uOps = sTimer.uOps;
+      uBlockCount += sTimer.uBlockCount;
+      pdNsPerOp[iRun] = uOps == 0 ? 0.0 : sTimer.dElapsed / (double)uOps;
+   }
+
+   qsort(pdNsPerOp, (size_t)iRepetitions, sizeof(double), compareDoubles);
+   if (uBlockCount == 0)
+      pdBlocks[uBlockCount++] = 0.0;
+   qsort(pdBlocks, uBlockCount, sizeof(double), compareDoubles);
+
+   if (iJson)
+      printf("{\"backend\": \"%s\", \"workload\": \"%s\", "
+         "\"bindings\": %d, \"ops\": %lu, \"repetitions\": %d, "
+         "\"ns_per_op_min\": %.2f, \"ns_per_op_median\": %.2f, "
+         "\"p50_ns\": %.2f, \"p90_ns\": %.2f, \"p99_ns\": %.2f, "
+         "\"p999_ns\": %.2f, \"max_ns\": %.2f, \"peak_rss_kb\": %ld}\n",
+         pcBackend, psWorkload->pcName, psKeys->iCount,
+         (unsigned long)uOps, iRepetitions, pdNsPerOp[0],
+         pdNsPerOp[iRepetitions / 2],
+         percentile(pdBlocks, uBlockCount, 0.5),
+         percentile(pdBlocks, uBlockCount, 0.9),
+         percentile(pdBlocks, uBlockCount, 0.99),
+         percentile(pdBlocks, uBlockCount, 0.999),
+         pdBlocks[uBlockCount - 1], peakRssKb());
+   else
+      printf("%s,%s,%d,%lu,%d,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%ld\n",
+         pcBackend, psWorkload->pcName, psKeys->iCount,
+         (unsigned long)uOps, iRepetitions, pdNsPerOp[0],
+         pdNsPerOp[iRepetitions / 2],
+         percentile(pdBlocks, uBlockCount, 0.5),
+         percentile(pdBlocks, uBlockCount, 0.9),
+         percentile(pdBlocks, uBlockCount, 0.99),
+         percentile(pdBlocks, uBlockCount, 0.999),
+         pdBlocks[uBlockCount - 1], peakRssKb());
+   fflush(stdout);
+
+   free(pdNsPerOp);
+   free(pdBlocks);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Run runWorkload with the same arguments in a child process, so that
+   the peak RSS it reports is that of *psWorkload alone and not the
+   high-water mark of every workload before it. Exit with EXIT_FAILURE
+   if the child cannot be started or does not succeed. */
+
+static void runWorkloadInChild(const struct Workload *psWorkload,
+   const struct Keys *psKeys, int iRepetitions, const char *pcBackend,
+   int iJson)
+{
+   pid_t iPid;
+   int iStatus;
+
+   /* Otherwise the child would write buffered output a second time. */
+   fflush(stdout);
+
+   iPid = fork();
+   if (iPid < 0)
+   {
+      perror("fork");
+      exit(EXIT_FAILURE);
+   }
+   if (iPid == 0)
+   {
+      runWorkload(psWorkload, psKeys, iRepetitions, pcBackend, iJson);
+      exit(EXIT_SUCCESS);
+   }
+
+   if (waitpid(iPid, &iStatus, 0) != iPid
+       || ! WIFEXITED(iStatus) || WEXITSTATUS(iStatus) != EXIT_SUCCESS)
+   {
+      fprintf(stderr, "workload %s failed\n", psWorkload->pcName);
+      exit(EXIT_FAILURE);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the name of the implementation that the program pcProgram
+   was linked with: its base name without the leading "benchsymtable"
+   and the trailing "suite". */
+
+static const char *backendName(const char *pcProgram)
+{
+   static char acName[64];
+   const char *pcBase = strrchr(pcProgram, '/');
+   size_t uLength;
+
+   pcBase = pcBase == NULL ? pcProgram : pcBase + 1;
+   if (strncmp(pcBase, "benchsymtable", strlen("benchsymtable")) == 0)
+      pcBase += strlen("benchsymtable");
+   uLength = strlen(pcBase);
+   if (uLength > strlen("suite")
+       && strcmp(pcBase + uLength - strlen("suite"), "suite") == 0)
+      uLength -= strlen("suite");
+   if (uLength >= sizeof(acName))
+      uLength = sizeof(acName) - 1;
+   memcpy(acName, pcBase, uLength);
+   acName[uLength] = '\0';
+   return acName;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Run each workload of the SymTable benchmark suite and write one
+   record of its results to stdout: a CSV row after a header row, or a
+   JSON object per line if the first argument is -json. The next
+   argument is the number of bindings in each table, and the optional
+   last one the number of timed repetitions. Each workload runs in a
+   child process, so the peak RSS of a record covers the shared keys
+   and that workload's own tables only. Exit with EXIT_FAILURE if the arguments are malformed.
+   Otherwise return 0. */
+
+int main(int argc, char *argv[])
+{
+   struct Keys sKeys;
+   const char *pcBackend;
+   int iJson = 0;
+   int iBindingCount;
+   int iRepetitions = DEFAULT_REPETITIONS;
+   int iArg = 1;
+   int i;
+
+   pcBackend = backendName(argv[0]);
+
+   if (iArg < argc && strcmp(argv[iArg], "-json") == 0)
+   {
+      iJson = 1;
+      iArg++;
+   }
+
+   if (argc - iArg < 1 || argc - iArg > 2)
+   {
+      fprintf(stderr, "Usage: %s [-json] bindingcount [repetitions]\n",
+         argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   if ((sscanf(argv[iArg], "%d", &iBindingCount) != 1)
+       || (iBindingCount < SCOPE_SIZE))
+   {
+      fprintf(stderr, "bindingcount must be a number of at least %d\n",
+         SCOPE_SIZE);
+      exit(EXIT_FAILURE);
+   }
+
+   if ((argc - iArg == 2)
+       && ((sscanf(argv[iArg + 1], "%d", &iRepetitions) != 1)
+           || (iRepetitions <= 0)))
+   {
+      fprintf(stderr, "repetitions must be a positive number\n");
+      exit(EXIT_FAILURE);
+   }
+
+   makeAllKeys(&sKeys, iBindingCount);
+
+   if (! iJson)
+      printf("backend,workload,bindings,ops,repetitions,ns_per_op_min,"
+         "ns_per_op_median,p50_ns,p90_ns,p99_ns,p999_ns,max_ns,"
+         "peak_rss_kb\n");
+   for (i = 0; i < WORKLOAD_COUNT; i++)
+      runWorkloadInChild(&WORKLOADS[i], &sKeys, iRepetitions, pcBackend,
+         iJson);
+
+   freeAllKeys(&sKeys);
+   return 0;
+}
@@ -0,0 +1,209 @@
+/*--------------------------------------------------------------------*/
+/* benchsymtablethreads.c                                             */
+/* Author: Chinmayi R                                                 */
+/*--------------------------------------------------------------------*/
+
+/* clock_gettime and CLOCK_MONOTONIC are POSIX, not C99. */
+#define _POSIX_C_SOURCE 199309L
+
+#include "symtable.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+#include <pthread.h>
+
+/*--------------------------------------------------------------------*/
+
+/* Largest number of reader threads measured. */
+enum {MAX_THREADS = 32};
+
+/* Length of the buffers that hold generated keys. */
+enum {MAX_KEY_LENGTH = 16};
+
+/* Number of put/remove pairs the writer thread performs, and the pause
+   between them, which makes updates rare compared with lookups. */
+enum {UPDATE_COUNT = 2000};
+enum {UPDATE_PAUSE_NS = 20000};
+
+/*--------------------------------------------------------------------*/
+
+/* A Reader object is the argument of one reader thread:
+   - oSymTable: the table to read.
+   - pacKeys: the iBindingCount keys bound in oSymTable.
+   - iBindingCount: the number of keys, and of lookups to perform.
+   - iOffset: where in the scattered key order the thread starts.
+   - iFound: the number of lookups that found their key. */
+
+struct Reader
+{
+   SymTable_T oSymTable;
+   char (*pacKeys)[MAX_KEY_LENGTH];
+   int iBindingCount;
+   int iOffset;
+   int iFound;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Return the current monotonic wall-clock time in nanoseconds. */
+
+static double nowNs(void)
+{
+   struct timespec sTime;
+   clock_gettime(CLOCK_MONOTONIC, &sTime);
+   return (double)sTime.tv_sec * 1e9 + (double)sTime.tv_nsec;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Look up every key of the Reader pvReader once, in a scattered
+   order. */
+
+static void *runReader(void *pvReader)
+{
+   const unsigned STRIDE = 40503u;
+   struct Reader *psReader = (struct Reader*)pvReader;
+   unsigned uIndex;
+   int i;
+
+   for (i = 0; i < psReader->iBindingCount; i++)
+   {
+      uIndex = ((unsigned)i * STRIDE + (unsigned)psReader->iOffset)
+         % (unsigned)psReader->iBindingCount;
+      psReader->iFound += SymTable_get(psReader->oSymTable,
+         psReader->pacKeys[uIndex]) != NULL;
+   }
+   return NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Put and remove UPDATE_COUNT fresh keys in the table pvSymTable,
+   pausing between updates. */
+
+static void *runWriter(void *pvSymTable)
+{
+   SymTable_T oSymTable = (SymTable_T)pvSymTable;
+   struct timespec sPause;
+   char acKey[MAX_KEY_LENGTH];
+   int i;
+
+   sPause.tv_sec = 0;
+   sPause.tv_nsec = UPDATE_PAUSE_NS;
+   for (i = 0; i < UPDATE_COUNT; i++)
+   {
+      sprintf(acKey, "w%d", i);
+      SymTable_put(oSymTable, acKey, acKey);
+      SymTable_remove(oSymTable, acKey);
+      nanosleep(&sPause, NULL);
+   }
+   return NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Start iThreadCount reader threads that each look up all iBindingCount
+   keys of oSymTable, with a writer thread updating the table alongside
+   them if iWithWriter.  Write the total lookups per second to
+   stdout. */
+
+static void benchReaders(SymTable_T oSymTable,
+   char (*pacKeys)[MAX_KEY_LENGTH], int iBindingCount, int iThreadCount,
+   int iWithWriter)
+{
+   struct Reader asReaders[MAX_THREADS];
+   pthread_t aThreads[MAX_THREADS];
+   pthread_t writer;
+   int i;
+   int iFound = 0;
+   int iError;
+   double dStart;
+   double dElapsed;
+
+   if (iWithWriter)
+   {
+      iError = pthread_create(&writer, NULL, runWriter, oSymTable);
+      assert(iError == 0);
+   }
+
+   dStart = nowNs();
+   for (i = 0; i < iThreadCount; i++)
+   {
+      asReaders[i].oSymTable = oSymTable;
+      asReaders[i].pacKeys = pacKeys;
+      asReaders[i].iBindingCount = iBindingCount;
+      asReaders[i].iOffset = i * (iBindingCount / iThreadCount);
+      asReaders[i].iFound = 0;
+      iError = pthread_create(&aThreads[i], NULL, runReader, &asReaders[i]);
+      assert(iError == 0);
+   }
+   for (i = 0; i < iThreadCount; i++)
+   {
+      pthread_join(aThreads[i], NULL);
+      iFound += asReaders[i].iFound;
+   }
+   dElapsed = nowNs() - dStart;
+
+   if (iWithWriter)
+      pthread_join(writer, NULL);
+
+   assert(iFound == iBindingCount * iThreadCount);
+   printf("readers n=%-9d threads=%-3d writer=%-3s %12.0f lookups/s\n",
+      iBindingCount, iThreadCount, iWithWriter ? "yes" : "no",
+      (double)iBindingCount * iThreadCount / (dElapsed / 1e9));
+   fflush(stdout);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Measure the lookup throughput of a thread-safe SymTable
+   implementation for 1, 2, 4, ... MAX_THREADS reader threads, without
+   and then with a concurrent writer.  argv[1] is the number of
+   bindings in the table and of lookups per thread.  Exit with
+   EXIT_FAILURE if argv[1] is missing or not numeric.  Otherwise
+   return 0. */
+
+int main(int argc, char *argv[])
+{
+   SymTable_T oSymTable;
+   char (*pacKeys)[MAX_KEY_LENGTH];
+   int iBindingCount;
+   int iThreadCount;
+   int iWithWriter;
+   int i;
+
+   if (argc != 2)
+   {
+      fprintf(stderr, "Usage: %s bindingcount\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   if ((sscanf(argv[1], "%d", &iBindingCount) != 1)
+       || (iBindingCount <= 0))
+   {
+      fprintf(stderr, "bindingcount must be a positive number\n");
+      exit(EXIT_FAILURE);
+   }
+
+   pacKeys = malloc((size_t)iBindingCount * MAX_KEY_LENGTH);
+   assert(pacKeys != NULL);
+   oSymTable = SymTable_new();
+   assert(oSymTable != NULL);
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(pacKeys[i], "id_%u", (unsigned)i * 2654435761u);
+      SymTable_put(oSymTable, pacKeys[i], pacKeys[i]);
+   }
+
+   for (iWithWriter = 0; iWithWriter <= 1; iWithWriter++)
+      for (iThreadCount = 1; iThreadCount <= MAX_THREADS;
+           iThreadCount *= 2)
+         benchReaders(oSymTable, pacKeys, iBindingCount, iThreadCount,
+            iWithWriter);
+
+   SymTable_free(oSymTable);
+   free(pacKeys);
+   return 0;
+}
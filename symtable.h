@@ -18,6 +18,87 @@
 typedef struct SymTable *SymTable_T;
 struct SymTable;
 
+/* Number of entries in the chain-length histogram of SymTable_Stats. */
+enum {SYMTABLE_STATS_CHAIN_LENGTHS = 16};
+
+/* A SymTable_Stats object reports the state of a symbol table's
+   growth policy, as filled in by SymTable_getStats. An implementation
+   that never resizes reports one bucket and a maximum load factor of 0.
+   The members after dMaxLoadFactor are only kept by an implementation
+   compiled with SYMTABLE_STATS defined; otherwise they are all 0. */
+struct SymTable_Stats {
+   /* Number of key-value bindings */
+   size_t uLength;
+   /* Number of buckets currently allocated */
+   size_t uBucketCount;
+   /* Length at which the next put grows the table */
+   size_t uGrowAt;
+   /* Length below which the next remove shrinks the table, or 0 */
+   size_t uShrinkAt;
+   /* Number of times the table has grown or shrunk */
+   size_t uResizeCount;
+   /* Current bindings per bucket */
+   double dLoadFactor;
+   /* Bindings per bucket allowed before growing */
+   double dMaxLoadFactor;
+   /* 1 if the table was compiled with SYMTABLE_STATS, or 0 */
+   int iInstrumented;
+   /* Number of key searches made by gets, puts and removes */
+   size_t uLookups;
+   /* Number of those searches that found the key */
+   size_t uHits;
+   /* Number of those searches that did not */
+   size_t uMisses;
+   /* Mean number of probes per search: chain links, probe groups, list
+      nodes or tree nodes visited */
+   double dMeanProbes;
+   /* Largest number of probes of any search */
+   size_t uMaxProbes;
+   /* auChainLengths[i] is the number of chains of i bindings, the last
+      entry counting all longer chains too. A chaining table has one chain
+      per bucket and a list is a single chain; an open-addressing table
+      counts each binding at the number of groups it lies past its first
+      probe; a tree has no chains. */
+   size_t auChainLengths[SYMTABLE_STATS_CHAIN_LENGTHS];
+   /* Time spent resizing, in nanoseconds */
+   double dResizeNs;
+   /* Bytes of heap memory the table holds */
+   size_t uBytesAllocated;
+};
+
+/* The string hash functions a symbol table can be created with. */
+enum SymTable_HashFunction {
+   /* Multiply-by-65599, one byte at a time; the default */
+   SYMTABLE_HASH_LEGACY,
+   /* wyhash-style, eight bytes at a time; fastest on long keys */
+   SYMTABLE_HASH_WORD,
+   /* SipHash-2-4 with a random key per process, for untrusted keys */
+   SYMTABLE_HASH_KEYED
+};
+
+/* The ways a symbol table can reorder its bindings after a successful
+   lookup, so that frequently used keys are found sooner. */
+enum SymTable_Reorder {
+   /* Never reorder; the default */
+   SYMTABLE_REORDER_NONE,
+   /* Move the binding found to the front */
+   SYMTABLE_REORDER_MOVE_TO_FRONT,
+   /* Swap the binding found with the one before it */
+   SYMTABLE_REORDER_TRANSPOSE
+};
+
+/* A SymTable_Iter object is a position in a traversal of a symbol
+   table, filled in by SymTable_iterBegin and advanced by
+   SymTable_iterNext. It needs no allocation and can be kept between
+   calls for as long as the traversal takes. Its members belong to the
+   implementation. */
+struct SymTable_Iter {
+   /* Next binding, node or leaf to visit, or NULL */
+   const void *pvNext;
+   /* Bucket, slot or key index of the next binding to visit */
+   size_t uIndex;
+};
+
 /* Create a new symbol table and return a pointer to it. 
    The table is initially empty and uses the first entry of BUCKET_COUNT 
    as its bucket count. */
@@ -54,6 +135,176 @@ struct SymTable;
    /* Apply the function pfApply to each binding in the symbol table oSymTable,
       passing pcKey, pvValue, and pvExtra as arguments. */
    void SymTable_map(SymTable_T oSymTable, void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra), const void *pvExtra);
+
+   /* Like SymTable_new, but the table hashes keys with eHashFunction.
+      Values from SymTable_hashKey are only meaningful for tables of the
+      same implementation created with the same hash function.
+      Implementations that do not hash ignore eHashFunction. */
+   SymTable_T SymTable_newWithHash(enum SymTable_HashFunction eHashFunction);
+
+   /* Set the maximum load factor of oSymTable to dMaxLoadFactor, so that the
+      table grows once its length reaches dMaxLoadFactor times its bucket count.
+      Returns 1 on success, or 0 if dMaxLoadFactor is not positive or the
+      implementation does not resize. */
+   int SymTable_setMaxLoadFactor(SymTable_T oSymTable, double dMaxLoadFactor);
+
+   /* Make oSymTable spread each resize over the operations that follow it
+      if iEnabled is nonzero, so that no single put pays for relinking every
+      binding, or resize all at once otherwise. Returns 1 on success, or 0
+      if the implementation does not resize incrementally. */
+   int SymTable_setIncrementalResize(SymTable_T oSymTable, int iEnabled);
+
+   /* Make every lookup of oSymTable that finds its key (SymTable_get,
+      SymTable_contains, SymTable_replace and their variants) reorder the
+      bindings as eReorder says. While a table reorders, pfApply must not
+      look up keys of the table being mapped. Returns 1 on success, or 0
+      if the implementation keeps its own order and eReorder is not
+      SYMTABLE_REORDER_NONE. */
+   int SymTable_setReorder(SymTable_T oSymTable, enum SymTable_Reorder eReorder);
+
+   /* Grow oSymTable if needed so that it holds uCount bindings without
+      resizing again. Returns 1 on success, or 0 if memory is exhausted. */
+   int SymTable_reserve(SymTable_T oSymTable, size_t uCount);
+
+   /* Shrink oSymTable to the smallest size that holds its current
+      bindings within its maximum load factor. A table also shrinks by
+      itself once removals leave it a quarter as full as it may be. */
+   void SymTable_shrinkToFit(SymTable_T oSymTable);
+
+   /* Fill *psStats with the current state of the growth policy of oSymTable. */
+   void SymTable_getStats(SymTable_T oSymTable, struct SymTable_Stats *psStats);
+
+   /* Return the canonical copy of pcKey from the process-wide intern pool,
+      adding one if needed, or NULL if memory is exhausted. Equal strings
+      always yield the same pointer, which stays valid until
+      SymTable_internFree. The pool is not thread-safe. */
+   const char *SymTable_intern(const char *pcKey);
+
+   /* Free every string in the intern pool. No symbol table may still hold
+      a binding put with SymTable_putInterned. */
+   void SymTable_internFree(void);
+
+   /* Like SymTable_put, but pcInterned must have come from SymTable_intern.
+      The table shares the pool's copy of the key instead of making its own. */
+   int SymTable_putInterned(SymTable_T oSymTable, const char *pcInterned, const void *pvValue);
+
+   /* Like SymTable_get, but pcInterned must have come from SymTable_intern.
+      The key is not rehashed, and a binding put with the same pointer is
+      matched without comparing characters. */
+   void *SymTable_getInterned(SymTable_T oSymTable, const char *pcInterned);
+
+   /* Return the hash oSymTable uses for the uLength characters at pcKey,
+      which need not be NUL-terminated. The value may be passed to
+      SymTable_putHashed and SymTable_getHashed on any table of the same
+      implementation created with the same hash function, for example
+      every scope of a nested symbol table. A hash from any other table
+      makes SymTable_getHashed miss and SymTable_putHashed add a second
+      binding for the key. */
+   size_t SymTable_hashKey(SymTable_T oSymTable, const char *pcKey, size_t uLength);
+
+   /* Like SymTable_put and SymTable_get, but the key is the uLength
+      characters at pcKey, which need not be NUL-terminated and must not
+      contain '\0'. SymTable_putN stores a NUL-terminated copy. */
+   int SymTable_putN(SymTable_T oSymTable, const char *pcKey, size_t uLength, const void *pvValue);
+   void *SymTable_getN(SymTable_T oSymTable, const char *pcKey, size_t uLength);
+
+   /* Like SymTable_putN and SymTable_getN, but uHash must be the value
+      SymTable_hashKey returns for the key, so the key is not rehashed. */
+   int SymTable_putHashed(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+                          size_t uHash, const void *pvValue);
+   void *SymTable_getHashed(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+                            size_t uHash);
+
+   /* Find the binding for pcKey in oSymTable, inserting one with value
+      pvValue if there is none, in a single lookup. Return a pointer to the
+      binding's value, through which the value can be read or updated in
+      place, or NULL if memory is exhausted. The pointer is valid until the
+      next call that adds or removes a binding of oSymTable. If piCreated
+      is not NULL, set *piCreated to 1 if the binding was inserted and to 0
+      if it already existed. */
+   const void **SymTable_getOrPut(SymTable_T oSymTable, const char *pcKey,
+                                  const void *pvValue, int *piCreated);
+
+   /* Batch forms of SymTable_get, SymTable_put and SymTable_remove for the
+      uCount keys at ppcKeys, with the same results as calling the single-key
+      function on each key in order. The hash tables hash a group of keys
+      and prefetch where each lives before resolving any of them.
+      SymTable_getBatch stores each key's value, or NULL, in ppvValues.
+      SymTable_putBatch binds each key to the matching entry of ppvValues,
+      stores each put's result in piResults unless it is NULL, and returns
+      the number of bindings inserted. SymTable_removeBatch stores each
+      removed value, or NULL, in ppvValues unless it is NULL, and returns
+      the number of bindings removed. */
+   void SymTable_getBatch(SymTable_T oSymTable, const char *const *ppcKeys,
+                          size_t uCount, void **ppvValues);
+   size_t SymTable_putBatch(SymTable_T oSymTable, const char *const *ppcKeys,
+                            const void *const *ppvValues, size_t uCount, int *piResults);
+   size_t SymTable_removeBatch(SymTable_T oSymTable, const char *const *ppcKeys,
+                               size_t uCount, void **ppvValues);
+
+   /* Apply pfApply to each binding of oSymTable whose key is at least
+      pcLow and less than pcHigh, in increasing strcmp order, passing its
+      key, its value and pvExtra. A NULL bound leaves that end of the range
+      open, so SymTable_mapRange(oSymTable, NULL, NULL, ...) visits every
+      binding in order. The ordered implementation takes O(log n + k) time
+      for k bindings visited; the others collect and sort the matching
+      bindings. Returns 1 on success, or 0 if memory is exhausted, in which
+      case pfApply is not called. */
+   int SymTable_mapRange(SymTable_T oSymTable, const char *pcLow, const char *pcHigh,
+                         void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+                         const void *pvExtra);
+
+   /* Like SymTable_mapRange, but visit the bindings whose keys start with
+      pcPrefix. */
+   int SymTable_mapPrefix(SymTable_T oSymTable, const char *pcPrefix,
+                          void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+                          const void *pvExtra);
+
+   /* Like SymTable_map, but stop as soon as pfApply returns nonzero.
+      Returns the nonzero value pfApply returned, or 0 if it returned 0
+      for every binding. */
+   int SymTable_mapUntil(SymTable_T oSymTable,
+                         int (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+                         const void *pvExtra);
+
+   /* Start a traversal of oSymTable in *psIter, which visits the bindings
+      in the same order as SymTable_map. No binding may be put or removed
+      until the traversal ends, and a table that reorders itself must not
+      be searched. */
+   void SymTable_iterBegin(SymTable_T oSymTable, struct SymTable_Iter *psIter);
+
+   /* Store the key and value of the next binding of the traversal
+      *psIter of oSymTable in *ppcKey and *ppvValue, either of which may
+      be NULL, and return 1, or return 0 if every binding was visited. */
+   int SymTable_iterNext(SymTable_T oSymTable, struct SymTable_Iter *psIter,
+                         const char **ppcKey, void **ppvValue);
+
+   /* Apply pfApply to each binding of oSymTable, passing its key, its
+      value and pvExtra, from up to uThreadCount threads: the calling
+      thread and workers it starts and joins before returning. Threads
+      that run out of work take slices of the table from the others, so
+      uneven chains do not leave them idle. The calls come in no
+      particular order and may overlap, so pfApply must be safe to call
+      concurrently. The table must not change until the traversal
+      returns. Tables too small to be worth sharing, and tables for which
+      no threads can be started, are traversed by the calling thread. */
+   void SymTable_mapParallel(SymTable_T oSymTable,
+                             void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+                             const void *pvExtra, size_t uThreadCount);
+
+   /* Like SymTable_mapParallel, but give each thread an accumulator of
+      uAccumulatorSize bytes, starting as a copy of *pvResult, and pass it
+      to pfApply as pvAccumulator. When every binding has been visited,
+      merge each accumulator into *pvResult with pfMerge, one at a time
+      from the calling thread. *pvResult must therefore start as an
+      identity of pfMerge, such as 0 for a sum. */
+   void SymTable_mapReduce(SymTable_T oSymTable,
+                           void (*pfApply)(const char *pcKey, void *pvValue,
+                                           void *pvAccumulator, void *pvExtra),
+                           void (*pfMerge)(void *pvResult, const void *pvAccumulator,
+                                           void *pvExtra),
+                           size_t uAccumulatorSize, void *pvResult, const void *pvExtra,
+                           size_t uThreadCount);
    
 
 #endif
\ No newline at end of file
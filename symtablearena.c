@@ -0,0 +1,237 @@
+/*--------------------------------------------------------------------*/
+/* symtablearena.c                                                    */
+/* Author: Chinmayi R                                                 */
+/*--------------------------------------------------------------------*/
+#include "symtablearena.h"
+#include <stdlib.h>
+#include <assert.h>
+
+/* A type whose size is the strictest alignment any block may need. */
+typedef union {
+    void *pv;
+    size_t u;
+    long l;
+    double d;
+} Align_T;
+
+/* Alignment of every block and of each chunk's data area */
+enum {ALIGNMENT = sizeof(Align_T)};
+
+/* Size of the first chunk of an arena. Kept small so that a table with
+   a handful of bindings does not pay for a large chunk. */
+enum {FIRST_CHUNK_SIZE = 512};
+
+/* Chunk sizes double from FIRST_CHUNK_SIZE up to this size. */
+enum {MAX_CHUNK_SIZE = 64 * 1024};
+
+/* Byte strings are rounded up to a multiple of this size, which is also
+   the step between size classes. */
+enum {BYTE_CLASS_SIZE = 16};
+
+/* Largest byte string that belongs to a size class */
+enum {MAX_CLASS_BYTES = BYTE_CLASS_SIZE * SYMTABLEARENA_BYTE_CLASSES};
+
+/* A SymTableArenaChunk is the header of one malloc'd chunk. Its data
+   area starts at the next multiple of ALIGNMENT after the header. */
+struct SymTableArenaChunk {
+    /* Previously allocated chunk */
+    struct SymTableArenaChunk *next;
+};
+
+/* A SymTableArenaLarge is the header of one malloc'd byte string too
+   large for a size class. The string starts at the next multiple of
+   ALIGNMENT after the header. */
+struct SymTableArenaLarge {
+    /* Previous and next large string of the arena */
+    struct SymTableArenaLarge *prev;
+    struct SymTableArenaLarge *next;
+};
+
+/* Return u rounded up to a multiple of ALIGNMENT. */
+static size_t SymTableArena_align(size_t u)
+{
+    return (u + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+/* Make psArena's current chunk one with at least uSize free bytes,
+   allocating a new chunk. Return 1 on success, or 0 if memory is
+   exhausted. Bytes left in the old chunk are abandoned. */
+static int SymTableArena_grow(struct SymTableArena *psArena, size_t uSize)
+{
+    struct SymTableArenaChunk *psChunk;
+    size_t header = SymTableArena_align(sizeof(struct SymTableArenaChunk));
+    size_t data = psArena->chunkSize;
+
+    assert(psArena != NULL);
+
+    if (data < uSize) {data = uSize;}
+    if (data > (size_t)-1 - header) {return 0;}
+    psChunk = (struct SymTableArenaChunk *) malloc(header + data);
+    if (psChunk == NULL) {return 0;}
+
+    psChunk->next = psArena->chunks;
+    psArena->chunks = psChunk;
+    psArena->top = (char *)psChunk + header;
+    psArena->left = data;
+    psArena->bytesReserved += header + data;
+    if (psArena->chunkSize < MAX_CHUNK_SIZE) {psArena->chunkSize *= 2;}
+    return 1;
+}
+
+/* Return uSize bytes, aligned to ALIGNMENT, from the current chunk of
+   psArena, or from a new chunk if it has too few. Return NULL if memory
+   is exhausted. */
+static void *SymTableArena_bump(struct SymTableArena *psArena, size_t uSize)
+{
+    void *pvBytes;
+    size_t pad;
+
+    assert(psArena != NULL);
+
+    pad = (ALIGNMENT - (size_t)psArena->top % ALIGNMENT) % ALIGNMENT;
+    if (psArena->top == NULL || psArena->left < pad + uSize)
+    {
+        if (!SymTableArena_grow(psArena, uSize)) {return NULL;}
+        pad = 0;
+    }
+    pvBytes = psArena->top + pad;
+    psArena->top += pad + uSize;
+    psArena->left -= pad + uSize;
+    return pvBytes;
+}
+
+/* Initialize *psArena to hand out blocks of uBlockSize bytes. No memory
+   is allocated until the first request. */
+void SymTableArena_init(struct SymTableArena *psArena, size_t uBlockSize)
+{
+    size_t i;
+
+    assert(psArena != NULL);
+    assert(uBlockSize > 0);
+
+    psArena->chunks = NULL;
+    psArena->top = NULL;
+    psArena->left = 0;
+    psArena->freeBlocks = NULL;
+    for (i = 0; i < SYMTABLEARENA_BYTE_CLASSES; i++)
+        psArena->freeBytes[i] = NULL;
+    psArena->large = NULL;
+    psArena->blockSize = SymTableArena_align(uBlockSize);
+    psArena->chunkSize = FIRST_CHUNK_SIZE;
+    psArena->bytesReserved = 0;
+}
+
+/* Return a block of psArena's block size, reusing a freed block if one
+   is available. Return NULL if memory is exhausted. */
+void *SymTableArena_allocBlock(struct SymTableArena *psArena)
+{
+    void *pvBlock;
+
+    assert(psArena != NULL);
+
+    if (psArena->freeBlocks != NULL)
+    {
+        pvBlock = psArena->freeBlocks;
+        psArena->freeBlocks = *(void **)pvBlock;
+        return pvBlock;
+    }
+    return SymTableArena_bump(psArena, psArena->blockSize);
+}
+
+/* Return the block pvBlock, obtained from SymTableArena_allocBlock on
+   psArena, to psArena's free list. */
+void SymTableArena_freeBlock(struct SymTableArena *psArena, void *pvBlock)
+{
+    assert(psArena != NULL);
+    assert(pvBlock != NULL);
+
+    *(void **)pvBlock = psArena->freeBlocks;
+    psArena->freeBlocks = pvBlock;
+}
+
+/* Return uSize bytes from psArena, reusing freed bytes of the same
+   size class if there are any. Return NULL if memory is exhausted. */
+char *SymTableArena_allocBytes(struct SymTableArena *psArena, size_t uSize)
+{
+    struct SymTableArenaLarge *psLarge;
+    size_t header = SymTableArena_align(sizeof(struct SymTableArenaLarge));
+    size_t uClass;
+    char *pcBytes;
+
+    assert(psArena != NULL);
+
+    if (uSize > MAX_CLASS_BYTES)
+    {
+        if (uSize > (size_t)-1 - header) {return NULL;}
+        psLarge = (struct SymTableArenaLarge *) malloc(header + uSize);
+        if (psLarge == NULL) {return NULL;}
+        psLarge->prev = NULL;
+        psLarge->next = psArena->large;
+        if (psArena->large != NULL) {psArena->large->prev = psLarge;}
+        psArena->large = psLarge;
+        psArena->bytesReserved += header + uSize;
+        return (char *)psLarge + header;
+    }
+
+    uClass = uSize == 0 ? 0 : (uSize - 1) / BYTE_CLASS_SIZE;
+    pcBytes = (char *) psArena->freeBytes[uClass];
+    if (pcBytes != NULL)
+    {
+        psArena->freeBytes[uClass] = *(void **)pcBytes;
+        return pcBytes;
+    }
+    return (char *) SymTableArena_bump(psArena, (uClass + 1) * BYTE_CLASS_SIZE);
+}
+
+/* Return the uSize bytes at pcBytes, obtained from
+   SymTableArena_allocBytes on psArena with the same uSize, to psArena
+   for reuse. A large string goes back to malloc at once; any other is
+   kept on the free list of its size class. */
+void SymTableArena_freeBytes(struct SymTableArena *psArena, char *pcBytes, size_t uSize)
+{
+    struct SymTableArenaLarge *psLarge;
+    size_t header = SymTableArena_align(sizeof(struct SymTableArenaLarge));
+    size_t uClass;
+
+    assert(psArena != NULL);
+    assert(pcBytes != NULL);
+
+    if (uSize > MAX_CLASS_BYTES)
+    {
+        psLarge = (struct SymTableArenaLarge *)(pcBytes - header);
+        if (psLarge->prev != NULL) {psLarge->prev->next = psLarge->next;}
+        else {psArena->large = psLarge->next;}
+        if (psLarge->next != NULL) {psLarge->next->prev = psLarge->prev;}
+        psArena->bytesReserved -= header + uSize;
+        free(psLarge);
+        return;
+    }
+
+    uClass = uSize == 0 ? 0 : (uSize - 1) / BYTE_CLASS_SIZE;
+    *(void **)pcBytes = psArena->freeBytes[uClass];
+    psArena->freeBytes[uClass] = pcBytes;
+}
+
+/* Release every chunk of psArena, invalidating all blocks and bytes
+   handed out, and leave psArena empty but usable. */
+void SymTableArena_free(struct SymTableArena *psArena)
+{
+    struct SymTableArenaChunk *psChunk;
+    struct SymTableArenaChunk *next;
+    struct SymTableArenaLarge *psLarge;
+    struct SymTableArenaLarge *nextLarge;
+
+    assert(psArena != NULL);
+
+    for (psChunk = psArena->chunks; psChunk != NULL; psChunk = next)
+    {
+        next = psChunk->next;
+        free(psChunk);
+    }
+    for (psLarge = psArena->large; psLarge != NULL; psLarge = nextLarge)
+    {
+        nextLarge = psLarge->next;
+        free(psLarge);
+    }
+    SymTableArena_init(psArena, psArena->blockSize);
+}
@@ -0,0 +1,66 @@
+/*--------------------------------------------------------------------*/
+/* symtablearena.h                                                    */
+/* Author: Chinmayi R                                                 */
+/*--------------------------------------------------------------------*/
+#include <stddef.h>
+
+#ifndef SYMTABLEARENA_INCLUDED
+#define SYMTABLEARENA_INCLUDED
+
+/* Number of size classes of the byte strings a SymTableArena recycles */
+enum {SYMTABLEARENA_BYTE_CLASSES = 16};
+
+/* A SymTableArena object hands out memory for one symbol table from a
+   list of chunks it owns. Fixed-size blocks (bindings) are recycled
+   through a free list. Variable-size byte strings (keys) are rounded up
+   to a size class and recycled through one free list per class; those
+   too large for any class are malloc'd one at a time. A symbol table
+   embeds its arena, so it costs nothing until the first allocation. */
+struct SymTableArena {
+   /* Most recently allocated chunk; each chunk links to the previous one */
+   struct SymTableArenaChunk *chunks;
+   /* Next free byte of the most recent chunk */
+   char *top;
+   /* Bytes left after top in the most recent chunk */
+   size_t left;
+   /* Singly linked list of blocks returned by SymTableArena_freeBlock */
+   void *freeBlocks;
+   /* Singly linked lists of byte strings returned by
+      SymTableArena_freeBytes, one per size class */
+   void *freeBytes[SYMTABLEARENA_BYTE_CLASSES];
+   /* Doubly linked list of the byte strings too large for a size class */
+   struct SymTableArenaLarge *large;
+   /* Size of every block, rounded up to the arena's alignment */
+   size_t blockSize;
+   /* Size of the next chunk to allocate */
+   size_t chunkSize;
+   /* Total bytes obtained from malloc, including chunk headers */
+   size_t bytesReserved;
+};
+
+/* Initialize *psArena to hand out blocks of uBlockSize bytes. No memory
+   is allocated until the first request. */
+void SymTableArena_init(struct SymTableArena *psArena, size_t uBlockSize);
+
+/* Return a block of psArena's block size, reusing a freed block if one
+   is available. Return NULL if memory is exhausted. */
+void *SymTableArena_allocBlock(struct SymTableArena *psArena);
+
+/* Return the block pvBlock, obtained from SymTableArena_allocBlock on
+   psArena, to psArena's free list. */
+void SymTableArena_freeBlock(struct SymTableArena *psArena, void *pvBlock);
+
+/* Return uSize bytes from psArena, reusing freed bytes of the same
+   size class if there are any. Return NULL if memory is exhausted. */
+char *SymTableArena_allocBytes(struct SymTableArena *psArena, size_t uSize);
+
+/* Return the uSize bytes at pcBytes, obtained from
+   SymTableArena_allocBytes on psArena with the same uSize, to psArena
+   for reuse. */
+void SymTableArena_freeBytes(struct SymTableArena *psArena, char *pcBytes, size_t uSize);
+
+/* Release every chunk of psArena, invalidating all blocks and bytes
+   handed out, and leave psArena empty but usable. */
+void SymTableArena_free(struct SymTableArena *psArena);
+
+#endif
@@ -0,0 +1,560 @@
+/*--------------------------------------------------------------------*/
+/* symtableconc.c                                                     */
+/* Author: Chinmayi R                                                 */
+/*--------------------------------------------------------------------*/
+
+/* Reader-writer locks are POSIX.1-2001, not C99. */
+#define _POSIX_C_SOURCE 200112L
+
+#include "symtable.h"
+#include "symtablearena.h"
+#include "symtableconc.h"
+#include <pthread.h>
+#include <stdint.h>
+
+/* A thread-safe chained hash table. It implements the core functions of
+   symtable.h (SymTable_new through SymTable_map); the extension
+   functions are provided only by the single-threaded implementations.
+
+   Bindings are split into STRIPE_COUNT stripes by the top bits of their
+   hash times a Fibonacci multiplier, and each stripe has its own
+   reader-writer lock, length and arena. The bucket count is always a
+   multiple of STRIPE_COUNT, and each stripe owns one contiguous run of
+   size / STRIPE_COUNT buckets, within which a binding's bucket is its
+   hash modulo the run length. So every binding of a bucket belongs to
+   the same stripe, before and after a resize. A lookup takes
+   one stripe's read lock, so readers of different stripes never touch
+   the same lock, and an update takes one stripe's write lock. Only a
+   resize locks every stripe. */
+
+/* Number of bits of a stripe index, and number of stripes, which
+   divides every bucket count. */
+enum {STRIPE_BITS = SYMTABLECONC_STRIPE_BITS};
+enum {STRIPE_COUNT = SYMTABLECONC_STRIPE_COUNT};
+
+/* Golden-ratio multiplier that mixes every bit of a hash into the top
+   STRIPE_BITS bits of the product, from which the stripe is taken. The
+   hash itself is a polynomial in 65599, which is -1 modulo 64, so its
+   low bits are a poor stripe index. */
+#define STRIPE_MULTIPLIER UINT64_C(0x9E3779B97F4A7C15)
+
+/* Bytes per cache line, to which each stripe is padded so that
+   threads working on different stripes do not share lines. */
+enum {CACHE_LINE_SIZE = 64};
+
+/* Bucket count of a new table is STRIPE_COUNT times this prime. */
+enum {INITIAL_BUCKETS_PER_STRIPE = 7};
+
+/* Size of the key buffer inside each binding. Keys shorter than this are
+   stored in the binding itself; longer keys are stored in the arena. */
+enum {INLINE_KEY_SIZE = 24};
+
+/* Default maximum load factor (bindings per bucket) before a put grows
+   the table. Can be overridden at build time with
+   -DSYMTABLE_MAX_LOAD_FACTOR. */
+#ifndef SYMTABLE_MAX_LOAD_FACTOR
+#define SYMTABLE_MAX_LOAD_FACTOR 1.0
+#endif
+
+/* A Binding_T object represents a single key-value pair within a symbol table. */
+typedef struct Binding Binding_T;
+/* Each binding contains:
+   - next: a pointer to the next binding in a linked list.
+   - hash: the full hash of key, before reduction to a bucket index.
+   - value: a pointer to the associated data.
+   - key: a unique string identifier for the binding, either stored in
+     key.inline_key, or in its stripe's arena at key.long_key with the
+     last byte of key.inline_key set to 1 to tell the two apart. */
+struct Binding {
+    /* Pointer to next node in the list */
+    struct Binding *next;
+
+    /* Full hash of key, compared before strcmp and reused on resize */
+    size_t hash;
+
+    /* Pointer to associated data */
+    const void *value;
+
+    /* Unique string identifier, inline if short enough */
+    union {
+        char inline_key[INLINE_KEY_SIZE];
+        char *long_key;
+    } key;
+};
+
+/* A Stripe object holds the state shared by the buckets of one stripe:
+   - lock: guards those buckets' chains, and the rest of the stripe.
+   - len: the number of bindings in the stripe.
+   - arena: the memory of the stripe's bindings and keys. */
+struct Stripe {
+    /* Reader-writer lock of the stripe */
+    pthread_rwlock_t lock;
+
+    /* Number of key-value bindings in the stripe */
+    size_t len;
+
+    /* Slab of bindings and size-classed key storage */
+    struct SymTableArena arena;
+};
+
+/* A stripe padded to a whole number of cache lines. */
+union PaddedStripe {
+    struct Stripe stripe;
+    char pad[(sizeof(struct Stripe) + CACHE_LINE_SIZE - 1)
+             / CACHE_LINE_SIZE * CACHE_LINE_SIZE];
+};
+
+/* A SymTable object represents a hash table of STRIPE_COUNT stripes.
+   It contains:
+   - buckets: an array of pointers to the first binding of each bucket.
+   - size: the number of buckets, a multiple of STRIPE_COUNT.
+   - growAt: the stripe length at which a put grows the table.
+   - stripes: the stripes.
+   buckets, size and growAt change only while every stripe is write
+   locked, so holding any stripe's lock keeps them stable. */
+struct SymTable {
+    /* Array of pointers to bindings */
+    struct Binding **buckets;
+
+    /* Number of buckets */
+    size_t size;
+
+    /* Stripe length at which the next put grows the table */
+    size_t growAt;
+
+    /* Locks, lengths and arenas of the stripes */
+    union PaddedStripe stripes[STRIPE_COUNT];
+};
+
+/* Return the full hash value of the string pcKey, and store the length
+   of pcKey in *puLength. */
+static size_t SymTable_hash(const char *pcKey, size_t *puLength)
+{
+   const size_t HASH_MULTIPLIER = 65599;
+   size_t u;
+   size_t uHash = 0;
+
+   assert(pcKey != NULL);
+   assert(puLength != NULL);
+
+   for (u = 0; pcKey[u] != '\0'; u++)
+      uHash = uHash * HASH_MULTIPLIER + (size_t)pcKey[u];
+
+   *puLength = u;
+   return uHash;
+}
+
+/* Return the index of the stripe that holds bindings of hash uHash. */
+static size_t SymTable_stripeIndex(size_t uHash)
+{
+    return (size_t)(((uint64_t)uHash * STRIPE_MULTIPLIER) >> (64 - STRIPE_BITS));
+}
+
+/* Return the stripe of oSymTable that holds bindings of hash uHash. */
+static struct Stripe *SymTable_stripe(SymTable_T oSymTable, size_t uHash)
+{
+    return &oSymTable->stripes[SymTable_stripeIndex(uHash)].stripe;
+}
+
+/* Return the index of the bucket that holds bindings of hash uHash in a
+   bucket array of uSize buckets: a bucket in the run of the hash's
+   stripe. */
+static size_t SymTable_bucketIndex(size_t uHash, size_t uSize)
+{
+    size_t uRun = uSize / STRIPE_COUNT;
+    return SymTable_stripeIndex(uHash) * uRun + uHash % uRun;
+}
+
+/* Return the index of the stripe that holds the binding for pcKey. */
+size_t SymTableConc_stripeOf(const char *pcKey)
+{
+    size_t uLength;
+
+    assert(pcKey != NULL);
+
+    return SymTable_stripeIndex(SymTable_hash(pcKey, &uLength));
+}
+
+/* Return the key of the binding pBinding. */
+static const char *SymTable_bindingKey(const Binding_T *pBinding)
+{
+    assert(pBinding != NULL);
+    if (pBinding->key.inline_key[INLINE_KEY_SIZE - 1] == '\0')
+        return pBinding->key.inline_key;
+    return pBinding->key.long_key;
+}
+
+/* Store a copy of pcKey, which has length uLength, in pBinding, inline
+   if it fits and in the arena of psStripe otherwise. Return 1 on
+   success, or 0 if memory is exhausted. */
+static int SymTable_setBindingKey(struct Stripe *psStripe, Binding_T *pBinding,
+                                  const char *pcKey, size_t uLength)
+{
+    char *long_key;
+
+    assert(psStripe != NULL);
+    assert(pBinding != NULL);
+    assert(pcKey != NULL);
+
+    if (uLength < INLINE_KEY_SIZE)
+    {
+        memset(pBinding->key.inline_key, 0, INLINE_KEY_SIZE);
+        memcpy(pBinding->key.inline_key, pcKey, uLength);
+        return 1;
+    }
+    long_key = SymTableArena_allocBytes(&psStripe->arena, uLength + 1);
+    if (long_key == NULL) {return 0;}
+    memcpy(long_key, pcKey, uLength + 1);
+    pBinding->key.inline_key[INLINE_KEY_SIZE - 1] = 1;
+    pBinding->key.long_key = long_key;
+    return 1;
+}
+
+/* Return the binding of oSymTable whose key is pcKey, where uHash is the
+   full hash of pcKey, or NULL if there is none. The caller holds the
+   lock of the key's stripe. */
+static struct Binding *SymTable_find(SymTable_T oSymTable, const char *pcKey, size_t uHash)
+{
+    struct Binding *pBinding = oSymTable->buckets[SymTable_bucketIndex(uHash, oSymTable->size)];
+
+    for (; pBinding != NULL; pBinding = pBinding->next)
+    {
+        if (pBinding->hash == uHash && strcmp(SymTable_bindingKey(pBinding), pcKey) == 0)
+            return pBinding;
+    }
+    return NULL;
+}
+
+/* Write lock every stripe of oSymTable, always in the same order. */
+static void SymTable_lockAll(SymTable_T oSymTable)
+{
+    size_t i;
+    for (i = 0; i < STRIPE_COUNT; i++)
+        pthread_rwlock_wrlock(&oSymTable->stripes[i].stripe.lock);
+}
+
+/* Unlock every stripe of oSymTable. */
+static void SymTable_unlockAll(SymTable_T oSymTable)
+{
+    size_t i;
+    for (i = 0; i < STRIPE_COUNT; i++)
+        pthread_rwlock_unlock(&oSymTable->stripes[i].stripe.lock);
+}
+
+/* Return 1 if u is prime, 0 otherwise. */
+static int SymTable_isPrime(size_t u)
+{
+    size_t d;
+    if (u < 2) {return 0;}
+    if (u % 2 == 0) {return u == 2;}
+    for (d = 3; d <= u / d; d += 2) {
+        if (u % d == 0) {return 0;}
+    }
+    return 1;
+}
+
+/* Return the bucket count that follows size: STRIPE_COUNT times the
+   smallest prime greater than twice size / STRIPE_COUNT. Return size
+   itself if the table cannot grow any further without overflowing the
+   bucket array's byte count. */
+static size_t SymTable_nextBucketCount(size_t size)
+{
+    size_t next = 2 * (size / STRIPE_COUNT) + 1;
+
+    if (size > ((size_t)-1 / sizeof(Binding_T *) - STRIPE_COUNT) / 2) {return size;}
+    while (!SymTable_isPrime(next)) {next += 2;}
+    return next * STRIPE_COUNT;
+}
+
+/* Recompute the stripe length at which oSymTable grows, from its current
+   bucket count. */
+static void SymTable_setGrowAt(SymTable_T oSymTable)
+{
+    double limit = SYMTABLE_MAX_LOAD_FACTOR * (double)(oSymTable->size / STRIPE_COUNT);
+    if (limit >= (double)((size_t)-1)) {oSymTable->growAt = (size_t)-1;}
+    else if (limit < 1.0) {oSymTable->growAt = 1;}
+    else {oSymTable->growAt = (size_t)limit;}
+}
+
+/* Grow oSymTable to the bucket count that follows old_size, unless
+   another thread already resized it after old_size was observed. Every
+   stripe is locked while bindings are relinked by their cached hashes.
+   If memory is exhausted the table keeps its buckets. */
+static void SymTable_grow(SymTable_T oSymTable, size_t old_size)
+{
+    Binding_T **new_buckets;
+    Binding_T *pBinding;
+    Binding_T *next;
+    size_t size;
+    size_t i;
+
+    SymTable_lockAll(oSymTable);
+    if (oSymTable->size != old_size) {SymTable_unlockAll(oSymTable); return;}
+
+    size = SymTable_nextBucketCount(old_size);
+    new_buckets = (size == old_size) ? NULL
+        : (Binding_T **) calloc(size, sizeof(*new_buckets));
+    if (new_buckets != NULL)
+    {
+        for (i = 0; i < old_size; i++)
+        {
+            for (pBinding = oSymTable->buckets[i]; pBinding != NULL; pBinding = next)
+            {
+                next = pBinding->next;
+                pBinding->next = new_buckets[SymTable_bucketIndex(pBinding->hash, size)];
+                new_buckets[SymTable_bucketIndex(pBinding->hash, size)] = pBinding;
+            }
+        }
+        free(oSymTable->buckets);
+        oSymTable->buckets = new_buckets;
+        oSymTable->size = size;
+        SymTable_setGrowAt(oSymTable);
+    }
+    SymTable_unlockAll(oSymTable);
+}
+
+/* Create a new symbol table and return a pointer to it, or NULL if
+   memory or locks are exhausted. */
+SymTable_T SymTable_new(void)
+{
+    struct SymTable *pSymtable;
+    struct Stripe *psStripe;
+    size_t i;
+
+    pSymtable = (struct SymTable *) calloc(1, sizeof(*pSymtable));
+    if (pSymtable == NULL) {return NULL;}
+    pSymtable->size = STRIPE_COUNT * INITIAL_BUCKETS_PER_STRIPE;
+    pSymtable->buckets = (struct Binding **) calloc(pSymtable->size, sizeof(*pSymtable->buckets));
+    if (pSymtable->buckets == NULL) {free(pSymtable); return NULL;}
+    SymTable_setGrowAt(pSymtable);
+
+    for (i = 0; i < STRIPE_COUNT; i++)
+    {
+        psStripe = &pSymtable->stripes[i].stripe;
+        if (pthread_rwlock_init(&psStripe->lock, NULL) != 0)
+        {
+            while (i-- > 0) {pthread_rwlock_destroy(&pSymtable->stripes[i].stripe.lock);}
+            free(pSymtable->buckets);
+            free(pSymtable);
+            return NULL;
+        }
+        psStripe->len = 0;
+        SymTableArena_init(&psStripe->arena, sizeof(Binding_T));
+    }
+    return pSymtable;
+}
+
+/* Free all memory associated with the symbol table oSymTable,
+   including all bindings and the table structure itself. No other
+   thread may be using oSymTable. */
+void SymTable_free(SymTable_T oSymTable)
+{
+    size_t i;
+
+    assert(oSymTable != NULL);
+
+    for (i = 0; i < STRIPE_COUNT; i++)
+    {
+        pthread_rwlock_destroy(&oSymTable->stripes[i].stripe.lock);
+        SymTableArena_free(&oSymTable->stripes[i].stripe.arena);
+    }
+    free(oSymTable->buckets);
+    free(oSymTable);
+}
+
+/* Return the number of key-value bindings stored in the symbol table
+   oSymTable. The stripes are counted one at a time, so concurrent
+   updates may or may not be included. */
+size_t SymTable_getLength(SymTable_T oSymTable)
+{
+    struct Stripe *psStripe;
+    size_t len = 0;
+    size_t i;
+
+    assert(oSymTable != NULL);
+
+    for (i = 0; i < STRIPE_COUNT; i++)
+    {
+        psStripe = &oSymTable->stripes[i].stripe;
+        pthread_rwlock_rdlock(&psStripe->lock);
+        len += psStripe->len;
+        pthread_rwlock_unlock(&psStripe->lock);
+    }
+    return len;
+}
+
+/* Insert a new binding with key pcKey and value pvValue into the symbol table oSymTable.
+   If pcKey already exists in oSymTable, the function does nothing and returns 0.
+   Returns 1 on successful insertion. */
+int SymTable_put(SymTable_T oSymTable, const char *pcKey, const void *pvValue)
+{
+    struct Stripe *psStripe;
+    Binding_T *newBinding;
+    size_t hash_value;
+    size_t key_len;
+    size_t size;
+    int iGrown = 0;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    hash_value = SymTable_hash(pcKey, &key_len);
+    psStripe = SymTable_stripe(oSymTable, hash_value);
+
+    /* Growing needs every lock, so drop this one, grow, and look again. */
+    for (;;)
+    {
+        pthread_rwlock_wrlock(&psStripe->lock);
+        if (SymTable_find(oSymTable, pcKey, hash_value) != NULL)
+        {
+            pthread_rwlock_unlock(&psStripe->lock);
+            return 0;
+        }
+        if (iGrown || psStripe->len < oSymTable->growAt) {break;}
+        size = oSymTable->size;
+        pthread_rwlock_unlock(&psStripe->lock);
+        SymTable_grow(oSymTable, size);
+        iGrown = 1;
+    }
+
+    newBinding = (Binding_T *) SymTableArena_allocBlock(&psStripe->arena);
+    if (newBinding == NULL || !SymTable_setBindingKey(psStripe, newBinding, pcKey, key_len))
+    {
+        if (newBinding != NULL) {SymTableArena_freeBlock(&psStripe->arena, newBinding);}
+        pthread_rwlock_unlock(&psStripe->lock);
+        return 0;
+    }
+    newBinding->hash = hash_value;
+    newBinding->value = pvValue;
+    newBinding->next = oSymTable->buckets[SymTable_bucketIndex(hash_value, oSymTable->size)];
+    oSymTable->buckets[SymTable_bucketIndex(hash_value, oSymTable->size)] = newBinding;
+    ++(psStripe->len);
+    pthread_rwlock_unlock(&psStripe->lock);
+    return 1;
+}
+
+/* Replace the value associated with pcKey in the symbol table oSymTable with pvValue.
+   Returns the old value associated with pcKey if it exists, otherwise returns NULL. */
+void *SymTable_replace(SymTable_T oSymTable, const char *pcKey, const void *pvValue)
+{
+    struct Stripe *psStripe;
+    Binding_T *pBinding;
+    size_t hash_value;
+    size_t key_len;
+    const void *temp = NULL;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    hash_value = SymTable_hash(pcKey, &key_len);
+    psStripe = SymTable_stripe(oSymTable, hash_value);
+    pthread_rwlock_wrlock(&psStripe->lock);
+    pBinding = SymTable_find(oSymTable, pcKey, hash_value);
+    if (pBinding != NULL)
+    {
+        temp = pBinding->value;
+        pBinding->value = pvValue;
+    }
+    pthread_rwlock_unlock(&psStripe->lock);
+    return (void *) temp;
+}
+
+/* Check if the symbol table oSymTable contains a binding for pcKey.
+   Returns 1 if pcKey is found, 0 otherwise. */
+int SymTable_contains(SymTable_T oSymTable, const char *pcKey)
+{
+    struct Stripe *psStripe;
+    size_t hash_value;
+    size_t key_len;
+    int iFound;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    hash_value = SymTable_hash(pcKey, &key_len);
+    psStripe = SymTable_stripe(oSymTable, hash_value);
+    pthread_rwlock_rdlock(&psStripe->lock);
+    iFound = SymTable_find(oSymTable, pcKey, hash_value) != NULL;
+    pthread_rwlock_unlock(&psStripe->lock);
+    return iFound;
+}
+
+/* Retrieve the value associated with pcKey in the symbol table oSymTable.
+   Returns NULL if pcKey is not found. */
+void *SymTable_get(SymTable_T oSymTable, const char *pcKey)
+{
+    struct Stripe *psStripe;
+    Binding_T *pBinding;
+    size_t hash_value;
+    size_t key_len;
+    const void *temp = NULL;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    hash_value = SymTable_hash(pcKey, &key_len);
+    psStripe = SymTable_stripe(oSymTable, hash_value);
+    pthread_rwlock_rdlock(&psStripe->lock);
+    pBinding = SymTable_find(oSymTable, pcKey, hash_value);
+    if (pBinding != NULL) {temp = pBinding->value;}
+    pthread_rwlock_unlock(&psStripe->lock);
+    return (void *) temp;
+}
+
+/* Remove the binding for pcKey from the symbol table oSymTable, freeing its memory.
+   Returns the value associated with pcKey, or NULL if pcKey is not found. */
+void *SymTable_remove(SymTable_T oSymTable, const char *pcKey)
+{
+    struct Stripe *psStripe;
+    Binding_T **ppLink;
+    Binding_T *pBinding;
+    size_t hash_value;
+    size_t key_len;
+    const void *temp = NULL;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    hash_value = SymTable_hash(pcKey, &key_len);
+    psStripe = SymTable_stripe(oSymTable, hash_value);
+    pthread_rwlock_wrlock(&psStripe->lock);
+    for (ppLink = &oSymTable->buckets[SymTable_bucketIndex(hash_value, oSymTable->size)];
+         *ppLink != NULL; ppLink = &(*ppLink)->next)
+    {
+        pBinding = *ppLink;
+        if (pBinding->hash == hash_value && strcmp(SymTable_bindingKey(pBinding), pcKey) == 0)
+        {
+            *ppLink = pBinding->next;
+            --(psStripe->len);
+            temp = pBinding->value;
+            if (key_len >= INLINE_KEY_SIZE)
+                SymTableArena_freeBytes(&psStripe->arena, pBinding->key.long_key, key_len + 1);
+            SymTableArena_freeBlock(&psStripe->arena, pBinding);
+            break;
+        }
+    }
+    pthread_rwlock_unlock(&psStripe->lock);
+    return (void *) temp;
+}
+
+/* Apply the function pfApply to each binding in the symbol table oSymTable,
+   passing pcKey, pvValue, and pvExtra as arguments. Every stripe is read
+   locked for the duration, so pfApply sees a consistent snapshot and must
+   not call any function on oSymTable. */
+void SymTable_map(SymTable_T oSymTable, void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra), const void *pvExtra)
+{
+    Binding_T *pBinding;
+    size_t i;
+
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    for (i = 0; i < STRIPE_COUNT; i++)
+        pthread_rwlock_rdlock(&oSymTable->stripes[i].stripe.lock);
+    for (i = 0; i < oSymTable->size; i++)
+    {
+        for (pBinding = oSymTable->buckets[i]; pBinding != NULL; pBinding = pBinding->next)
+            (*pfApply)(SymTable_bindingKey(pBinding), (void *) pBinding->value, (void *) pvExtra);
+    }
+    SymTable_unlockAll(oSymTable);
+}
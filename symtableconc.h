@@ -0,0 +1,21 @@
+/*--------------------------------------------------------------------*/
+/* symtableconc.h                                                     */
+/* Author: Chinmayi R                                                 */
+/*--------------------------------------------------------------------*/
+#include <stddef.h>
+
+#ifndef SYMTABLECONC_INCLUDED
+#define SYMTABLECONC_INCLUDED
+
+/* Interface between the striped thread-safe SymTable implementation and
+   the stress test, which checks that keys spread evenly over the
+   stripes. Clients use symtable.h instead. */
+
+/* Number of bits of a stripe index, and number of stripes */
+enum {SYMTABLECONC_STRIPE_BITS = 6};
+enum {SYMTABLECONC_STRIPE_COUNT = 1 << SYMTABLECONC_STRIPE_BITS};
+
+/* Return the index of the stripe that holds the binding for pcKey. */
+size_t SymTableConc_stripeOf(const char *pcKey);
+
+#endif
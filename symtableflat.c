@@ -0,0 +1,1257 @@
+/*--------------------------------------------------------------------*/
+/* symtableflat.c                                                     */
+/* Author: Chinmayi R                                                 */
+/*--------------------------------------------------------------------*/
+#include "symtable.h"
+#include "symtableintern.h"
+#include "symtablehashfn.h"
+#include "symtableparallel.h"
+#include "symtablestats.h"
+#include "symtabletrace.h"
+
+/* Control groups are matched with SSE2 when the compiler targets it
+   (every x86-64 compiler does), and with portable 64-bit word arithmetic
+   otherwise. Build with -DSYMTABLE_NO_SIMD to force the portable code. */
+#if defined(__SSE2__) && !defined(SYMTABLE_NO_SIMD)
+#define SYMTABLE_SSE2
+#include <emmintrin.h>
+#endif
+
+/* Number of slots whose control bytes are examined together. The slot
+   count is always a power of two and a multiple of GROUP_WIDTH. */
+enum {GROUP_WIDTH = 16};
+
+/* Number of slots in a new table. Built with -DSYMTABLE_HYBRID, a table
+   starts with a single group of slots stored inside the table structure
+   itself, so creating a table is one allocation and a lookup in a tiny
+   table is one group match over a contiguous array. The table moves to
+   heap arrays when it first grows, and back when it shrinks to one
+   group. */
+#ifdef SYMTABLE_HYBRID
+enum {INITIAL_CAPACITY = GROUP_WIDTH};
+#else
+enum {INITIAL_CAPACITY = 2 * GROUP_WIDTH};
+#endif
+
+/* Control byte of a slot that has never held a binding. Probing stops at
+   any group that contains one. */
+#define CTRL_EMPTY ((signed char)-128)
+
+/* Control byte of a slot whose binding was removed (a tombstone).
+   Probing continues past it. */
+#define CTRL_DELETED ((signed char)-2)
+
+/* Size of the key buffer inside each slot. Keys shorter than this are
+   stored in the slot itself; longer keys are stored on the heap. */
+enum {INLINE_KEY_SIZE = 16};
+
+/* Default maximum load factor (live plus deleted slots per slot) before
+   a put rehashes the table. Can be overridden at build time with
+   -DSYMTABLE_MAX_LOAD_FACTOR or per table with SymTable_setMaxLoadFactor.
+   It must stay below 1 so that every probe sequence reaches an empty slot. */
+#ifndef SYMTABLE_MAX_LOAD_FACTOR
+#define SYMTABLE_MAX_LOAD_FACTOR 0.875
+#endif
+
+/* Number of keys of a batch that are hashed and prefetched together
+   before any of them is resolved. */
+enum {BATCH_CHUNK = 16};
+
+/* Hint that the memory at p will soon be read. */
+#ifdef __GNUC__
+#define SymTable_prefetch(p) __builtin_prefetch(p)
+#else
+#define SymTable_prefetch(p) ((void)(p))
+#endif
+
+/* A Slot_T object is one entry of the contiguous slot array. Its control
+   byte, kept in a separate array, says whether it is empty, deleted or
+   full; when full, the control byte holds the low 7 bits of the hash. */
+typedef struct Slot Slot_T;
+/* Each slot contains:
+   - hash: the full hash of key.
+   - value: a pointer to the associated data.
+   - key: a unique string identifier for the binding, either stored in
+     key.inline_key, or at key.heap_key with the last byte of
+     key.inline_key set to KEY_HEAP if the slot owns that copy or to
+     KEY_INTERNED if it belongs to the intern pool. */
+enum {KEY_HEAP = 1, KEY_INTERNED = 2};
+struct Slot {
+    /* Full hash of key, compared before strcmp and reused on rehash */
+    size_t hash;
+
+    /* Pointer to associated data */
+    const void *value;
+
+    /* Unique string identifier, inline if short enough */
+    union {
+        char inline_key[INLINE_KEY_SIZE];
+        char *heap_key;
+    } key;
+};
+
+/* A SymTable object represents an open-addressing hash table whose slots
+   are probed a group of GROUP_WIDTH control bytes at a time.
+   It contains:
+   - ctrl: an array of one control byte per slot.
+   - slots: an array of slots.
+   - capacity: the number of slots.
+   - len: the number of key-value bindings stored in the table.
+   - tombstones: the number of slots marked CTRL_DELETED.
+   - maxLoad: the maximum load factor allowed before rehashing.
+   - growAt: the value of len + tombstones at which the next put rehashes.
+   - shrinkAt: the value of len below which a remove rehashes into fewer
+     slots.
+   - resizes: the number of times the table has been rehashed.
+   - hashFunction: the function that hashes keys.
+   - sipKey: the secret key of SYMTABLE_HASH_KEYED, a copy of the
+     process-wide key.
+   - inlineCtrl, inlineSlots: in the hybrid build, the arrays ctrl and
+     slots point to while the table has INITIAL_CAPACITY slots.
+   - stats: in a build with SYMTABLE_STATS, the instrumentation
+     counters.
+   - traceId: in a build with SYMTABLE_TRACE, the id of the table in
+     the trace. */
+struct SymTable {
+    /* Array of control bytes, one per slot */
+    signed char *ctrl;
+
+    /* Array of slots */
+    struct Slot *slots;
+
+    /* Number of slots */
+    size_t capacity;
+
+    /* Number of key-value bindings stored */
+    size_t len;
+
+    /* Number of deleted slots */
+    size_t tombstones;
+
+    /* Maximum load factor before rehashing */
+    double maxLoad;
+
+    /* Used slot count at which the next put rehashes */
+    size_t growAt;
+
+    /* Length below which the next remove shrinks the table */
+    size_t shrinkAt;
+
+    /* Number of completed rehashes */
+    size_t resizes;
+
+    /* Function that hashes keys */
+    enum SymTable_HashFunction hashFunction;
+
+    /* Secret key of the keyed hash function */
+    unsigned long long sipKey[2];
+
+#ifdef SYMTABLE_HYBRID
+    /* Control bytes of the smallest table */
+    signed char inlineCtrl[INITIAL_CAPACITY];
+
+    /* Slots of the smallest table */
+    struct Slot inlineSlots[INITIAL_CAPACITY];
+#endif
+
+#ifdef SYMTABLE_STATS
+    /* Instrumentation counters */
+    struct SymTableStats stats;
+#endif
+
+#ifdef SYMTABLE_TRACE
+    /* Id of the table in the trace */
+    size_t traceId;
+#endif
+};
+
+/* Return 1 if the control array ctrl is stored inside oSymTable, and so
+   must not be freed, or 0 if it is on the heap. */
+#ifdef SYMTABLE_HYBRID
+#define SymTable_isInline(oSymTable, ctrl) ((ctrl) == (oSymTable)->inlineCtrl)
+#else
+#define SymTable_isInline(oSymTable, ctrl) 0
+#endif
+
+/* Return uHash, a multiply-by-65599 hash, finished with a 64-bit mixing
+   step so that both the low 7 bits (the control byte) and the high bits
+   (the group index) depend on every character. */
+static size_t SymTable_mix(size_t uHash)
+{
+    unsigned long long ullHash = (unsigned long long)uHash;
+
+    ullHash ^= ullHash >> 33;
+    ullHash *= 0xff51afd7ed558ccdULL;
+    ullHash ^= ullHash >> 33;
+    ullHash *= 0xc4ceb9fe1a85ec53ULL;
+    ullHash ^= ullHash >> 33;
+    return (size_t)ullHash;
+}
+
+/* Return the full hash value of the uLength characters at pcKey, as
+   computed by the hash function of oSymTable. The legacy hash is mixed
+   by SymTable_mix; the others already spread every input bit. */
+static size_t SymTable_hashBytes(SymTable_T oSymTable, const char *pcKey, size_t uLength)
+{
+    switch (oSymTable->hashFunction)
+    {
+        case SYMTABLE_HASH_WORD:
+            return SymTableHashFn_word(pcKey, uLength);
+        case SYMTABLE_HASH_KEYED:
+            return SymTableHashFn_sip(pcKey, uLength, oSymTable->sipKey);
+        default:
+            return SymTable_mix(SymTableHashFn_legacy(pcKey, uLength));
+    }
+}
+
+/* Return the full hash value of the string pcKey, and store the length
+   of pcKey in *puLength. The legacy hash is the assignment's
+   multiply-by-65599 hash, which the intern pool also stores, computed in
+   the same pass that finds the length and mixed by SymTable_mix. */
+static size_t SymTable_hash(SymTable_T oSymTable, const char *pcKey, size_t *puLength)
+{
+    const size_t HASH_MULTIPLIER = 65599;
+    size_t uHash = 0;
+    size_t u;
+
+    assert(pcKey != NULL);
+    assert(puLength != NULL);
+
+    if (oSymTable->hashFunction != SYMTABLE_HASH_LEGACY)
+    {
+        *puLength = strlen(pcKey);
+        return SymTable_hashBytes(oSymTable, pcKey, *puLength);
+    }
+
+    for (u = 0; pcKey[u] != '\0'; u++)
+        uHash = uHash * HASH_MULTIPLIER + (size_t)pcKey[u];
+    *puLength = u;
+    return SymTable_mix(uHash);
+}
+
+/* Return the full hash value of the uLength characters at pcKey, which
+   is the value SymTable_hash returns for the same characters. */
+size_t SymTable_hashKey(SymTable_T oSymTable, const char *pcKey, size_t uLength)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_hashBytes(oSymTable, pcKey, uLength);
+}
+
+/* Return the full hash value of pcInterned, a string from the intern
+   pool, reusing the hash the pool stored if the table hashes the same
+   way. */
+static size_t SymTable_internedHash(SymTable_T oSymTable, const char *pcInterned)
+{
+    if (oSymTable->hashFunction == SYMTABLE_HASH_LEGACY)
+        return SymTable_mix(SymTableIntern_hash(pcInterned));
+    return SymTable_hashBytes(oSymTable, pcInterned, SymTableIntern_length(pcInterned));
+}
+
+/* Return the key stored in the full slot psSlot. */
+static const char *SymTable_slotKey(const struct Slot *psSlot)
+{
+    assert(psSlot != NULL);
+    if (psSlot->key.inline_key[INLINE_KEY_SIZE - 1] == '\0')
+        return psSlot->key.inline_key;
+    return psSlot->key.heap_key;
+}
+
+/* Store pcKey, which has length uLength, in the slot psSlot. If
+   iShared, store the pointer pcKey itself; otherwise store a copy.
+   Return 1 on success, or 0 if memory is exhausted. */
+static int SymTable_setSlotKey(struct Slot *psSlot, const char *pcKey, size_t uLength,
+                               int iShared)
+{
+    char *heap_key;
+
+    assert(psSlot != NULL);
+    assert(pcKey != NULL);
+
+    if (iShared)
+    {
+        psSlot->key.inline_key[INLINE_KEY_SIZE - 1] = KEY_INTERNED;
+        psSlot->key.heap_key = (char *)pcKey;
+        return 1;
+    }
+    if (uLength < INLINE_KEY_SIZE)
+    {
+        memset(psSlot->key.inline_key, 0, INLINE_KEY_SIZE);
+        memcpy(psSlot->key.inline_key, pcKey, uLength);
+        return 1;
+    }
+    heap_key = (char *) malloc(uLength + 1);
+    if (heap_key == NULL) {return 0;}
+    memcpy(heap_key, pcKey, uLength);
+    heap_key[uLength] = '\0';
+    psSlot->key.inline_key[INLINE_KEY_SIZE - 1] = KEY_HEAP;
+    psSlot->key.heap_key = heap_key;
+    return 1;
+}
+
+/* Free the key of the full slot psSlot if the slot owns a heap copy. */
+static void SymTable_freeSlotKey(struct Slot *psSlot)
+{
+    assert(psSlot != NULL);
+    if (psSlot->key.inline_key[INLINE_KEY_SIZE - 1] == KEY_HEAP)
+        free(psSlot->key.heap_key);
+}
+
+/* Return the control byte stored for a binding with full hash uHash. */
+static signed char SymTable_tag(size_t uHash)
+{
+    return (signed char)(uHash & 0x7F);
+}
+
+#ifdef SYMTABLE_SSE2
+
+/* Return a bit mask with bit i set for each i < GROUP_WIDTH such that
+   pcGroup[i] == cByte, comparing all 16 bytes in one instruction. */
+static unsigned SymTable_matchByte(const signed char *pcGroup, signed char cByte)
+{
+    __m128i group = _mm_loadu_si128((const __m128i *)(const void *)pcGroup);
+    return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(cByte)));
+}
+
+/* Return a bit mask with bit i set for each i < GROUP_WIDTH such that
+   pcGroup[i] is CTRL_EMPTY or CTRL_DELETED, that is, not full. */
+static unsigned SymTable_matchFree(const signed char *pcGroup)
+{
+    __m128i group = _mm_loadu_si128((const __m128i *)(const void *)pcGroup);
+    return (unsigned)_mm_movemask_epi8(group);
+}
+
+#else
+
+/* Return the 8 control bytes starting at pcBytes as one 64-bit word,
+   with pcBytes[0] in the least significant byte. */
+static unsigned long long SymTable_loadWord(const signed char *pcBytes)
+{
+    unsigned long long ullWord = 0;
+    int i;
+    for (i = 7; i >= 0; i--)
+        ullWord = (ullWord << 8) | (unsigned char)pcBytes[i];
+    return ullWord;
+}
+
+/* Given ullBits, a word in which only the high bit of each byte may be
+   set, return an 8-bit mask with bit i set if byte i's high bit is set. */
+static unsigned SymTable_packHighBits(unsigned long long ullBits)
+{
+    return (unsigned)(((ullBits >> 7) * 0x0102040810204080ULL) >> 56);
+}
+
+/* Return a bit mask with bit i set for each i < GROUP_WIDTH such that
+   pcGroup[i] == cByte. The group is compared 8 bytes at a time; a byte
+   just above a real match can be reported too, but only if it is full,
+   so callers must still compare the slot's hash. */
+static unsigned SymTable_matchByte(const signed char *pcGroup, signed char cByte)
+{
+    const unsigned long long LOW_BITS = 0x0101010101010101ULL;
+    const unsigned long long HIGH_BITS = 0x8080808080808080ULL;
+    unsigned long long ullDiff;
+    unsigned uMask = 0;
+    int i;
+    for (i = 0; i < GROUP_WIDTH; i += 8) {
+        ullDiff = SymTable_loadWord(pcGroup + i) ^ (LOW_BITS * (unsigned char)cByte);
+        uMask |= SymTable_packHighBits((ullDiff - LOW_BITS) & ~ullDiff & HIGH_BITS) << i;
+    }
+    return uMask;
+}
+
+/* Return a bit mask with bit i set for each i < GROUP_WIDTH such that
+   pcGroup[i] is CTRL_EMPTY or CTRL_DELETED, that is, not full. */
+static unsigned SymTable_matchFree(const signed char *pcGroup)
+{
+    const unsigned long long HIGH_BITS = 0x8080808080808080ULL;
+    unsigned uMask = 0;
+    int i;
+    for (i = 0; i < GROUP_WIDTH; i += 8)
+        uMask |= SymTable_packHighBits(SymTable_loadWord(pcGroup + i) & HIGH_BITS) << i;
+    return uMask;
+}
+
+#endif
+
+/* Return the index of the lowest set bit of the nonzero mask uMask. */
+static int SymTable_lowestBit(unsigned uMask)
+{
+#ifdef __GNUC__
+    assert(uMask != 0);
+    return __builtin_ctz(uMask);
+#else
+    int i = 0;
+    assert(uMask != 0);
+    while ((uMask & 1u) == 0) {uMask >>= 1; i++;}
+    return i;
+#endif
+}
+
+/* Return the index of the first group probed for a key with full hash
+   uHash in a table of capacity slots. */
+static size_t SymTable_firstGroup(size_t uHash, size_t capacity)
+{
+    return (uHash >> 7) & (capacity / GROUP_WIDTH - 1);
+}
+
+/* Return 1 if the stored key pcStored equals the uLength characters at
+   pcKey, or 0 otherwise. pcKey need not be NUL-terminated. A stored key
+   at the address pcKey itself (an interned key) matches without
+   comparing characters. */
+static int SymTable_keyEquals(const char *pcStored, const char *pcKey, size_t uLength)
+{
+    if (pcStored == pcKey) {return pcStored[uLength] == '\0';}
+    return strncmp(pcStored, pcKey, uLength) == 0 && pcStored[uLength] == '\0';
+}
+
+/* Return the slot index of the binding of oSymTable whose key is the
+   uLength characters at pcKey, where uHash is their full hash, or
+   capacity if there is none.
+   Groups are probed in triangular order, which visits every group of a
+   power-of-two table, until one containing an empty slot is reached. */
+static size_t SymTable_find(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+                            size_t uHash)
+{
+    size_t group_mask = oSymTable->capacity / GROUP_WIDTH - 1;
+    size_t group = SymTable_firstGroup(uHash, oSymTable->capacity);
+    signed char tag = SymTable_tag(uHash);
+    const signed char *pcGroup;
+    unsigned match;
+    size_t index;
+    size_t step;
+    size_t uProbes = 0;
+
+    for (step = 1; step <= group_mask + 1; step++)
+    {
+        SymTableStats_probe(uProbes);
+        pcGroup = oSymTable->ctrl + group * GROUP_WIDTH;
+        for (match = SymTable_matchByte(pcGroup, tag); match != 0; match &= match - 1)
+        {
+            index = group * GROUP_WIDTH + (size_t)SymTable_lowestBit(match);
+            if (oSymTable->slots[index].hash == uHash
+                && SymTable_keyEquals(SymTable_slotKey(&oSymTable->slots[index]), pcKey, uLength))
+            {
+                SymTableStats_lookup(&oSymTable->stats, uProbes, 1);
+                return index;
+            }
+        }
+        if (SymTable_matchByte(pcGroup, CTRL_EMPTY) != 0) {break;}
+        group = (group + step) & group_mask;
+    }
+    SymTableStats_lookup(&oSymTable->stats, uProbes, 0);
+    return oSymTable->capacity;
+}
+
+/* Return the index of the first empty or deleted slot in the probe
+   sequence of a key with full hash uHash in the given control array of
+   capacity slots. One always exists because the load factor is below 1. */
+static size_t SymTable_findFree(const signed char *ctrl, size_t capacity, size_t uHash)
+{
+    size_t group_mask = capacity / GROUP_WIDTH - 1;
+    size_t group = SymTable_firstGroup(uHash, capacity);
+    unsigned match;
+    size_t step;
+
+    for (step = 1; ; step++)
+    {
+        match = SymTable_matchFree(ctrl + group * GROUP_WIDTH);
+        if (match != 0)
+            return group * GROUP_WIDTH + (size_t)SymTable_lowestBit(match);
+        group = (group + step) & group_mask;
+    }
+}
+
+/* Recompute the used slot count at which oSymTable rehashes, and the
+   length below which it shrinks, from its current capacity and maximum
+   load factor. A table shrinks once it is a quarter as full as it may
+   be, and then only to about two thirds full, so that alternating puts
+   and removes never rehash it back and forth. */
+static void SymTable_setGrowAt(SymTable_T oSymTable)
+{
+    double limit = oSymTable->maxLoad * (double)oSymTable->capacity;
+    assert(oSymTable != NULL);
+    if (limit >= (double)(oSymTable->capacity - 1)) {oSymTable->growAt = oSymTable->capacity - 1;}
+    else if (limit < 1.0) {oSymTable->growAt = 1;}
+    else {oSymTable->growAt = (size_t)limit;}
+    oSymTable->shrinkAt = oSymTable->capacity > INITIAL_CAPACITY ? oSymTable->growAt / 4 : 0;
+}
+
+/* Return the smallest power-of-two capacity, at least INITIAL_CAPACITY,
+   at which oSymTable holds uCount bindings within its maximum load
+   factor, or the largest capacity whose slots can be allocated. */
+static size_t SymTable_capacityFor(SymTable_T oSymTable, size_t uCount)
+{
+    size_t capacity = INITIAL_CAPACITY;
+
+    while (oSymTable->maxLoad * (double)capacity < (double)uCount
+           && capacity <= ((size_t)-1 / sizeof(struct Slot)) / 2)
+        capacity *= 2;
+    return capacity;
+}
+
+/* Rehash oSymTable into new arrays of capacity slots, dropping all
+   tombstones. Keys are moved, not copied. Return 1 on success, or 0 if
+   memory is exhausted, in which case oSymTable is unchanged. */
+static int SymTable_rehash(SymTable_T oSymTable, size_t capacity)
+{
+    signed char *old_ctrl = oSymTable->ctrl;
+    struct Slot *old_slots = oSymTable->slots;
+    signed char *new_ctrl;
+    struct Slot *new_slots;
+    size_t index;
+    size_t i;
+#ifdef SYMTABLE_HYBRID
+    signed char saved_ctrl[INITIAL_CAPACITY];
+    struct Slot saved_slots[INITIAL_CAPACITY];
+#endif
+
+    assert(capacity % GROUP_WIDTH == 0);
+
+    SymTableStats_startResize(&oSymTable->stats);
+#ifdef SYMTABLE_HYBRID
+    if (capacity == INITIAL_CAPACITY)
+    {
+        /* Rehashing the inline arrays in place: copy them aside first. */
+        if (SymTable_isInline(oSymTable, old_ctrl))
+        {
+            memcpy(saved_ctrl, old_ctrl, sizeof(saved_ctrl));
+            memcpy(saved_slots, old_slots, sizeof(saved_slots));
+            old_ctrl = saved_ctrl;
+            old_slots = saved_slots;
+        }
+        new_ctrl = oSymTable->inlineCtrl;
+        new_slots = oSymTable->inlineSlots;
+    }
+    else
+#endif
+    {
+        new_ctrl = (signed char *) malloc(capacity);
+        new_slots = (struct Slot *) malloc(capacity * sizeof(*new_slots));
+        if (new_ctrl == NULL || new_slots == NULL)
+        {
+            free(new_ctrl);
+            free(new_slots);
+            SymTableStats_stopResize(&oSymTable->stats);
+            return 0;
+        }
+    }
+    memset(new_ctrl, CTRL_EMPTY, capacity);
+
+    for (i = 0; i < oSymTable->capacity; i++)
+    {
+        if (old_ctrl[i] < 0) {continue;}
+        index = SymTable_findFree(new_ctrl, capacity, old_slots[i].hash);
+        new_ctrl[index] = old_ctrl[i];
+        new_slots[index] = old_slots[i];
+    }
+    if (!SymTable_isInline(oSymTable, oSymTable->ctrl))
+    {
+        free(oSymTable->ctrl);
+        free(oSymTable->slots);
+    }
+
+    oSymTable->ctrl = new_ctrl;
+    oSymTable->slots = new_slots;
+    oSymTable->capacity = capacity;
+    oSymTable->tombstones = 0;
+    SymTable_setGrowAt(oSymTable);
+    ++(oSymTable->resizes);
+    SymTableStats_stopResize(&oSymTable->stats);
+    return 1;
+}
+
+/* Create a new symbol table that hashes keys with eHashFunction and
+   return a pointer to it. The table is initially empty and has
+   INITIAL_CAPACITY slots. */
+SymTable_T SymTable_newWithHash(enum SymTable_HashFunction eHashFunction)
+{
+    struct SymTable *pSymtable;
+
+    pSymtable = (struct SymTable *) calloc(1, sizeof(*pSymtable));
+    if (pSymtable == NULL) {return NULL;}
+#ifdef SYMTABLE_HYBRID
+    pSymtable->ctrl = pSymtable->inlineCtrl;
+    pSymtable->slots = pSymtable->inlineSlots;
+#else
+    pSymtable->ctrl = (signed char *) malloc(INITIAL_CAPACITY);
+    pSymtable->slots = (struct Slot *) malloc(INITIAL_CAPACITY * sizeof(struct Slot));
+    if (pSymtable->ctrl == NULL || pSymtable->slots == NULL)
+    {
+        free(pSymtable->ctrl);
+        free(pSymtable->slots);
+        free(pSymtable);
+        return NULL;
+    }
+#endif
+    memset(pSymtable->ctrl, CTRL_EMPTY, INITIAL_CAPACITY);
+    pSymtable->capacity = INITIAL_CAPACITY;
+    pSymtable->len = 0;
+    pSymtable->tombstones = 0;
+    pSymtable->maxLoad = SYMTABLE_MAX_LOAD_FACTOR;
+    pSymtable->resizes = 0;
+    pSymtable->hashFunction = eHashFunction;
+    if (eHashFunction == SYMTABLE_HASH_KEYED) {SymTableHashFn_processKey(pSymtable->sipKey);}
+    SymTable_setGrowAt(pSymtable);
+    SymTableTrace_created(pSymtable);
+    return pSymtable;
+}
+
+/* Create a new symbol table that hashes keys with the legacy hash
+   function and return a pointer to it. */
+SymTable_T SymTable_new(void)
+{
+    return SymTable_newWithHash(SYMTABLE_HASH_LEGACY);
+}
+
+/* Free all memory associated with the symbol table oSymTable,
+   including all bindings and the table structure itself. */
+void SymTable_free(SymTable_T oSymTable)
+{
+    size_t i;
+
+    assert(oSymTable != NULL);
+
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_FREE, NULL, 0);
+    for (i = 0; i < oSymTable->capacity; i++)
+    {
+        if (oSymTable->ctrl[i] >= 0) {SymTable_freeSlotKey(&oSymTable->slots[i]);}
+    }
+    if (!SymTable_isInline(oSymTable, oSymTable->ctrl))
+    {
+        free(oSymTable->ctrl);
+        free(oSymTable->slots);
+    }
+    free(oSymTable);
+}
+
+/* Return the number of key-value bindings stored in the symbol table oSymTable. */
+size_t SymTable_getLength(SymTable_T oSymTable)
+{
+    assert(oSymTable != NULL);
+
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_LENGTH, NULL, 0);
+    return oSymTable->len;
+}
+
+/* Insert a new binding with key pcKey, of length key_len and full hash
+   hash_value, and value pvValue into oSymTable, rehashing first if
+   needed. The caller has checked that pcKey is absent. If iShared, the
+   slot stores the pointer pcKey instead of a copy. Returns a pointer to
+   the new slot's value, or NULL if memory is exhausted. */
+static const void **SymTable_insert(SymTable_T oSymTable, const char *pcKey, size_t key_len,
+                                    size_t hash_value, const void *pvValue, int iShared)
+{
+    size_t capacity;
+    size_t index;
+
+    /* Rehash when live plus deleted slots reach the limit: into twice the
+       slots if most are live, or in place if tombstones are to blame. */
+    if (oSymTable->len + oSymTable->tombstones >= oSymTable->growAt)
+    {
+        capacity = oSymTable->capacity;
+        if (oSymTable->len >= oSymTable->growAt / 2
+            && capacity <= ((size_t)-1 / sizeof(struct Slot)) / 2)
+            capacity *= 2;
+        if (!SymTable_rehash(oSymTable, capacity)
+            && oSymTable->len + oSymTable->tombstones >= oSymTable->capacity - 1)
+            return NULL;
+    }
+
+    index = SymTable_findFree(oSymTable->ctrl, oSymTable->capacity, hash_value);
+    if (!SymTable_setSlotKey(&oSymTable->slots[index], pcKey, key_len, iShared)) {return NULL;}
+    if (oSymTable->ctrl[index] == CTRL_DELETED) {--(oSymTable->tombstones);}
+    oSymTable->ctrl[index] = SymTable_tag(hash_value);
+    oSymTable->slots[index].value = pvValue;
+    oSymTable->slots[index].hash = hash_value;
+    ++(oSymTable->len);
+    return &oSymTable->slots[index].value;
+}
+
+/* Insert a new binding with key pcKey and value pvValue into the symbol table oSymTable.
+   If pcKey already exists in oSymTable, the function does nothing and returns 0.
+   Returns 1 on successful insertion. */
+int SymTable_put(SymTable_T oSymTable, const char *pcKey, const void *pvValue)
+{
+    size_t hash_value;
+    size_t key_len;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    hash_value = SymTable_hash(oSymTable, pcKey, &key_len);
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_PUT, pcKey, key_len);
+    if (SymTable_find(oSymTable, pcKey, key_len, hash_value) != oSymTable->capacity) {return 0;}
+    return SymTable_insert(oSymTable, pcKey, key_len, hash_value, pvValue, 0) != NULL;
+}
+
+/* Replace the value associated with pcKey in the symbol table oSymTable with pvValue.
+   Returns the old value associated with pcKey if it exists, otherwise returns NULL. */
+void *SymTable_replace(SymTable_T oSymTable, const char *pcKey, const void *pvValue)
+{
+    size_t index;
+    size_t hash_value;
+    size_t key_len;
+    const void *temp;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    hash_value = SymTable_hash(oSymTable, pcKey, &key_len);
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_REPLACE, pcKey, key_len);
+    index = SymTable_find(oSymTable, pcKey, key_len, hash_value);
+    if (index == oSymTable->capacity) {return NULL;}
+
+    temp = oSymTable->slots[index].value;
+    oSymTable->slots[index].value = pvValue;
+    return (void *) temp;
+}
+
+/* Check if the symbol table oSymTable contains a binding for pcKey.
+   Returns 1 if pcKey is found, 0 otherwise. */
+int SymTable_contains(SymTable_T oSymTable, const char *pcKey)
+{
+    size_t hash_value;
+    size_t key_len;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    hash_value = SymTable_hash(oSymTable, pcKey, &key_len);
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_CONTAINS, pcKey, key_len);
+    return SymTable_find(oSymTable, pcKey, key_len, hash_value) != oSymTable->capacity;
+}
+
+/* Retrieve the value associated with pcKey in the symbol table oSymTable.
+   Returns NULL if pcKey is not found. */
+void *SymTable_get(SymTable_T oSymTable, const char *pcKey)
+{
+    size_t index;
+    size_t hash_value;
+    size_t key_len;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    hash_value = SymTable_hash(oSymTable, pcKey, &key_len);
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_GET, pcKey, key_len);
+    index = SymTable_find(oSymTable, pcKey, key_len, hash_value);
+    if (index == oSymTable->capacity) {return NULL;}
+    return (void *) oSymTable->slots[index].value;
+}
+
+/* Remove the binding in the full slot index of oSymTable and return its
+   value. Rehash oSymTable into fewer slots if it has become too sparse. */
+static void *SymTable_removeAt(SymTable_T oSymTable, size_t index)
+{
+    const signed char *pcGroup;
+    const void *temp;
+    size_t capacity;
+
+    /* A group that still has an empty slot never made a probe move on, so
+       the slot can become empty again; otherwise it must stay a tombstone. */
+    pcGroup = oSymTable->ctrl + index / GROUP_WIDTH * GROUP_WIDTH;
+    if (SymTable_matchByte(pcGroup, CTRL_EMPTY) != 0) {oSymTable->ctrl[index] = CTRL_EMPTY;}
+    else {oSymTable->ctrl[index] = CTRL_DELETED; ++(oSymTable->tombstones);}
+
+    temp = oSymTable->slots[index].value;
+    SymTable_freeSlotKey(&oSymTable->slots[index]);
+    --(oSymTable->len);
+
+    /* Shrink to at most two thirds full, leaving room to grow back
+       before rehashing. */
+    if (oSymTable->len < oSymTable->shrinkAt)
+    {
+        capacity = SymTable_capacityFor(oSymTable, oSymTable->len + oSymTable->len / 2);
+        if (capacity < oSymTable->capacity) {SymTable_rehash(oSymTable, capacity);}
+    }
+    return (void *) temp;
+}
+
+/* Remove the binding for pcKey from the symbol table oSymTable, freeing its memory.
+   Returns the value associated with pcKey, or NULL if pcKey is not found. */
+void *SymTable_remove(SymTable_T oSymTable, const char *pcKey)
+{
+    size_t index;
+    size_t hash_value;
+    size_t key_len;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    hash_value = SymTable_hash(oSymTable, pcKey, &key_len);
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_REMOVE, pcKey, key_len);
+    index = SymTable_find(oSymTable, pcKey, key_len, hash_value);
+    if (index == oSymTable->capacity) {return NULL;}
+    return SymTable_removeAt(oSymTable, index);
+}
+
+/* Apply the function pfApply to each binding in the symbol table oSymTable,
+   passing pcKey, pvValue, and pvExtra as arguments. */
+void SymTable_map(SymTable_T oSymTable, void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra), const void *pvExtra)
+{
+    size_t i;
+
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_MAP, NULL, 0);
+    for (i = 0; i < oSymTable->capacity; i++)
+    {
+        if (oSymTable->ctrl[i] >= 0)
+            (*pfApply)(SymTable_slotKey(&oSymTable->slots[i]), (void *) oSymTable->slots[i].value, (void *) pvExtra);
+    }
+}
+
+/* Apply pfApply to each binding of oSymTable in slot order until it
+   returns nonzero, and return that value, or 0 if it never does. */
+int SymTable_mapUntil(SymTable_T oSymTable,
+                      int (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+                      const void *pvExtra)
+{
+    size_t i;
+    int iResult;
+
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    for (i = 0; i < oSymTable->capacity; i++)
+    {
+        if (oSymTable->ctrl[i] < 0) {continue;}
+        iResult = (*pfApply)(SymTable_slotKey(&oSymTable->slots[i]),
+                             (void *) oSymTable->slots[i].value, (void *) pvExtra);
+        if (iResult != 0) {return iResult;}
+    }
+    return 0;
+}
+
+/* Start a traversal of oSymTable in *psIter at slot 0. */
+void SymTable_iterBegin(SymTable_T oSymTable, struct SymTable_Iter *psIter)
+{
+    assert(oSymTable != NULL);
+    assert(psIter != NULL);
+
+    psIter->pvNext = NULL;
+    psIter->uIndex = 0;
+}
+
+/* Store the key and value of the first full slot at or after the one
+   *psIter has reached in *ppcKey and *ppvValue, unless they are NULL,
+   and move *psIter past it. Returns 1, or 0 if no full slot is left. */
+int SymTable_iterNext(SymTable_T oSymTable, struct SymTable_Iter *psIter,
+                      const char **ppcKey, void **ppvValue)
+{
+    size_t i;
+
+    assert(oSymTable != NULL);
+    assert(psIter != NULL);
+
+    for (i = psIter->uIndex; i < oSymTable->capacity && oSymTable->ctrl[i] < 0; i++)
+        ;
+    psIter->uIndex = i;
+    if (i == oSymTable->capacity) {return 0;}
+
+    if (ppcKey != NULL) {*ppcKey = SymTable_slotKey(&oSymTable->slots[i]);}
+    if (ppvValue != NULL) {*ppvValue = (void *) oSymTable->slots[i].value;}
+    ++(psIter->uIndex);
+    return 1;
+}
+
+/* Apply psVisit to each binding in slots uBegin up to uEnd of the
+   SymTable pvSymTable. The parallel traversals give each thread such
+   slices of the slot array. */
+static void SymTable_walkSlots(const void *pvSymTable, size_t uBegin, size_t uEnd,
+                               const struct SymTableParallel_Visit *psVisit)
+{
+    const struct SymTable *oSymTable = (const struct SymTable *) pvSymTable;
+    size_t i;
+
+    for (i = uBegin; i < uEnd; i++)
+    {
+        if (oSymTable->ctrl[i] < 0) {continue;}
+        (*psVisit->pfApply)(SymTable_slotKey(&oSymTable->slots[i]), (void *) oSymTable->slots[i].value,
+                            psVisit->pvAccumulator, psVisit->pvExtra);
+    }
+}
+
+/* Apply pfApply to each binding of oSymTable from up to uThreadCount
+   threads, which share out the slot array. */
+void SymTable_mapParallel(SymTable_T oSymTable,
+                          void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+                          const void *pvExtra, size_t uThreadCount)
+{
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    SymTableParallel_map(oSymTable, oSymTable->capacity, SymTable_walkSlots, pfApply, pvExtra,
+                         uThreadCount);
+}
+
+/* Like SymTable_mapParallel, but with an accumulator per thread that is
+   merged into *pvResult at the end. */
+void SymTable_mapReduce(SymTable_T oSymTable,
+                        void (*pfApply)(const char *pcKey, void *pvValue,
+                                        void *pvAccumulator, void *pvExtra),
+                        void (*pfMerge)(void *pvResult, const void *pvAccumulator, void *pvExtra),
+                        size_t uAccumulatorSize, void *pvResult, const void *pvExtra,
+                        size_t uThreadCount)
+{
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    SymTableParallel_reduce(oSymTable, oSymTable->capacity, SymTable_walkSlots, pfApply, pfMerge,
+                            uAccumulatorSize, pvResult, pvExtra, uThreadCount);
+}
+
+/* Set the maximum load factor of oSymTable to dMaxLoadFactor. The table
+   rehashes on the next put once its live plus deleted slots reach
+   dMaxLoadFactor times its capacity. Returns 1 on success, or 0 if
+   dMaxLoadFactor is not positive or not below 1. */
+int SymTable_setMaxLoadFactor(SymTable_T oSymTable, double dMaxLoadFactor)
+{
+    assert(oSymTable != NULL);
+    if (!(dMaxLoadFactor > 0.0) || dMaxLoadFactor >= 1.0) {return 0;}
+    oSymTable->maxLoad = dMaxLoadFactor;
+    SymTable_setGrowAt(oSymTable);
+    return 1;
+}
+
+/* Rehash oSymTable into the capacity at which it holds uCount bindings,
+   unless it already has that many slots. Returns 1 on success, or 0 if
+   memory is exhausted. */
+int SymTable_reserve(SymTable_T oSymTable, size_t uCount)
+{
+    size_t capacity;
+
+    assert(oSymTable != NULL);
+
+    capacity = SymTable_capacityFor(oSymTable, uCount);
+    if (capacity <= oSymTable->capacity) {return 1;}
+    return SymTable_rehash(oSymTable, capacity);
+}
+
+/* Rehash oSymTable into the smallest capacity at which it holds its
+   current bindings, dropping all tombstones even if the capacity stays
+   the same. */
+void SymTable_shrinkToFit(SymTable_T oSymTable)
+{
+    size_t capacity;
+
+    assert(oSymTable != NULL);
+
+    capacity = SymTable_capacityFor(oSymTable, oSymTable->len);
+    if (capacity > oSymTable->capacity) {capacity = oSymTable->capacity;}
+    if (capacity < oSymTable->capacity || oSymTable->tombstones != 0)
+        SymTable_rehash(oSymTable, capacity);
+}
+
+/* An open-addressing table must rehash every slot before probing the
+   new array, so it always resizes at once. Returns 1 if iEnabled is 0,
+   or 0 otherwise. */
+int SymTable_setIncrementalResize(SymTable_T oSymTable, int iEnabled)
+{
+    assert(oSymTable != NULL);
+    return !iEnabled;
+}
+
+/* An open-addressing table must keep every key at its probe position,
+   so it cannot reorder. Returns 1 if eReorder is SYMTABLE_REORDER_NONE,
+   or 0 otherwise. */
+int SymTable_setReorder(SymTable_T oSymTable, enum SymTable_Reorder eReorder)
+{
+    assert(oSymTable != NULL);
+    return eReorder == SYMTABLE_REORDER_NONE;
+}
+
+#ifdef SYMTABLE_STATS
+/* Return the number of groups that the full slot index of oSymTable
+   lies past the first group of its key's probe sequence. */
+static size_t SymTable_displacement(SymTable_T oSymTable, size_t index)
+{
+    size_t group_mask = oSymTable->capacity / GROUP_WIDTH - 1;
+    size_t group = SymTable_firstGroup(oSymTable->slots[index].hash, oSymTable->capacity);
+    size_t step;
+
+    for (step = 0; group != index / GROUP_WIDTH; step++)
+        group = (group + step + 1) & group_mask;
+    return step;
+}
+#endif
+
+/* Fill *psStats with the current state of the growth policy of
+   oSymTable, counting each slot as a bucket. In a build with
+   SYMTABLE_STATS, also report its counters, the displacement of each
+   binding, and the memory held by its arrays and heap keys. */
+void SymTable_getStats(SymTable_T oSymTable, struct SymTable_Stats *psStats)
+{
+#ifdef SYMTABLE_STATS
+    size_t i;
+#endif
+
+    assert(oSymTable != NULL);
+    assert(psStats != NULL);
+
+    psStats->uLength = oSymTable->len;
+    psStats->uBucketCount = oSymTable->capacity;
+    psStats->uGrowAt = oSymTable->growAt > oSymTable->tombstones
+        ? oSymTable->growAt - oSymTable->tombstones : 0;
+    psStats->uShrinkAt = oSymTable->shrinkAt;
+    psStats->uResizeCount = oSymTable->resizes;
+    psStats->dLoadFactor = (double)oSymTable->len / (double)oSymTable->capacity;
+    psStats->dMaxLoadFactor = oSymTable->maxLoad;
+
+    SymTableStats_clear(psStats);
+#ifdef SYMTABLE_STATS
+    SymTableStats_report(&oSymTable->stats, psStats);
+    psStats->uBytesAllocated = sizeof(*oSymTable);
+    if (!SymTable_isInline(oSymTable, oSymTable->ctrl))
+        psStats->uBytesAllocated += oSymTable->capacity * (1 + sizeof(struct Slot));
+    for (i = 0; i < oSymTable->capacity; i++)
+    {
+        if (oSymTable->ctrl[i] < 0) {continue;}
+        SymTableStats_addChain(psStats, SymTable_displacement(oSymTable, i));
+        if (oSymTable->slots[i].key.inline_key[INLINE_KEY_SIZE - 1] == KEY_HEAP)
+            psStats->uBytesAllocated += strlen(oSymTable->slots[i].key.heap_key) + 1;
+    }
+#endif
+}
+
+/* Insert a new binding with the interned key pcInterned and value pvValue
+   into oSymTable, sharing the intern pool's copy of the key. If the key
+   already exists, does nothing and returns 0. Returns 1 on success. */
+int SymTable_putInterned(SymTable_T oSymTable, const char *pcInterned, const void *pvValue)
+{
+    size_t hash_value;
+
+    assert(oSymTable != NULL);
+    assert(pcInterned != NULL);
+
+    hash_value = SymTable_internedHash(oSymTable, pcInterned);
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_PUT, pcInterned,
+                         SymTableIntern_length(pcInterned));
+    if (SymTable_find(oSymTable, pcInterned, SymTableIntern_length(pcInterned), hash_value)
+        != oSymTable->capacity) {return 0;}
+    return SymTable_insert(oSymTable, pcInterned, 0, hash_value, pvValue, 1) != NULL;
+}
+
+/* Retrieve the value associated with the interned key pcInterned in
+   oSymTable, mixing the hash the intern pool stored for it instead of
+   rehashing the string. Returns NULL if the key is not found. */
+void *SymTable_getInterned(SymTable_T oSymTable, const char *pcInterned)
+{
+    size_t index;
+
+    assert(oSymTable != NULL);
+    assert(pcInterned != NULL);
+
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_GET, pcInterned,
+                         SymTableIntern_length(pcInterned));
+    index = SymTable_find(oSymTable, pcInterned, SymTableIntern_length(pcInterned),
+                          SymTable_internedHash(oSymTable, pcInterned));
+    if (index == oSymTable->capacity) {return NULL;}
+    return (void *) oSymTable->slots[index].value;
+}
+
+/* Insert a new binding whose key is the uLength characters at pcKey,
+   with full hash uHash from SymTable_hashKey, and value pvValue into
+   oSymTable. If the key already exists, does nothing and returns 0.
+   Returns 1 on success. */
+int SymTable_putHashed(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+                       size_t uHash, const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_PUT, pcKey, uLength);
+    if (SymTable_find(oSymTable, pcKey, uLength, uHash) != oSymTable->capacity) {return 0;}
+    return SymTable_insert(oSymTable, pcKey, uLength, uHash, pvValue, 0) != NULL;
+}
+
+/* Retrieve the value associated with the uLength characters at pcKey,
+   whose full hash uHash came from SymTable_hashKey, in oSymTable.
+   Returns NULL if the key is not found. */
+void *SymTable_getHashed(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+                         size_t uHash)
+{
+    size_t index;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_GET, pcKey, uLength);
+    index = SymTable_find(oSymTable, pcKey, uLength, uHash);
+    if (index == oSymTable->capacity) {return NULL;}
+    return (void *) oSymTable->slots[index].value;
+}
+
+/* Insert a new binding whose key is the uLength characters at pcKey and
+   whose value is pvValue into oSymTable. If the key already exists,
+   does nothing and returns 0. Returns 1 on success. */
+int SymTable_putN(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+                  const void *pvValue)
+{
+    return SymTable_putHashed(oSymTable, pcKey, uLength,
+                              SymTable_hashKey(oSymTable, pcKey, uLength), pvValue);
+}
+
+/* Retrieve the value associated with the uLength characters at pcKey in
+   oSymTable. Returns NULL if the key is not found. */
+void *SymTable_getN(SymTable_T oSymTable, const char *pcKey, size_t uLength)
+{
+    return SymTable_getHashed(oSymTable, pcKey, uLength,
+                              SymTable_hashKey(oSymTable, pcKey, uLength));
+}
+
+/* Return a pointer to the value of the binding of oSymTable whose key is
+   pcKey, first inserting a binding with value pvValue if there is none.
+   Set *piCreated, if piCreated is not NULL, to 1 if a binding was
+   inserted and to 0 otherwise. The key is hashed and probed for once.
+   Returns NULL if memory is exhausted. */
+const void **SymTable_getOrPut(SymTable_T oSymTable, const char *pcKey,
+                               const void *pvValue, int *piCreated)
+{
+    size_t hash_value;
+    size_t key_len;
+    size_t index;
+    const void **ppvValue;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    hash_value = SymTable_hash(oSymTable, pcKey, &key_len);
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_GET_OR_PUT, pcKey, key_len);
+    index = SymTable_find(oSymTable, pcKey, key_len, hash_value);
+    if (piCreated != NULL) {*piCreated = 0;}
+    if (index != oSymTable->capacity) {return &oSymTable->slots[index].value;}
+    ppvValue = SymTable_insert(oSymTable, pcKey, key_len, hash_value, pvValue, 0);
+    if (piCreated != NULL) {*piCreated = ppvValue != NULL;}
+    return ppvValue;
+}
+
+/* Hash the uCount keys at ppcKeys into auHashes and auLengths, and
+   prefetch the control bytes and slots of each key's first group, so
+   that by the time the keys are resolved in order their groups are
+   already in cache. */
+static void SymTable_prefetchBatch(SymTable_T oSymTable, const char *const *ppcKeys,
+                                   size_t uCount, size_t *auHashes, size_t *auLengths)
+{
+    size_t u;
+    size_t group;
+
+    for (u = 0; u < uCount; u++)
+    {
+        assert(ppcKeys[u] != NULL);
+        auHashes[u] = SymTable_hash(oSymTable, ppcKeys[u], &auLengths[u]);
+        group = SymTable_firstGroup(auHashes[u], oSymTable->capacity);
+        SymTable_prefetch(oSymTable->ctrl + group * GROUP_WIDTH);
+        SymTable_prefetch(oSymTable->slots + group * GROUP_WIDTH);
+    }
+}
+
+/* Store in ppvValues[i] the value associated with ppcKeys[i] in
+   oSymTable, or NULL if it is absent, for each i below uCount. Keys are
+   hashed and their groups prefetched BATCH_CHUNK at a time. */
+void SymTable_getBatch(SymTable_T oSymTable, const char *const *ppcKeys,
+                       size_t uCount, void **ppvValues)
+{
+    size_t auHashes[BATCH_CHUNK];
+    size_t auLengths[BATCH_CHUNK];
+    size_t uDone;
+    size_t uChunk;
+    size_t u;
+    size_t index;
+
+    assert(oSymTable != NULL);
+    assert(ppcKeys != NULL || uCount == 0);
+    assert(ppvValues != NULL || uCount == 0);
+
+    for (uDone = 0; uDone < uCount; uDone += uChunk)
+    {
+        uChunk = uCount - uDone < BATCH_CHUNK ? uCount - uDone : BATCH_CHUNK;
+        SymTable_prefetchBatch(oSymTable, ppcKeys + uDone, uChunk, auHashes, auLengths);
+        for (u = 0; u < uChunk; u++)
+        {
+            SymTableTrace_record(oSymTable, SYMTABLETRACE_GET, ppcKeys[uDone + u], auLengths[u]);
+            index = SymTable_find(oSymTable, ppcKeys[uDone + u], auLengths[u], auHashes[u]);
+            ppvValues[uDone + u] = index == oSymTable->capacity
+                ? NULL : (void *) oSymTable->slots[index].value;
+        }
+    }
+}
+
+/* Put a binding of ppcKeys[i] to ppvValues[i] into oSymTable for each i
+   below uCount, in order, as SymTable_put would. If piResults is not
+   NULL, store SymTable_put's result for each key in piResults[i].
+   Returns the number of bindings inserted. */
+size_t SymTable_putBatch(SymTable_T oSymTable, const char *const *ppcKeys,
+                         const void *const *ppvValues, size_t uCount, int *piResults)
+{
+    size_t auHashes[BATCH_CHUNK];
+    size_t auLengths[BATCH_CHUNK];
+    size_t uDone;
+    size_t uChunk;
+    size_t u;
+    size_t uInserted = 0;
+    int iResult;
+
+    assert(oSymTable != NULL);
+    assert(ppcKeys != NULL || uCount == 0);
+    assert(ppvValues != NULL || uCount == 0);
+
+    for (uDone = 0; uDone < uCount; uDone += uChunk)
+    {
+        uChunk = uCount - uDone < BATCH_CHUNK ? uCount - uDone : BATCH_CHUNK;
+        SymTable_prefetchBatch(oSymTable, ppcKeys + uDone, uChunk, auHashes, auLengths);
+        for (u = 0; u < uChunk; u++)
+        {
+            SymTableTrace_record(oSymTable, SYMTABLETRACE_PUT, ppcKeys[uDone + u], auLengths[u]);
+            /* A rehash part way through only makes later prefetches useless. */
+            iResult = SymTable_find(oSymTable, ppcKeys[uDone + u], auLengths[u], auHashes[u])
+                    == oSymTable->capacity
+                && SymTable_insert(oSymTable, ppcKeys[uDone + u], auLengths[u], auHashes[u],
+                                   ppvValues[uDone + u], 0) != NULL;
+            if (piResults != NULL) {piResults[uDone + u] = iResult;}
+            uInserted += (size_t)iResult;
+        }
+    }
+    return uInserted;
+}
+
+/* Remove the binding for ppcKeys[i] from oSymTable for each i below
+   uCount, in order, and store the value it had, or NULL if it was
+   absent, in ppvValues[i] unless ppvValues is NULL. Returns the number
+   of bindings removed. */
+size_t SymTable_removeBatch(SymTable_T oSymTable, const char *const *ppcKeys,
+                            size_t uCount, void **ppvValues)
+{
+    size_t auHashes[BATCH_CHUNK];
+    size_t auLengths[BATCH_CHUNK];
+    size_t uDone;
+    size_t uChunk;
+    size_t u;
+    size_t index;
+    size_t uRemoved = 0;
+    void *pvValue;
+
+    assert(oSymTable != NULL);
+    assert(ppcKeys != NULL || uCount == 0);
+
+    for (uDone = 0; uDone < uCount; uDone += uChunk)
+    {
+        uChunk = uCount - uDone < BATCH_CHUNK ? uCount - uDone : BATCH_CHUNK;
+        SymTable_prefetchBatch(oSymTable, ppcKeys + uDone, uChunk, auHashes, auLengths);
+        for (u = 0; u < uChunk; u++)
+        {
+            SymTableTrace_record(oSymTable, SYMTABLETRACE_REMOVE, ppcKeys[uDone + u], auLengths[u]);
+            index = SymTable_find(oSymTable, ppcKeys[uDone + u], auLengths[u], auHashes[u]);
+            pvValue = NULL;
+            if (index != oSymTable->capacity)
+            {
+                pvValue = SymTable_removeAt(oSymTable, index);
+                ++uRemoved;
+            }
+            if (ppvValues != NULL) {ppvValues[uDone + u] = pvValue;}
+        }
+    }
+    return uRemoved;
+}
@@ -3,32 +3,134 @@
 /* Author: Chinmayi R                                                 */
 /*--------------------------------------------------------------------*/
 #include "symtable.h"
+#include "symtablearena.h"
+#include "symtableintern.h"
+#include "symtablehashfn.h"
+#include "symtableparallel.h"
+#include "symtablestats.h"
+#include "symtabletrace.h"
+
+/* Size of the key buffer inside each binding. Keys shorter than this are
+   stored in the binding itself; longer keys are stored in the arena. */
+enum {INLINE_KEY_SIZE = 24};
+
+/* Values of the last byte of a binding's inline_key when its key is at
+   long_key: KEY_ARENA if the binding owns that copy in the arena, or
+   KEY_SHARED if it belongs to the caller or the intern pool. */
+enum {KEY_ARENA = 1, KEY_SHARED = 2};
+
+/* Bucket indexing. By default bucket counts are primes and a hash is
+   reduced to a bucket index with %, which costs an integer division on
+   every lookup. Build with -DSYMTABLE_POW2_BUCKETS to make bucket counts
+   powers of two and reduce with a mask instead; the legacy hash is then
+   finished with SymTable_mix so that its low bits depend on every
+   character. */
+#ifdef SYMTABLE_POW2_BUCKETS
+#define SymTable_bucketIndex(uHash, size) ((uHash) & ((size) - 1))
+#else
+#define SymTable_bucketIndex(uHash, size) ((uHash) % (size))
+#endif
 
 /* Global variable storing list of possible bucket counts for hash table resizing */
+#ifdef SYMTABLE_POW2_BUCKETS
+static const size_t BUCKET_COUNT[] = {512, 1024, 2048, 4096, 8192, 16384, 32768, 65536};
+#else
 static const size_t BUCKET_COUNT[] = {509, 1021, 2039, 4093, 8191, 16381, 32749, 65521};
+#endif
+
+/* Number of entries in BUCKET_COUNT. Past the last entry, bucket counts
+   are computed primes of roughly twice the previous count. */
+enum {BUCKET_COUNT_LEN = sizeof(BUCKET_COUNT)/sizeof(BUCKET_COUNT[0])};
+
+/* Default maximum load factor (bindings per bucket) before a put grows
+   the table. Can be overridden at build time with -DSYMTABLE_MAX_LOAD_FACTOR
+   or per table with SymTable_setMaxLoadFactor. */
+#ifndef SYMTABLE_MAX_LOAD_FACTOR
+#define SYMTABLE_MAX_LOAD_FACTOR 1.0
+#endif
+
+/* Whether new tables spread each resize over the operations that follow
+   it (1) or relink every binding at once (0). Can be overridden at build
+   time with -DSYMTABLE_INCREMENTAL_RESIZE or per table with
+   SymTable_setIncrementalResize. */
+#ifndef SYMTABLE_INCREMENTAL_RESIZE
+#define SYMTABLE_INCREMENTAL_RESIZE 0
+#endif
+
+/* Number of keys of a batch that are hashed and prefetched together
+   before any of them is resolved. */
+enum {BATCH_CHUNK = 16};
+
+/* Number of old buckets that each put, get or remove moves into the new
+   bucket array while an incremental resize is in progress. Growth about
+   doubles the bucket count, so unless the maximum load factor is tiny a
+   resize finishes well before the table is due to grow again. */
+enum {MIGRATE_BUCKETS = 8};
+
+/* Number of buckets whose occupancy one bitmap word records. */
+enum {WORD_BITS = 8 * sizeof(unsigned long)};
+
+/* Number of words in the occupancy bitmap of size buckets. */
+#define SymTable_occupancyWords(size) (((size) + WORD_BITS - 1) / WORD_BITS)
+
+/* Hint that the memory at p will soon be read. */
+#ifdef __GNUC__
+#define SymTable_prefetch(p) __builtin_prefetch(p)
+#else
+#define SymTable_prefetch(p) ((void)(p))
+#endif
 
 /* A Binding_T object represents a single key-value pair within a symbol table. */
 typedef struct Binding Binding_T;
 /* Each binding contains:
-   - key: a unique string identifier for the binding.
+   - next: a pointer to the next binding in a linked list.
+   - hash: the full hash of key, before reduction to a bucket index.
    - value: a pointer to the associated data.
-   - next: a pointer to the next binding in a linked list. */
+   - key: a unique string identifier for the binding, either stored in
+     key.inline_key, or at key.long_key with the last byte of
+     key.inline_key set to KEY_ARENA or KEY_SHARED. */
 struct Binding {
-    /* Unique string identifier */
-    const char *key;
+    /* Pointer to next binding in linked list */
+    struct Binding *next;
+    
+    /* Full hash of key, compared before strcmp and reused on resize */
+    size_t hash;
     
     /* Pointer to associated data */
     const void *value;
     
-    /* Pointer to next binding in linked list */
-    struct Binding *next;
+    /* Unique string identifier, inline if short enough */
+    union {
+        char inline_key[INLINE_KEY_SIZE];
+        char *long_key;
+    } key;
 };
 
 /* A SymTable object represents a hash table with separate chaining.
    It contains:
-   - buckets: an array of pointers to binding lists.
+   - buckets: an array of pointers to binding lists, followed in the
+     same allocation by an occupancy bitmap with one bit per bucket,
+     set exactly when the bucket is not empty, so that traversals skip
+     empty buckets a word at a time.
    - size: the number of buckets in the hash table.
-   - len: the number of key-value bindings stored in the table. */
+   - len: the number of key-value bindings stored in the table.
+   - maxLoad: the maximum load factor allowed before growing.
+   - growAt: the value of len at which the next put grows the table.
+   - shrinkAt: the value of len below which a remove shrinks the table.
+   - resizes: the number of times the table has grown or shrunk.
+   - oldBuckets: during an incremental resize, the previous bucket
+     array, whose buckets below migrated are already empty; else NULL.
+   - oldSize: the number of buckets in oldBuckets.
+   - migrated: the number of buckets of oldBuckets moved so far.
+   - incremental: 1 if the table resizes incrementally, 0 if at once.
+   - hashFunction: the function that hashes keys.
+   - sipKey: the secret key of SYMTABLE_HASH_KEYED, a copy of the
+     process-wide key.
+   - arena: the per-table allocator for bindings and keys.
+   - stats: in a build with SYMTABLE_STATS, the instrumentation
+     counters.
+   - traceId: in a build with SYMTABLE_TRACE, the id of the table in
+     the trace. */
    struct SymTable {
     /* Array of binding list pointers */
     struct Binding **buckets;
@@ -38,121 +140,528 @@ struct Binding {
     
     /* Number of key-value bindings stored */
     size_t len;
+
+    /* Maximum load factor before growing */
+    double maxLoad;
+
+    /* Length at which the next put grows the table */
+    size_t growAt;
+
+    /* Length below which the next remove shrinks the table */
+    size_t shrinkAt;
+
+    /* Number of started resizes */
+    size_t resizes;
+
+    /* Bucket array being drained by an incremental resize, or NULL */
+    struct Binding **oldBuckets;
+
+    /* Number of buckets in oldBuckets */
+    size_t oldSize;
+
+    /* Number of buckets of oldBuckets already drained */
+    size_t migrated;
+
+    /* Whether resizes are spread over later operations */
+    int incremental;
+
+    /* Function that hashes keys */
+    enum SymTable_HashFunction hashFunction;
+
+    /* Secret key of the keyed hash function */
+    unsigned long long sipKey[2];
+
+    /* Slab of bindings and size-classed key storage */
+    struct SymTableArena arena;
+
+#ifdef SYMTABLE_STATS
+    /* Instrumentation counters */
+    struct SymTableStats stats;
+#endif
+
+#ifdef SYMTABLE_TRACE
+    /* Id of the table in the trace */
+    size_t traceId;
+#endif
 };
 
-/* Return a hash value for the string pcKey, using uBucketCount as 
-   the number of buckets. */
-static size_t SymTable_hash(const char *pcKey, size_t uBucketCount)
+/* Return the legacy hash uHash as the full hash of a binding: unchanged
+   for prime bucket counts, or passed through the 64-bit finalizer of
+   MurmurHash3 for power-of-two bucket counts. */
+static size_t SymTable_mix(size_t uHash)
+{
+#ifdef SYMTABLE_POW2_BUCKETS
+   unsigned long long ullHash = (unsigned long long)uHash;
+
+   ullHash ^= ullHash >> 33;
+   ullHash *= 0xff51afd7ed558ccdULL;
+   ullHash ^= ullHash >> 33;
+   ullHash *= 0xc4ceb9fe1a85ec53ULL;
+   ullHash ^= ullHash >> 33;
+   return (size_t)ullHash;
+#else
+   return uHash;
+#endif
+}
+
+/* Return the full hash value of the uLength characters at pcKey, as
+   computed by the hash function of oSymTable. */
+static size_t SymTable_hashBytes(SymTable_T oSymTable, const char *pcKey, size_t uLength)
+{
+   switch (oSymTable->hashFunction)
+   {
+      case SYMTABLE_HASH_WORD:
+         return SymTableHashFn_word(pcKey, uLength);
+      case SYMTABLE_HASH_KEYED:
+         return SymTableHashFn_sip(pcKey, uLength, oSymTable->sipKey);
+      default:
+         return SymTable_mix(SymTableHashFn_legacy(pcKey, uLength));
+   }
+}
+
+/* Return the full hash value of the string pcKey, and store the length
+   of pcKey in *puLength. Reduce it to a bucket index with
+   SymTable_bucketIndex. The legacy hash is computed in the same pass
+   that finds the length. */
+static size_t SymTable_hash(SymTable_T oSymTable, const char *pcKey, size_t *puLength)
 {
    const size_t HASH_MULTIPLIER = 65599;
    size_t u;
    size_t uHash = 0;
 
    assert(pcKey != NULL);
+   assert(puLength != NULL);
+
+   if (oSymTable->hashFunction != SYMTABLE_HASH_LEGACY)
+   {
+      *puLength = strlen(pcKey);
+      return SymTable_hashBytes(oSymTable, pcKey, *puLength);
+   }
 
    for (u = 0; pcKey[u] != '\0'; u++)
       uHash = uHash * HASH_MULTIPLIER + (size_t)pcKey[u];
 
-   return uHash % uBucketCount;
+   *puLength = u;
+   return SymTable_mix(uHash);
 }
 
-/* Free the memory associated with the Binding_T pointer pBinding, including
-   its key but not the value it points to. */
-static void SymTable_binding_free(Binding_T *pBinding){
+/* Return the full hash value of the uLength characters at pcKey, which
+   is the value SymTable_hash returns for the same characters. */
+size_t SymTable_hashKey(SymTable_T oSymTable, const char *pcKey, size_t uLength)
+{
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   return SymTable_hashBytes(oSymTable, pcKey, uLength);
+}
+
+/* Return the full hash value of pcInterned, a string from the intern
+   pool, reusing the hash the pool stored if the table hashes the same
+   way. */
+static size_t SymTable_internedHash(SymTable_T oSymTable, const char *pcInterned)
+{
+   if (oSymTable->hashFunction == SYMTABLE_HASH_LEGACY)
+      return SymTable_mix(SymTableIntern_hash(pcInterned));
+   return SymTable_hashBytes(oSymTable, pcInterned, SymTableIntern_length(pcInterned));
+}
+
+/* Return the key of the binding pBinding. */
+static const char *SymTable_bindingKey(const Binding_T *pBinding)
+{
     assert(pBinding != NULL);
-    free((char *)pBinding->key);
-    free(pBinding);
+    if (pBinding->key.inline_key[INLINE_KEY_SIZE - 1] == '\0')
+        return pBinding->key.inline_key;
+    return pBinding->key.long_key;
 }
 
-/* Resize the symbol table oSymTable to a new size, rehashing all elements 
-   and redistributing them into the new buckets based on size. */
-static void SymTable_resize(SymTable_T oSymTable, size_t size)
+/* Store pcKey, which has length uLength, in pBinding. If iShared, store
+   the pointer pcKey itself; otherwise store a copy, inline if it fits and
+   in the arena of oSymTable if not. Return 1 on success, or 0 if memory
+   is exhausted. */
+static int SymTable_setBindingKey(SymTable_T oSymTable, Binding_T *pBinding,
+                                  const char *pcKey, size_t uLength, int iShared)
 {
-    Binding_T **old_buckets;
-    Binding_T **new_buckets;
-    Binding_T *buckets_i;
-    Binding_T *next; 
-    size_t i;
+    char *long_key;
 
-    size_t old_size = oSymTable->size;
-    old_buckets = oSymTable->buckets;
-    new_buckets = (Binding_T **) calloc(size, sizeof(*new_buckets));
-    if(new_buckets == NULL) {return;}
+    assert(oSymTable != NULL);
+    assert(pBinding != NULL);
+    assert(pcKey != NULL);
 
-    oSymTable->buckets = new_buckets;
-    oSymTable->size = size;
-    oSymTable->len = 0; /* Since SymTable_put increments len when reinserting bindings*/
+    if (iShared)
+    {
+        pBinding->key.inline_key[INLINE_KEY_SIZE - 1] = KEY_SHARED;
+        pBinding->key.long_key = (char *)pcKey;
+        return 1;
+    }
+    if (uLength < INLINE_KEY_SIZE)
+    {
+        memset(pBinding->key.inline_key, 0, INLINE_KEY_SIZE);
+        memcpy(pBinding->key.inline_key, pcKey, uLength);
+        return 1;
+    }
+    long_key = SymTableArena_allocBytes(&oSymTable->arena, uLength + 1);
+    if (long_key == NULL) {return 0;}
+    memcpy(long_key, pcKey, uLength);
+    long_key[uLength] = '\0';
+    pBinding->key.inline_key[INLINE_KEY_SIZE - 1] = KEY_ARENA;
+    pBinding->key.long_key = long_key;
+    return 1;
+}
+
+/* Return 1 if the stored key pcStored equals the uLength characters at
+   pcKey, or 0 otherwise. pcKey need not be NUL-terminated. A stored key
+   at the address pcKey itself (an interned key) matches without
+   comparing characters. */
+static int SymTable_keyEquals(const char *pcStored, const char *pcKey, size_t uLength)
+{
+    if (pcStored == pcKey) {return pcStored[uLength] == '\0';}
+    return strncmp(pcStored, pcKey, uLength) == 0 && pcStored[uLength] == '\0';
+}
 
-	for (i = 0; i < old_size; i++) {
-        buckets_i = old_buckets[i];
-        while (buckets_i != NULL)
+/* Return the occupancy bitmap that follows the size buckets of
+   buckets. */
+static unsigned long *SymTable_occupancy(Binding_T **buckets, size_t size)
+{
+    return (unsigned long *)(void *)(buckets + size);
+}
+
+/* Bytes of an array of size buckets and their occupancy bitmap. */
+#define SymTable_bucketBytes(size) \
+    ((size) * sizeof(Binding_T *) + SymTable_occupancyWords(size) * sizeof(unsigned long))
+
+/* Return a new array of size empty buckets followed by their clear
+   occupancy bitmap, or NULL if memory is exhausted. */
+static Binding_T **SymTable_newBuckets(size_t size)
+{
+    size_t words = SymTable_occupancyWords(size);
+
+    if (size > ((size_t)-1 - words * sizeof(unsigned long)) / sizeof(Binding_T *)) {return NULL;}
+    return (Binding_T **) calloc(1, SymTable_bucketBytes(size));
+}
+
+/* Set the occupancy bit of bucket i of buckets, which has size buckets,
+   if the bucket holds a binding, or clear it if not. */
+static void SymTable_markBucket(Binding_T **buckets, size_t size, size_t i)
+{
+    unsigned long *occupancy = SymTable_occupancy(buckets, size);
+    unsigned long bit = 1UL << (i % WORD_BITS);
+
+    if (buckets[i] != NULL) {occupancy[i / WORD_BITS] |= bit;}
+    else {occupancy[i / WORD_BITS] &= ~bit;}
+}
+
+/* Return the index of the lowest set bit of the nonzero word ulWord. */
+static size_t SymTable_lowestBit(unsigned long ulWord)
+{
+#ifdef __GNUC__
+    assert(ulWord != 0);
+    return (size_t)__builtin_ctzl(ulWord);
+#else
+    size_t i = 0;
+    assert(ulWord != 0);
+    while ((ulWord & 1UL) == 0) {ulWord >>= 1; i++;}
+    return i;
+#endif
+}
+
+/* Return the index of the first nonempty bucket of buckets, which has
+   size buckets, at or after start and before end, or end if there is
+   none. */
+static size_t SymTable_nextOccupied(Binding_T **buckets, size_t size, size_t start, size_t end)
+{
+    const unsigned long *occupancy = SymTable_occupancy(buckets, size);
+    size_t word;
+    unsigned long bits;
+
+    assert(end <= size);
+    if (start >= end) {return end;}
+    word = start / WORD_BITS;
+    bits = occupancy[word] & (~0UL << (start % WORD_BITS));
+    while (bits == 0)
+    {
+        if (++word >= SymTable_occupancyWords(end)) {return end;}
+        bits = occupancy[word];
+    }
+    start = word * WORD_BITS + SymTable_lowestBit(bits);
+    return start < end ? start : end;
+}
+
+/* Move up to uCount more buckets of oSymTable's old bucket array into
+   its current one, relinking bindings by their cached hashes, and free
+   the old array once it is empty. */
+static void SymTable_migrate(SymTable_T oSymTable, size_t uCount)
+{
+    Binding_T *pBinding;
+    Binding_T *next;
+    size_t hash_value;
+
+    assert(oSymTable->oldBuckets != NULL);
+
+    for (; uCount > 0 && oSymTable->migrated < oSymTable->oldSize; uCount--)
+    {
+        pBinding = oSymTable->oldBuckets[oSymTable->migrated];
+        while (pBinding != NULL)
         {
-            next = buckets_i->next;
-            SymTable_put(oSymTable, buckets_i->key, buckets_i->value);
-            SymTable_binding_free(buckets_i);
-            buckets_i = next;
+            next = pBinding->next;
+            hash_value = SymTable_bucketIndex(pBinding->hash, oSymTable->size);
+            pBinding->next = oSymTable->buckets[hash_value];
+            oSymTable->buckets[hash_value] = pBinding;
+            SymTable_markBucket(oSymTable->buckets, oSymTable->size, hash_value);
+            pBinding = next;
         }
-	}
-	free(old_buckets);
-    return;
+        oSymTable->oldBuckets[oSymTable->migrated] = NULL;
+        SymTable_markBucket(oSymTable->oldBuckets, oSymTable->oldSize, oSymTable->migrated);
+        ++(oSymTable->migrated);
+    }
+    if (oSymTable->migrated == oSymTable->oldSize)
+    {
+        free(oSymTable->oldBuckets);
+        oSymTable->oldBuckets = NULL;
+        oSymTable->oldSize = 0;
+    }
+}
+
+/* Return the binding in the chain starting at pBinding whose key is
+   the uLength characters at pcKey and whose full hash is uHash, or NULL
+   if there is none. Count the bindings visited in *puProbes. */
+static struct Binding *SymTable_findInChain(struct Binding *pBinding, const char *pcKey,
+                                            size_t uLength, size_t uHash, size_t *puProbes)
+{
+    for (; pBinding != NULL; pBinding = pBinding->next)
+    {
+        SymTableStats_probe(*puProbes);
+        if (pBinding->hash == uHash
+            && SymTable_keyEquals(SymTable_bindingKey(pBinding), pcKey, uLength))
+            return pBinding;
+    }
+    return NULL;
+}
+
+/* Return the binding of oSymTable whose key is the uLength characters
+   at pcKey, where uHash is their full hash, or NULL if there is none.
+   Only bindings whose cached hash equals uHash are compared. During an
+   incremental resize, first move MIGRATE_BUCKETS more buckets, then
+   look in both the new and the old bucket array. */
+static struct Binding *SymTable_find(SymTable_T oSymTable, const char *pcKey,
+                                     size_t uLength, size_t uHash)
+{
+    struct Binding *pBinding;
+    size_t uProbes = 0;
+
+    if (oSymTable->oldBuckets != NULL) {SymTable_migrate(oSymTable, MIGRATE_BUCKETS);}
+    pBinding = SymTable_findInChain(oSymTable->buckets[SymTable_bucketIndex(uHash, oSymTable->size)],
+                                    pcKey, uLength, uHash, &uProbes);
+    if (pBinding == NULL && oSymTable->oldBuckets != NULL)
+        pBinding = SymTable_findInChain(oSymTable->oldBuckets[SymTable_bucketIndex(uHash, oSymTable->oldSize)],
+                                        pcKey, uLength, uHash, &uProbes);
+    SymTableStats_lookup(&oSymTable->stats, uProbes, pBinding != NULL);
+    return pBinding;
 }
 
-/* Search for value in the array arr of given size. 
-   Return the index if value is found, otherwise return -1. */
-static size_t SymTable_BUCKETLIST_findIndex(const size_t arr[], size_t size, size_t value) {
+/* Return the Binding_T pointer pBinding, and the copy of its key if it
+   owns one, to the arena of oSymTable for reuse by a later put. */
+static void SymTable_binding_free(SymTable_T oSymTable, Binding_T *pBinding){
+    assert(oSymTable != NULL);
+    assert(pBinding != NULL);
+    if (pBinding->key.inline_key[INLINE_KEY_SIZE - 1] == KEY_ARENA)
+        SymTableArena_freeBytes(&oSymTable->arena, pBinding->key.long_key,
+                                strlen(pBinding->key.long_key) + 1);
+    SymTableArena_freeBlock(&oSymTable->arena, pBinding);
+}
+
+#ifndef SYMTABLE_POW2_BUCKETS
+/* Return 1 if u is prime, 0 otherwise. */
+static int SymTable_isPrime(size_t u)
+{
+    size_t d;
+    if (u < 2) {return 0;}
+    if (u % 2 == 0) {return u == 2;}
+    for (d = 3; d <= u / d; d += 2) {
+        if (u % d == 0) {return 0;}
+    }
+    return 1;
+}
+
+#endif
+
+/* Return the bucket count that follows size in the growth sequence:
+   the next entry of BUCKET_COUNT, or past its end the smallest prime
+   greater than 2*size (2*size itself for power-of-two bucket counts).
+   Return size itself if the table cannot grow any further without
+   overflowing the bucket array's byte count. */
+static size_t SymTable_nextBucketCount(size_t size)
+{
     size_t i;
-    assert(arr != NULL);
-    for (i = 0; i < size; i++) {
-        if (arr[i] == value) {
-            return i;
-        }
+    size_t next;
+
+    for (i = 0; i < BUCKET_COUNT_LEN; i++) {
+        if (BUCKET_COUNT[i] > size) {return BUCKET_COUNT[i];}
     }
-    return -1;
+    if (size > ((size_t)-1 / sizeof(Binding_T *) - 1) / 2) {return size;}
+#ifdef SYMTABLE_POW2_BUCKETS
+    next = 2 * size;
+#else
+    next = 2 * size + 1;
+    while (!SymTable_isPrime(next)) {next += 2;}
+#endif
+    return next;
 }
 
-/* Create a new symbol table and return a pointer to it. 
-   The table is initially empty and uses the first entry of BUCKET_COUNT 
-   as its bucket count. */
-SymTable_T SymTable_new(void)
+/* Return the smallest bucket count in the growth sequence at which
+   oSymTable holds uCount bindings within its maximum load factor, or the
+   largest count the sequence reaches. */
+static size_t SymTable_bucketCountFor(SymTable_T oSymTable, size_t uCount)
+{
+    size_t size = BUCKET_COUNT[0];
+    size_t next;
+
+    while (oSymTable->maxLoad * (double)size < (double)uCount)
+    {
+        next = SymTable_nextBucketCount(size);
+        if (next == size) {break;}
+        size = next;
+    }
+    return size;
+}
+
+/* Recompute the lengths at which oSymTable grows and shrinks, from its
+   current bucket count and maximum load factor. A table shrinks once it
+   is a quarter as full as it may be, and then only to about two thirds
+   full, so that alternating puts and removes never resize it back and
+   forth. */
+static void SymTable_setGrowAt(SymTable_T oSymTable)
+{
+    double limit;
+    assert(oSymTable != NULL);
+    limit = oSymTable->maxLoad * (double)oSymTable->size;
+    if (limit >= (double)((size_t)-1)) {oSymTable->growAt = (size_t)-1;}
+    else if (limit < 1.0) {oSymTable->growAt = 1;}
+    else {oSymTable->growAt = (size_t)limit;}
+    oSymTable->shrinkAt = oSymTable->size > BUCKET_COUNT[0] ? oSymTable->growAt / 4 : 0;
+}
+
+/* Resize the symbol table oSymTable to a new size. The bindings are
+   relinked into the new buckets using their cached hashes, all at once,
+   or, if the table resizes incrementally, MIGRATE_BUCKETS old buckets
+   per later operation. No binding or key is allocated, copied, freed or
+   rehashed. Return 1 on success, or 0 if memory is exhausted, in which
+   case oSymTable keeps its size. */
+static int SymTable_resize(SymTable_T oSymTable, size_t size)
+{
+    Binding_T **new_buckets;
+
+    SymTableStats_startResize(&oSymTable->stats);
+
+    /* A resize still in progress must finish before the next one starts. */
+    if (oSymTable->oldBuckets != NULL) {SymTable_migrate(oSymTable, oSymTable->oldSize);}
+
+    new_buckets = SymTable_newBuckets(size);
+    if(new_buckets == NULL) {SymTableStats_stopResize(&oSymTable->stats); return 0;}
+
+    oSymTable->oldBuckets = oSymTable->buckets;
+    oSymTable->oldSize = oSymTable->size;
+    oSymTable->migrated = 0;
+    oSymTable->buckets = new_buckets;
+    oSymTable->size = size;
+    SymTable_setGrowAt(oSymTable);
+    ++(oSymTable->resizes);
+
+    if (!oSymTable->incremental) {SymTable_migrate(oSymTable, oSymTable->oldSize);}
+    SymTableStats_stopResize(&oSymTable->stats);
+    return 1;
+}
+
+/* Create a new symbol table that hashes keys with eHashFunction and
+   return a pointer to it. The table is initially empty and uses the
+   first entry of BUCKET_COUNT as its bucket count. */
+SymTable_T SymTable_newWithHash(enum SymTable_HashFunction eHashFunction)
 {
  struct SymTable *pSymtable; 
  struct Binding **qBinding;
  pSymtable = (struct SymTable *) calloc(1, sizeof(*pSymtable));
  if(pSymtable == NULL) {return NULL;}
- qBinding = (struct Binding **) calloc(BUCKET_COUNT[0], sizeof(*qBinding));
- if(qBinding == NULL) {return NULL;}
+ qBinding = SymTable_newBuckets(BUCKET_COUNT[0]);
+ if(qBinding == NULL) {free(pSymtable); return NULL;}
  pSymtable->buckets = qBinding;
  pSymtable->size = BUCKET_COUNT[0];
  pSymtable->len = 0;
+ pSymtable->maxLoad = SYMTABLE_MAX_LOAD_FACTOR;
+ pSymtable->resizes = 0;
+ pSymtable->oldBuckets = NULL;
+ pSymtable->incremental = SYMTABLE_INCREMENTAL_RESIZE != 0;
+ pSymtable->hashFunction = eHashFunction;
+ if (eHashFunction == SYMTABLE_HASH_KEYED) {SymTableHashFn_processKey(pSymtable->sipKey);}
+ SymTable_setGrowAt(pSymtable);
+ SymTableArena_init(&pSymtable->arena, sizeof(Binding_T));
+ SymTableTrace_created(pSymtable);
  return pSymtable;
 }
 
+/* Create a new symbol table that hashes keys with the legacy hash
+   function and return a pointer to it. */
+SymTable_T SymTable_new(void)
+{
+ return SymTable_newWithHash(SYMTABLE_HASH_LEGACY);
+}
+
 /* Free all memory associated with the symbol table oSymTable, 
-   including all bindings and the table structure itself. */
+   including all bindings and the table structure itself. Bindings and
+   keys are released a chunk at a time with the arena. */
 void SymTable_free(SymTable_T oSymTable)
 {
-    Binding_T *pBinding;
-    Binding_T *next;
-    size_t i;
-    
     assert(oSymTable != NULL);
 
-    for (i=0; i < oSymTable->size; i++)
-    {
-        pBinding = oSymTable->buckets[i];
-        while (pBinding != NULL)
-        {
-            next = pBinding->next;
-            SymTable_binding_free(pBinding);
-            pBinding = next;
-        }
-    }
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_FREE, NULL, 0);
+    SymTableArena_free(&oSymTable->arena);
     free(oSymTable->buckets); 
+    free(oSymTable->oldBuckets);
     free(oSymTable);
 }
 
 /* Return the number of key-value bindings stored in the symbol table oSymTable. */
-size_t SymTable_getLength(SymTable_T oSymTable){assert(oSymTable != NULL); return oSymTable->len;}
+size_t SymTable_getLength(SymTable_T oSymTable)
+{
+    assert(oSymTable != NULL);
+
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_LENGTH, NULL, 0);
+    return oSymTable->len;
+}
+
+/* Insert a new binding with key pcKey, of length key_len and full hash
+   hash_value, and value pvValue into oSymTable, growing it first if
+   needed. The caller has checked that pcKey is absent. If iShared, the
+   binding stores the pointer pcKey instead of a copy. Returns a pointer
+   to the new binding's value, or NULL if memory is exhausted. */
+static const void **SymTable_insert(SymTable_T oSymTable, const char *pcKey, size_t key_len,
+                                    size_t hash_value, const void *pvValue, int iShared)
+{
+    size_t next_size;
+    size_t index;
+    Binding_T *newBinding;
+
+    /* NOTE that >= does not mean no of elements >= growAt!!! 
+    Since ++(oSymTable->len); is happening later, the no of elements is actually (oSymTable->len+1) !*/
+    if (oSymTable->len >= oSymTable->growAt)
+    {
+        next_size = SymTable_nextBucketCount(oSymTable->size);
+        if (next_size != oSymTable->size) {SymTable_resize(oSymTable, next_size);}
+    }
+    
+    newBinding = (Binding_T *) SymTableArena_allocBlock(&oSymTable->arena);
+    if(newBinding == NULL) {return NULL;}
+    if(!SymTable_setBindingKey(oSymTable, newBinding, pcKey, key_len, iShared)) {
+        SymTableArena_freeBlock(&oSymTable->arena, newBinding);
+        return NULL;
+    }
+    newBinding->hash = hash_value;
+    newBinding->value = pvValue;
+    index = SymTable_bucketIndex(hash_value, oSymTable->size);
+    newBinding->next = oSymTable->buckets[index];
+    oSymTable->buckets[index] = newBinding;
+    SymTable_markBucket(oSymTable->buckets, oSymTable->size, index);
+    ++(oSymTable->len);
+    return &newBinding->value;
+}
 
 /* Insert a new binding with key pcKey and value pvValue into the symbol table oSymTable. 
    If pcKey already exists in oSymTable, the function does nothing and returns 0.
@@ -160,135 +669,158 @@ size_t SymTable_getLength(SymTable_T oSymTable){assert(oSymTable != NULL); retur
 int SymTable_put(SymTable_T oSymTable, const char *pcKey, const void *pvValue)
 {
     size_t hash_value;
-    size_t BUCKET_COUNT_len = sizeof(BUCKET_COUNT)/sizeof(BUCKET_COUNT[0]);
-    Binding_T *newBinding;
+    size_t key_len;
 
     assert(oSymTable != NULL);
     assert(pcKey != NULL);
     /*assert(pvValue != NULL);*/
 
-    if(SymTable_contains(oSymTable, pcKey)){return 0;}
-
-    /* NOTE that >= does not mean no of elements >= BUCKETCOUNT!!! 
-    Since ++(oSymTable->len); is happening later, the no of elements is actually (oSymTable->len+1) !*/
-    if ((oSymTable->len >= oSymTable->size) && oSymTable->size != BUCKET_COUNT[BUCKET_COUNT_len-1])
-    {
-        SymTable_resize(oSymTable, BUCKET_COUNT[SymTable_BUCKETLIST_findIndex(BUCKET_COUNT, BUCKET_COUNT_len, oSymTable->size)+1]);
-    }
-    
-    hash_value = SymTable_hash(pcKey, oSymTable->size);
-    newBinding = (Binding_T *) calloc(1, sizeof(Binding_T));
-    if(newBinding == NULL) {return 0;}
-    newBinding->key = (const char*)malloc(strlen(pcKey) + 1);
-    strcpy((char*)newBinding->key, pcKey);
-    newBinding->value = pvValue;
-    newBinding->next = oSymTable->buckets[hash_value];
-    oSymTable->buckets[hash_value] = newBinding;
-    ++(oSymTable->len);
-    return 1;
+    hash_value = SymTable_hash(oSymTable, pcKey, &key_len);
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_PUT, pcKey, key_len);
+    if(SymTable_find(oSymTable, pcKey, key_len, hash_value) != NULL){return 0;}
+    return SymTable_insert(oSymTable, pcKey, key_len, hash_value, pvValue, 0) != NULL;
 }
 
 /* Replace the value associated with pcKey in the symbol table oSymTable with pvValue.
    Returns the old value associated with pcKey if it exists, otherwise returns NULL. */
 void *SymTable_replace(SymTable_T oSymTable, const char *pcKey, const void *pvValue)
 {
-    size_t hash_value = SymTable_hash(pcKey, oSymTable->size);
-    Binding_T *pBinding = oSymTable->buckets[hash_value];
+    Binding_T *pBinding;
+    size_t key_len;
+    size_t hash_value;
     const void *temp;
 
     assert(oSymTable != NULL);
     assert(pcKey != NULL);
     /*assert(pvValue != NULL);*/
 
+    hash_value = SymTable_hash(oSymTable, pcKey, &key_len);
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_REPLACE, pcKey, key_len);
+    pBinding = SymTable_find(oSymTable, pcKey, key_len, hash_value);
     if (pBinding == NULL) {return NULL;}
 
-    while(pBinding != NULL)
-    {
-        if (strcmp(pBinding->key, pcKey) == 0){
-            temp = pBinding->value;
-            pBinding->value = pvValue;
-            return (void *) temp;
-        }
-        pBinding = pBinding->next;
-    }
-    return NULL;
+    temp = pBinding->value;
+    pBinding->value = pvValue;
+    return (void *) temp;
 }
 
 /* Check if the symbol table oSymTable contains a binding for pcKey. 
    Returns 1 if pcKey is found, 0 otherwise. */
 int SymTable_contains(SymTable_T oSymTable, const char *pcKey)
 {
-    size_t hash_value = SymTable_hash(pcKey, oSymTable->size);
-    Binding_T *pBinding = oSymTable->buckets[hash_value];
+    size_t key_len;
+    size_t hash_value;
 
     assert(oSymTable != NULL);
     assert(pcKey != NULL);
 
-    if (pBinding == NULL) {return 0;}
-
-    while(pBinding != NULL)
-    {
-        if (strcmp(pBinding->key, pcKey) == 0)
-            return 1;
-        pBinding = pBinding->next;
-    }
-    return 0;
+    hash_value = SymTable_hash(oSymTable, pcKey, &key_len);
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_CONTAINS, pcKey, key_len);
+    return SymTable_find(oSymTable, pcKey, key_len, hash_value) != NULL;
 }
 
 /* Retrieve the value associated with pcKey in the symbol table oSymTable.
    Returns NULL if pcKey is not found. */
 void *SymTable_get(SymTable_T oSymTable, const char *pcKey)
 {
-    size_t hash_value = SymTable_hash(pcKey, oSymTable->size);
-    Binding_T *pBinding = oSymTable->buckets[hash_value];
+    Binding_T *pBinding;
+    size_t key_len;
+    size_t hash_value;
 
     assert(oSymTable != NULL);
     assert(pcKey != NULL);
 
+    hash_value = SymTable_hash(oSymTable, pcKey, &key_len);
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_GET, pcKey, key_len);
+    pBinding = SymTable_find(oSymTable, pcKey, key_len, hash_value);
     if (pBinding == NULL) {return NULL;}
+    return (void *) pBinding->value;
+}
 
-    while(pBinding != NULL)
+/* Unlink from the chain whose head is *ppBinding the binding whose key
+   is pcKey, of length key_len and full hash full_hash, and return it,
+   or NULL if there is none. Count the bindings visited in *puProbes. */
+static Binding_T *SymTable_unlink(Binding_T **ppBinding, const char *pcKey,
+                                  size_t key_len, size_t full_hash, size_t *puProbes)
+{
+    Binding_T *pBinding;
+
+    for (; *ppBinding != NULL; ppBinding = &(*ppBinding)->next)
     {
-        if (strcmp(pBinding->key, pcKey) == 0)
-            return (void *) pBinding->value;
-        pBinding = pBinding->next;
+        pBinding = *ppBinding;
+        SymTableStats_probe(*puProbes);
+        if (pBinding->hash == full_hash
+            && SymTable_keyEquals(SymTable_bindingKey(pBinding), pcKey, key_len)) {
+            *ppBinding = pBinding->next;
+            return pBinding;
+        }
     }
     return NULL;
 }
 
+/* Remove the binding of oSymTable whose key is pcKey, of length key_len
+   and full hash full_hash. Returns its value, or NULL if there is none.
+   Shrinks oSymTable if it has become too sparse. During an incremental
+   resize, first move MIGRATE_BUCKETS more buckets, then look in both the
+   new and the old bucket array. */
+static void *SymTable_removeHashed(SymTable_T oSymTable, const char *pcKey,
+                                   size_t key_len, size_t full_hash)
+{
+    Binding_T *pBinding;
+    const void *temp;
+    size_t size;
+    size_t index;
+    size_t uProbes = 0;
+
+    if (oSymTable->oldBuckets != NULL) {SymTable_migrate(oSymTable, MIGRATE_BUCKETS);}
+    index = SymTable_bucketIndex(full_hash, oSymTable->size);
+    pBinding = SymTable_unlink(&oSymTable->buckets[index], pcKey, key_len, full_hash, &uProbes);
+    if (pBinding != NULL) {SymTable_markBucket(oSymTable->buckets, oSymTable->size, index);}
+    else if (oSymTable->oldBuckets != NULL)
+    {
+        index = SymTable_bucketIndex(full_hash, oSymTable->oldSize);
+        pBinding = SymTable_unlink(&oSymTable->oldBuckets[index], pcKey, key_len, full_hash,
+                                   &uProbes);
+        if (pBinding != NULL) {SymTable_markBucket(oSymTable->oldBuckets, oSymTable->oldSize, index);}
+    }
+    SymTableStats_lookup(&oSymTable->stats, uProbes, pBinding != NULL);
+    if (pBinding == NULL) {return NULL;}
+
+    --(oSymTable->len);
+    temp = pBinding->value;
+    SymTable_binding_free(oSymTable, pBinding);
+
+    /* Shrink to at most two thirds full. Sizing for twice len instead
+       could land back on the current size, since each prime bucket count
+       is slightly more than twice the one before. */
+    if (oSymTable->len < oSymTable->shrinkAt)
+    {
+        size = SymTable_bucketCountFor(oSymTable, oSymTable->len + oSymTable->len / 2);
+        if (size < oSymTable->size) {SymTable_resize(oSymTable, size);}
+    }
+    return (void *) temp;
+}
+
 /* Remove the binding for pcKey from the symbol table oSymTable, freeing its memory.
    Returns the value associated with pcKey, or NULL if pcKey is not found. */
 void *SymTable_remove(SymTable_T oSymTable, const char *pcKey)
 {
-    size_t hash_value = SymTable_hash(pcKey, oSymTable->size);
-    Binding_T *pBinding = oSymTable->buckets[hash_value];
-    Binding_T *prev;
-    const void *temp;
+    size_t key_len;
+    size_t full_hash;
 
     assert(oSymTable != NULL);
     assert(pcKey != NULL);
 
-    if (pBinding == NULL) {return NULL;}
-
-    prev = NULL;
-    while(pBinding != NULL)
-    {
-        if (strcmp(pBinding->key, pcKey) == 0) { 
-            if (prev == NULL) {oSymTable->buckets[hash_value] = pBinding->next;}
-            else {prev->next = pBinding->next;}
-            --(oSymTable->len);
-            temp = pBinding->value;
-            SymTable_binding_free(pBinding);
-            return (void *) temp;
-        }
-        prev = pBinding;
-        pBinding = pBinding->next;
-    }
-    return NULL;
+    full_hash = SymTable_hash(oSymTable, pcKey, &key_len);
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_REMOVE, pcKey, key_len);
+    return SymTable_removeHashed(oSymTable, pcKey, key_len, full_hash);
 }
 
 /* Apply the function pfApply to each binding in the symbol table oSymTable,
-   passing pcKey, pvValue, and pvExtra as arguments. */
+   passing pcKey, pvValue, and pvExtra as arguments. Only nonempty
+   buckets are visited, found through the occupancy bitmap. Any resize
+   in progress is finished first, so that lookups made by pfApply do
+   not move buckets under the walk. */
 void SymTable_map(SymTable_T oSymTable, void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra), const void *pvExtra)
 {
     Binding_T *pBinding;
@@ -299,13 +831,484 @@ void SymTable_map(SymTable_T oSymTable, void (*pfApply)(const char *pcKey, void
 
     assert(pfApply != NULL); 
 
-    for (i=0; i < oSymTable->size; i++)
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_MAP, NULL, 0);
+    if (oSymTable->oldBuckets != NULL) {SymTable_migrate(oSymTable, oSymTable->oldSize);}
+    for (i = SymTable_nextOccupied(oSymTable->buckets, oSymTable->size, 0, oSymTable->size);
+         i < oSymTable->size;
+         i = SymTable_nextOccupied(oSymTable->buckets, oSymTable->size, i + 1, oSymTable->size))
     {
         pBinding = oSymTable->buckets[i];
         while (pBinding != NULL)
         {
-            (*pfApply)(pBinding->key, (void *) pBinding->value, (void *) pvExtra);
+            (*pfApply)(SymTable_bindingKey(pBinding), (void *) pBinding->value, (void *) pvExtra);
             pBinding = pBinding->next;
         }
     }
-}
\ No newline at end of file
+}
+
+/* Apply pfApply to each binding of oSymTable until it returns nonzero,
+   and return that value, or 0 if it never does. Any resize in progress
+   is finished first, so only the current bucket array is walked. */
+int SymTable_mapUntil(SymTable_T oSymTable,
+                      int (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+                      const void *pvExtra)
+{
+    Binding_T *pBinding;
+    size_t i;
+    int iResult;
+
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    if (oSymTable->oldBuckets != NULL) {SymTable_migrate(oSymTable, oSymTable->oldSize);}
+    for (i = SymTable_nextOccupied(oSymTable->buckets, oSymTable->size, 0, oSymTable->size);
+         i < oSymTable->size;
+         i = SymTable_nextOccupied(oSymTable->buckets, oSymTable->size, i + 1, oSymTable->size))
+    {
+        for (pBinding = oSymTable->buckets[i]; pBinding != NULL; pBinding = pBinding->next)
+        {
+            iResult = (*pfApply)(SymTable_bindingKey(pBinding), (void *) pBinding->value,
+                                 (void *) pvExtra);
+            if (iResult != 0) {return iResult;}
+        }
+    }
+    return 0;
+}
+
+/* Start a traversal of oSymTable in *psIter at the first binding of its
+   first nonempty bucket. Any resize in progress is finished first, so
+   that lookups during the traversal do not move bindings. */
+void SymTable_iterBegin(SymTable_T oSymTable, struct SymTable_Iter *psIter)
+{
+    assert(oSymTable != NULL);
+    assert(psIter != NULL);
+
+    if (oSymTable->oldBuckets != NULL) {SymTable_migrate(oSymTable, oSymTable->oldSize);}
+    psIter->uIndex = SymTable_nextOccupied(oSymTable->buckets, oSymTable->size, 0,
+                                           oSymTable->size);
+    psIter->pvNext = psIter->uIndex < oSymTable->size ? oSymTable->buckets[psIter->uIndex] : NULL;
+}
+
+/* Store the key and value of the binding *psIter has reached in *ppcKey
+   and *ppvValue, unless they are NULL, and move *psIter to the next
+   binding in its chain or else to the next nonempty bucket. Returns 1,
+   or 0 if the traversal has passed the last binding. */
+int SymTable_iterNext(SymTable_T oSymTable, struct SymTable_Iter *psIter,
+                      const char **ppcKey, void **ppvValue)
+{
+    const Binding_T *pBinding;
+
+    assert(oSymTable != NULL);
+    assert(psIter != NULL);
+
+    pBinding = (const Binding_T *) psIter->pvNext;
+    if (pBinding == NULL) {return 0;}
+    if (ppcKey != NULL) {*ppcKey = SymTable_bindingKey(pBinding);}
+    if (ppvValue != NULL) {*ppvValue = (void *) pBinding->value;}
+
+    psIter->pvNext = pBinding->next;
+    if (psIter->pvNext == NULL)
+    {
+        psIter->uIndex = SymTable_nextOccupied(oSymTable->buckets, oSymTable->size,
+                                               psIter->uIndex + 1, oSymTable->size);
+        if (psIter->uIndex < oSymTable->size) {psIter->pvNext = oSymTable->buckets[psIter->uIndex];}
+    }
+    return 1;
+}
+
+/* Apply psVisit to each binding in buckets uBegin up to uEnd of the
+   SymTable pvSymTable. The parallel traversals give each thread such
+   slices of the bucket array. */
+static void SymTable_walkBuckets(const void *pvSymTable, size_t uBegin, size_t uEnd,
+                                 const struct SymTableParallel_Visit *psVisit)
+{
+    const struct SymTable *oSymTable = (const struct SymTable *) pvSymTable;
+    const Binding_T *pBinding;
+    size_t i;
+
+    for (i = SymTable_nextOccupied(oSymTable->buckets, oSymTable->size, uBegin, uEnd); i < uEnd;
+         i = SymTable_nextOccupied(oSymTable->buckets, oSymTable->size, i + 1, uEnd))
+    {
+        for (pBinding = oSymTable->buckets[i]; pBinding != NULL; pBinding = pBinding->next)
+            (*psVisit->pfApply)(SymTable_bindingKey(pBinding), (void *) pBinding->value,
+                                psVisit->pvAccumulator, psVisit->pvExtra);
+    }
+}
+
+/* Apply pfApply to each binding of oSymTable from up to uThreadCount
+   threads, which share out the bucket array. Any resize in progress is
+   finished first. */
+void SymTable_mapParallel(SymTable_T oSymTable,
+                          void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+                          const void *pvExtra, size_t uThreadCount)
+{
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    if (oSymTable->oldBuckets != NULL) {SymTable_migrate(oSymTable, oSymTable->oldSize);}
+    SymTableParallel_map(oSymTable, oSymTable->size, SymTable_walkBuckets, pfApply, pvExtra,
+                         uThreadCount);
+}
+
+/* Like SymTable_mapParallel, but with an accumulator per thread that is
+   merged into *pvResult at the end. */
+void SymTable_mapReduce(SymTable_T oSymTable,
+                        void (*pfApply)(const char *pcKey, void *pvValue,
+                                        void *pvAccumulator, void *pvExtra),
+                        void (*pfMerge)(void *pvResult, const void *pvAccumulator, void *pvExtra),
+                        size_t uAccumulatorSize, void *pvResult, const void *pvExtra,
+                        size_t uThreadCount)
+{
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    if (oSymTable->oldBuckets != NULL) {SymTable_migrate(oSymTable, oSymTable->oldSize);}
+    SymTableParallel_reduce(oSymTable, oSymTable->size, SymTable_walkBuckets, pfApply, pfMerge,
+                            uAccumulatorSize, pvResult, pvExtra, uThreadCount);
+}
+
+/* Set the maximum load factor of oSymTable to dMaxLoadFactor. The table
+   grows on the next put once its length reaches dMaxLoadFactor times its
+   bucket count. Returns 1 on success, or 0 if dMaxLoadFactor is not
+   positive. */
+int SymTable_setMaxLoadFactor(SymTable_T oSymTable, double dMaxLoadFactor)
+{
+    assert(oSymTable != NULL);
+    if (!(dMaxLoadFactor > 0.0)) {return 0;}
+    oSymTable->maxLoad = dMaxLoadFactor;
+    SymTable_setGrowAt(oSymTable);
+    return 1;
+}
+
+#ifdef SYMTABLE_STATS
+/* Add the length of the chain of each bucket from uBegin up to uEnd of
+   buckets to the histogram of *psStats. */
+static void SymTable_addChains(Binding_T **buckets, size_t uBegin, size_t uEnd,
+                               struct SymTable_Stats *psStats)
+{
+    const Binding_T *pBinding;
+    size_t uLength;
+    size_t i;
+
+    for (i = uBegin; i < uEnd; i++)
+    {
+        uLength = 0;
+        for (pBinding = buckets[i]; pBinding != NULL; pBinding = pBinding->next) {uLength++;}
+        SymTableStats_addChain(psStats, uLength);
+    }
+}
+#endif
+
+/* Fill *psStats with the current state of the growth policy of
+   oSymTable. In a build with SYMTABLE_STATS, also report its counters,
+   the length of every chain, and the memory held by its bucket arrays
+   and its arena. */
+void SymTable_getStats(SymTable_T oSymTable, struct SymTable_Stats *psStats)
+{
+    assert(oSymTable != NULL);
+    assert(psStats != NULL);
+
+    psStats->uLength = oSymTable->len;
+    psStats->uBucketCount = oSymTable->size;
+    psStats->uGrowAt = oSymTable->growAt;
+    psStats->uShrinkAt = oSymTable->shrinkAt;
+    psStats->uResizeCount = oSymTable->resizes;
+    psStats->dLoadFactor = (double)oSymTable->len / (double)oSymTable->size;
+    psStats->dMaxLoadFactor = oSymTable->maxLoad;
+
+    SymTableStats_clear(psStats);
+#ifdef SYMTABLE_STATS
+    SymTableStats_report(&oSymTable->stats, psStats);
+    SymTable_addChains(oSymTable->buckets, 0, oSymTable->size, psStats);
+    psStats->uBytesAllocated = sizeof(*oSymTable) + SymTable_bucketBytes(oSymTable->size)
+                               + oSymTable->arena.bytesReserved;
+    if (oSymTable->oldBuckets != NULL)
+    {
+        SymTable_addChains(oSymTable->oldBuckets, oSymTable->migrated, oSymTable->oldSize, psStats);
+        psStats->uBytesAllocated += SymTable_bucketBytes(oSymTable->oldSize);
+    }
+#endif
+}
+
+/* Grow oSymTable to the bucket count at which it holds uCount bindings,
+   unless it is already that large. Returns 1 on success, or 0 if memory
+   is exhausted. */
+int SymTable_reserve(SymTable_T oSymTable, size_t uCount)
+{
+    size_t size;
+
+    assert(oSymTable != NULL);
+
+    size = SymTable_bucketCountFor(oSymTable, uCount);
+    if (size <= oSymTable->size) {return 1;}
+    return SymTable_resize(oSymTable, size);
+}
+
+/* Shrink oSymTable to the smallest bucket count at which it holds its
+   current bindings, finishing the resize at once even if the table
+   resizes incrementally. Freed bindings stay in the arena for reuse. */
+void SymTable_shrinkToFit(SymTable_T oSymTable)
+{
+    size_t size;
+
+    assert(oSymTable != NULL);
+
+    size = SymTable_bucketCountFor(oSymTable, oSymTable->len);
+    if (size < oSymTable->size) {SymTable_resize(oSymTable, size);}
+    if (oSymTable->oldBuckets != NULL) {SymTable_migrate(oSymTable, oSymTable->oldSize);}
+}
+
+/* Make oSymTable spread each later resize over the operations that
+   follow it if iEnabled is nonzero, or relink all bindings at once
+   otherwise, finishing any resize in progress. Returns 1. */
+int SymTable_setIncrementalResize(SymTable_T oSymTable, int iEnabled)
+{
+    assert(oSymTable != NULL);
+    if (!iEnabled && oSymTable->oldBuckets != NULL)
+        SymTable_migrate(oSymTable, oSymTable->oldSize);
+    oSymTable->incremental = iEnabled != 0;
+    return 1;
+}
+
+/* A chain is too short for reordering to pay for itself, so the hash
+   table keeps its own order. Returns 1 if eReorder is
+   SYMTABLE_REORDER_NONE, or 0 otherwise. */
+int SymTable_setReorder(SymTable_T oSymTable, enum SymTable_Reorder eReorder)
+{
+    assert(oSymTable != NULL);
+    return eReorder == SYMTABLE_REORDER_NONE;
+}
+
+/* Insert a new binding with the interned key pcInterned and value pvValue
+   into oSymTable, sharing the intern pool's copy of the key. If the key
+   already exists, does nothing and returns 0. Returns 1 on success. */
+int SymTable_putInterned(SymTable_T oSymTable, const char *pcInterned, const void *pvValue)
+{
+    size_t hash_value;
+
+    assert(oSymTable != NULL);
+    assert(pcInterned != NULL);
+
+    hash_value = SymTable_internedHash(oSymTable, pcInterned);
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_PUT, pcInterned,
+                         SymTableIntern_length(pcInterned));
+    if(SymTable_find(oSymTable, pcInterned, SymTableIntern_length(pcInterned),
+                     hash_value) != NULL){return 0;}
+    return SymTable_insert(oSymTable, pcInterned, 0, hash_value, pvValue, 1) != NULL;
+}
+
+/* Retrieve the value associated with the interned key pcInterned in
+   oSymTable, using the hash the intern pool stored for it.
+   Returns NULL if the key is not found. */
+void *SymTable_getInterned(SymTable_T oSymTable, const char *pcInterned)
+{
+    Binding_T *pBinding;
+
+    assert(oSymTable != NULL);
+    assert(pcInterned != NULL);
+
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_GET, pcInterned,
+                         SymTableIntern_length(pcInterned));
+    pBinding = SymTable_find(oSymTable, pcInterned, SymTableIntern_length(pcInterned),
+                             SymTable_internedHash(oSymTable, pcInterned));
+    if (pBinding == NULL) {return NULL;}
+    return (void *) pBinding->value;
+}
+
+/* Insert a new binding whose key is the uLength characters at pcKey,
+   with full hash uHash from SymTable_hashKey, and value pvValue into
+   oSymTable. If the key already exists, does nothing and returns 0.
+   Returns 1 on success. */
+int SymTable_putHashed(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+                       size_t uHash, const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_PUT, pcKey, uLength);
+    if(SymTable_find(oSymTable, pcKey, uLength, uHash) != NULL){return 0;}
+    return SymTable_insert(oSymTable, pcKey, uLength, uHash, pvValue, 0) != NULL;
+}
+
+/* Retrieve the value associated with the uLength characters at pcKey,
+   whose full hash uHash came from SymTable_hashKey, in oSymTable.
+   Returns NULL if the key is not found. */
+void *SymTable_getHashed(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+                         size_t uHash)
+{
+    Binding_T *pBinding;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_GET, pcKey, uLength);
+    pBinding = SymTable_find(oSymTable, pcKey, uLength, uHash);
+    if (pBinding == NULL) {return NULL;}
+    return (void *) pBinding->value;
+}
+
+/* Insert a new binding whose key is the uLength characters at pcKey and
+   whose value is pvValue into oSymTable. If the key already exists,
+   does nothing and returns 0. Returns 1 on success. */
+int SymTable_putN(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+                  const void *pvValue)
+{
+    return SymTable_putHashed(oSymTable, pcKey, uLength,
+                              SymTable_hashKey(oSymTable, pcKey, uLength), pvValue);
+}
+
+/* Retrieve the value associated with the uLength characters at pcKey in
+   oSymTable. Returns NULL if the key is not found. */
+void *SymTable_getN(SymTable_T oSymTable, const char *pcKey, size_t uLength)
+{
+    return SymTable_getHashed(oSymTable, pcKey, uLength,
+                              SymTable_hashKey(oSymTable, pcKey, uLength));
+}
+
+/* Return a pointer to the value of the binding of oSymTable whose key is
+   pcKey, first inserting a binding with value pvValue if there is none.
+   Set *piCreated, if piCreated is not NULL, to 1 if a binding was
+   inserted and to 0 otherwise. The key is hashed and its chain walked
+   once. Returns NULL if memory is exhausted. */
+const void **SymTable_getOrPut(SymTable_T oSymTable, const char *pcKey,
+                               const void *pvValue, int *piCreated)
+{
+    size_t hash_value;
+    size_t key_len;
+    Binding_T *pBinding;
+    const void **ppvValue;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    hash_value = SymTable_hash(oSymTable, pcKey, &key_len);
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_GET_OR_PUT, pcKey, key_len);
+    pBinding = SymTable_find(oSymTable, pcKey, key_len, hash_value);
+    if (piCreated != NULL) {*piCreated = 0;}
+    if (pBinding != NULL) {return &pBinding->value;}
+    ppvValue = SymTable_insert(oSymTable, pcKey, key_len, hash_value, pvValue, 0);
+    if (piCreated != NULL) {*piCreated = ppvValue != NULL;}
+    return ppvValue;
+}
+
+/* Hash the uCount keys at ppcKeys into auHashes and auLengths, and
+   prefetch the bucket of each. Then load each bucket's first binding and
+   prefetch it, so that by the time the keys are resolved in order their
+   first chain links are already in cache. */
+static void SymTable_prefetchBatch(SymTable_T oSymTable, const char *const *ppcKeys,
+                                   size_t uCount, size_t *auHashes, size_t *auLengths)
+{
+    size_t u;
+
+    for (u = 0; u < uCount; u++)
+    {
+        assert(ppcKeys[u] != NULL);
+        auHashes[u] = SymTable_hash(oSymTable, ppcKeys[u], &auLengths[u]);
+        SymTable_prefetch(&oSymTable->buckets[SymTable_bucketIndex(auHashes[u], oSymTable->size)]);
+    }
+    for (u = 0; u < uCount; u++)
+        SymTable_prefetch(oSymTable->buckets[SymTable_bucketIndex(auHashes[u], oSymTable->size)]);
+}
+
+/* Store in ppvValues[i] the value associated with ppcKeys[i] in
+   oSymTable, or NULL if it is absent, for each i below uCount. Keys are
+   hashed and their buckets prefetched BATCH_CHUNK at a time. */
+void SymTable_getBatch(SymTable_T oSymTable, const char *const *ppcKeys,
+                       size_t uCount, void **ppvValues)
+{
+    size_t auHashes[BATCH_CHUNK];
+    size_t auLengths[BATCH_CHUNK];
+    size_t uDone;
+    size_t uChunk;
+    size_t u;
+    Binding_T *pBinding;
+
+    assert(oSymTable != NULL);
+    assert(ppcKeys != NULL || uCount == 0);
+    assert(ppvValues != NULL || uCount == 0);
+
+    for (uDone = 0; uDone < uCount; uDone += uChunk)
+    {
+        uChunk = uCount - uDone < BATCH_CHUNK ? uCount - uDone : BATCH_CHUNK;
+        SymTable_prefetchBatch(oSymTable, ppcKeys + uDone, uChunk, auHashes, auLengths);
+        for (u = 0; u < uChunk; u++)
+        {
+            SymTableTrace_record(oSymTable, SYMTABLETRACE_GET, ppcKeys[uDone + u], auLengths[u]);
+            pBinding = SymTable_find(oSymTable, ppcKeys[uDone + u], auLengths[u], auHashes[u]);
+            ppvValues[uDone + u] = pBinding == NULL ? NULL : (void *) pBinding->value;
+        }
+    }
+}
+
+/* Put a binding of ppcKeys[i] to ppvValues[i] into oSymTable for each i
+   below uCount, in order, as SymTable_put would. If piResults is not
+   NULL, store SymTable_put's result for each key in piResults[i].
+   Returns the number of bindings inserted. */
+size_t SymTable_putBatch(SymTable_T oSymTable, const char *const *ppcKeys,
+                         const void *const *ppvValues, size_t uCount, int *piResults)
+{
+    size_t auHashes[BATCH_CHUNK];
+    size_t auLengths[BATCH_CHUNK];
+    size_t uDone;
+    size_t uChunk;
+    size_t u;
+    size_t uInserted = 0;
+    int iResult;
+
+    assert(oSymTable != NULL);
+    assert(ppcKeys != NULL || uCount == 0);
+    assert(ppvValues != NULL || uCount == 0);
+
+    for (uDone = 0; uDone < uCount; uDone += uChunk)
+    {
+        uChunk = uCount - uDone < BATCH_CHUNK ? uCount - uDone : BATCH_CHUNK;
+        SymTable_prefetchBatch(oSymTable, ppcKeys + uDone, uChunk, auHashes, auLengths);
+        for (u = 0; u < uChunk; u++)
+        {
+            SymTableTrace_record(oSymTable, SYMTABLETRACE_PUT, ppcKeys[uDone + u], auLengths[u]);
+            /* A resize part way through only makes later prefetches useless. */
+            iResult = SymTable_find(oSymTable, ppcKeys[uDone + u], auLengths[u], auHashes[u]) == NULL
+                && SymTable_insert(oSymTable, ppcKeys[uDone + u], auLengths[u], auHashes[u],
+                                   ppvValues[uDone + u], 0) != NULL;
+            if (piResults != NULL) {piResults[uDone + u] = iResult;}
+            uInserted += (size_t)iResult;
+        }
+    }
+    return uInserted;
+}
+
+/* Remove the binding for ppcKeys[i] from oSymTable for each i below
+   uCount, in order, and store the value it had, or NULL if it was
+   absent, in ppvValues[i] unless ppvValues is NULL. Returns the number
+   of bindings removed. */
+size_t SymTable_removeBatch(SymTable_T oSymTable, const char *const *ppcKeys,
+                            size_t uCount, void **ppvValues)
+{
+    size_t auHashes[BATCH_CHUNK];
+    size_t auLengths[BATCH_CHUNK];
+    size_t uDone;
+    size_t uChunk;
+    size_t u;
+    size_t uRemoved = 0;
+    size_t uOldLength;
+    void *pvValue;
+
+    assert(oSymTable != NULL);
+    assert(ppcKeys != NULL || uCount == 0);
+
+    for (uDone = 0; uDone < uCount; uDone += uChunk)
+    {
+        uChunk = uCount - uDone < BATCH_CHUNK ? uCount - uDone : BATCH_CHUNK;
+        SymTable_prefetchBatch(oSymTable, ppcKeys + uDone, uChunk, auHashes, auLengths);
+        for (u = 0; u < uChunk; u++)
+        {
+            SymTableTrace_record(oSymTable, SYMTABLETRACE_REMOVE, ppcKeys[uDone + u], auLengths[u]);
+            uOldLength = oSymTable->len;
+            pvValue = SymTable_removeHashed(oSymTable, ppcKeys[uDone + u],
+                                            auLengths[u], auHashes[u]);
+            uRemoved += uOldLength - oSymTable->len;
+            if (ppvValues != NULL) {ppvValues[uDone + u] = pvValue;}
+        }
+    }
+    return uRemoved;
+}
@@ -0,0 +1,257 @@
+/*--------------------------------------------------------------------*/
+/* symtablehashfn.c                                                   */
+/* Author: Chinmayi R                                                 */
+/*--------------------------------------------------------------------*/
+#include "symtable.h"
+#include "symtablehashfn.h"
+
+/* Constants of the wyhash-style hash: the seed and the four odd 64-bit
+   secrets mixed into its multiplies. */
+static const unsigned long long WORD_SEED = 0xa0761d6478bd642fULL;
+static const unsigned long long WORD_SECRET[4] = {
+    0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL,
+    0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL
+};
+
+/* Return the multiply-by-65599 hash of the uLength bytes at pvKey. */
+size_t SymTableHashFn_legacy(const void *pvKey, size_t uLength)
+{
+    const size_t HASH_MULTIPLIER = 65599;
+    const char *pcKey = (const char *) pvKey;
+    size_t uHash = 0;
+    size_t u;
+
+    assert(pvKey != NULL);
+
+    for (u = 0; u < uLength; u++)
+        uHash = uHash * HASH_MULTIPLIER + (size_t)pcKey[u];
+    return uHash;
+}
+
+/* Return the eight bytes at pc as one word, in host byte order. */
+static unsigned long long SymTableHashFn_read8(const unsigned char *pc)
+{
+    unsigned long long ullWord;
+    memcpy(&ullWord, pc, sizeof(ullWord));
+    return ullWord;
+}
+
+/* Return the four bytes at pc as one word, in host byte order. */
+static unsigned long long SymTableHashFn_read4(const unsigned char *pc)
+{
+    unsigned int uWord;
+    memcpy(&uWord, pc, sizeof(uWord));
+    return uWord;
+}
+
+/* Replace *pullA and *pullB with the low and high halves of their
+   128-bit product. */
+#ifdef __SIZEOF_INT128__
+__extension__ typedef unsigned __int128 SymTableHashFn_u128;
+static void SymTableHashFn_multiply(unsigned long long *pullA, unsigned long long *pullB)
+{
+    SymTableHashFn_u128 product = (SymTableHashFn_u128)*pullA * *pullB;
+    *pullA = (unsigned long long)product;
+    *pullB = (unsigned long long)(product >> 64);
+}
+#else
+static void SymTableHashFn_multiply(unsigned long long *pullA, unsigned long long *pullB)
+{
+    const unsigned long long LOW = 0xffffffffULL;
+    unsigned long long ullAHi = *pullA >> 32, ullALo = *pullA & LOW;
+    unsigned long long ullBHi = *pullB >> 32, ullBLo = *pullB & LOW;
+    unsigned long long ullLoLo = ullALo * ullBLo;
+    unsigned long long ullHiLo = ullAHi * ullBLo;
+    unsigned long long ullLoHi = ullALo * ullBHi;
+    unsigned long long ullHiHi = ullAHi * ullBHi;
+    unsigned long long ullMid = (ullLoLo >> 32) + (ullHiLo & LOW) + (ullLoHi & LOW);
+
+    *pullA = (ullMid << 32) | (ullLoLo & LOW);
+    *pullB = ullHiHi + (ullHiLo >> 32) + (ullLoHi >> 32) + (ullMid >> 32);
+}
+#endif
+
+/* Return the xor of the two halves of the 128-bit product of ullA and
+   ullB. */
+static unsigned long long SymTableHashFn_mix(unsigned long long ullA, unsigned long long ullB)
+{
+    SymTableHashFn_multiply(&ullA, &ullB);
+    return ullA ^ ullB;
+}
+
+/* Return the wyhash-style hash of the uLength bytes at pvKey. Keys of
+   up to 16 bytes are read as at most four overlapping words with no
+   loop; longer keys are consumed 48 and then 16 bytes at a time. */
+size_t SymTableHashFn_word(const void *pvKey, size_t uLength)
+{
+    const unsigned char *pc = (const unsigned char *) pvKey;
+    unsigned long long ullSeed;
+    unsigned long long ullSee1;
+    unsigned long long ullSee2;
+    unsigned long long ullA;
+    unsigned long long ullB;
+    size_t u;
+
+    assert(pvKey != NULL);
+
+    ullSeed = WORD_SEED ^ SymTableHashFn_mix(WORD_SEED ^ WORD_SECRET[0], WORD_SECRET[1]);
+    if (uLength <= 16)
+    {
+        if (uLength >= 4)
+        {
+            u = (uLength >> 3) << 2;
+            ullA = (SymTableHashFn_read4(pc) << 32) | SymTableHashFn_read4(pc + u);
+            ullB = (SymTableHashFn_read4(pc + uLength - 4) << 32)
+                | SymTableHashFn_read4(pc + uLength - 4 - u);
+        }
+        else if (uLength > 0)
+        {
+            ullA = ((unsigned long long)pc[0] << 16)
+                | ((unsigned long long)pc[uLength >> 1] << 8) | pc[uLength - 1];
+            ullB = 0;
+        }
+        else {ullA = ullB = 0;}
+    }
+    else
+    {
+        u = uLength;
+        if (u > 48)
+        {
+            ullSee1 = ullSeed;
+            ullSee2 = ullSeed;
+            do
+            {
+                ullSeed = SymTableHashFn_mix(SymTableHashFn_read8(pc) ^ WORD_SECRET[1],
+                                             SymTableHashFn_read8(pc + 8) ^ ullSeed);
+                ullSee1 = SymTableHashFn_mix(SymTableHashFn_read8(pc + 16) ^ WORD_SECRET[2],
+                                             SymTableHashFn_read8(pc + 24) ^ ullSee1);
+                ullSee2 = SymTableHashFn_mix(SymTableHashFn_read8(pc + 32) ^ WORD_SECRET[3],
+                                             SymTableHashFn_read8(pc + 40) ^ ullSee2);
+                pc += 48;
+                u -= 48;
+            } while (u > 48);
+            ullSeed ^= ullSee1 ^ ullSee2;
+        }
+        while (u > 16)
+        {
+            ullSeed = SymTableHashFn_mix(SymTableHashFn_read8(pc) ^ WORD_SECRET[1],
+                                         SymTableHashFn_read8(pc + 8) ^ ullSeed);
+            pc += 16;
+            u -= 16;
+        }
+        ullA = SymTableHashFn_read8(pc + u - 16);
+        ullB = SymTableHashFn_read8(pc + u - 8);
+    }
+
+    ullA ^= WORD_SECRET[1];
+    ullB ^= ullSeed;
+    SymTableHashFn_multiply(&ullA, &ullB);
+    return (size_t)SymTableHashFn_mix(ullA ^ WORD_SECRET[0] ^ (unsigned long long)uLength,
+                                      ullB ^ WORD_SECRET[1]);
+}
+
+/* Rotate ull left by iBits. */
+#define SymTableHashFn_rotl(ull, iBits) (((ull) << (iBits)) | ((ull) >> (64 - (iBits))))
+
+/* Apply one SipRound to the state aullV. */
+static void SymTableHashFn_sipRound(unsigned long long aullV[4])
+{
+    aullV[0] += aullV[1]; aullV[1] = SymTableHashFn_rotl(aullV[1], 13);
+    aullV[1] ^= aullV[0]; aullV[0] = SymTableHashFn_rotl(aullV[0], 32);
+    aullV[2] += aullV[3]; aullV[3] = SymTableHashFn_rotl(aullV[3], 16);
+    aullV[3] ^= aullV[2];
+    aullV[0] += aullV[3]; aullV[3] = SymTableHashFn_rotl(aullV[3], 21);
+    aullV[3] ^= aullV[0];
+    aullV[2] += aullV[1]; aullV[1] = SymTableHashFn_rotl(aullV[1], 17);
+    aullV[1] ^= aullV[2]; aullV[2] = SymTableHashFn_rotl(aullV[2], 32);
+}
+
+/* Return the SipHash-2-4 of the uLength bytes at pvKey under auKey. */
+size_t SymTableHashFn_sip(const void *pvKey, size_t uLength,
+                          const unsigned long long auKey[2])
+{
+    const unsigned char *pc = (const unsigned char *) pvKey;
+    unsigned long long aullV[4];
+    unsigned long long ullWord;
+    size_t u;
+
+    assert(pvKey != NULL);
+    assert(auKey != NULL);
+
+    aullV[0] = auKey[0] ^ 0x736f6d6570736575ULL;
+    aullV[1] = auKey[1] ^ 0x646f72616e646f6dULL;
+    aullV[2] = auKey[0] ^ 0x6c7967656e657261ULL;
+    aullV[3] = auKey[1] ^ 0x7465646279746573ULL;
+
+    for (u = 0; u + 8 <= uLength; u += 8)
+    {
+        ullWord = SymTableHashFn_read8(pc + u);
+        aullV[3] ^= ullWord;
+        SymTableHashFn_sipRound(aullV);
+        SymTableHashFn_sipRound(aullV);
+        aullV[0] ^= ullWord;
+    }
+
+    /* The last 0 to 7 bytes, with the length in the top byte */
+    ullWord = (unsigned long long)uLength << 56;
+    for (; u < uLength; u++)
+        ullWord |= (unsigned long long)pc[u] << (8 * (u % 8));
+    aullV[3] ^= ullWord;
+    SymTableHashFn_sipRound(aullV);
+    SymTableHashFn_sipRound(aullV);
+    aullV[0] ^= ullWord;
+
+    aullV[2] ^= 0xff;
+    SymTableHashFn_sipRound(aullV);
+    SymTableHashFn_sipRound(aullV);
+    SymTableHashFn_sipRound(aullV);
+    SymTableHashFn_sipRound(aullV);
+    return (size_t)(aullV[0] ^ aullV[1] ^ aullV[2] ^ aullV[3]);
+}
+
+/* Fill auKey with 16 random bytes from /dev/urandom. If that fails, fall
+   back to hashing the time, the clock, a counter and two addresses,
+   which differ between runs but are not secret. */
+static void SymTableHashFn_newKey(unsigned long long auKey[2])
+{
+    static unsigned long long ullCounter;
+    unsigned long long aullSource[5];
+    FILE *psFile;
+    size_t uRead = 0;
+
+    assert(auKey != NULL);
+
+    psFile = fopen("/dev/urandom", "rb");
+    if (psFile != NULL)
+    {
+        uRead = fread(auKey, sizeof(auKey[0]), 2, psFile);
+        fclose(psFile);
+    }
+    if (uRead == 2) {return;}
+
+    aullSource[0] = (unsigned long long)time(NULL);
+    aullSource[1] = (unsigned long long)clock();
+    aullSource[2] = ++ullCounter;
+    aullSource[3] = (unsigned long long)(size_t)auKey;
+    aullSource[4] = (unsigned long long)(size_t)&ullCounter;
+    auKey[0] = SymTableHashFn_word(aullSource, sizeof(aullSource));
+    aullSource[2] = ++ullCounter;
+    auKey[1] = SymTableHashFn_word(aullSource, sizeof(aullSource));
+}
+
+/* Fill auKey with the process-wide key, drawing it on the first call. */
+void SymTableHashFn_processKey(unsigned long long auKey[2])
+{
+    static unsigned long long aullKey[2];
+    static int iSeeded = 0;
+
+    assert(auKey != NULL);
+
+    if (!iSeeded)
+    {
+        SymTableHashFn_newKey(aullKey);
+        iSeeded = 1;
+    }
+    auKey[0] = aullKey[0];
+    auKey[1] = aullKey[1];
+}
@@ -0,0 +1,33 @@
+/*--------------------------------------------------------------------*/
+/* symtablehashfn.h                                                   */
+/* Author: Chinmayi R                                                 */
+/*--------------------------------------------------------------------*/
+#include <stddef.h>
+
+#ifndef SYMTABLEHASHFN_INCLUDED
+#define SYMTABLEHASHFN_INCLUDED
+
+/* Interface between the string hash functions and the SymTable
+   implementations. Clients choose a function with SymTable_newWithHash
+   from symtable.h instead. */
+
+/* Return the multiply-by-65599 hash of the uLength bytes at pvKey, one
+   byte at a time. This is the hash the intern pool stores. */
+size_t SymTableHashFn_legacy(const void *pvKey, size_t uLength);
+
+/* Return a wyhash-style hash of the uLength bytes at pvKey, which reads
+   eight bytes at a time and folds them with 64x64->128-bit multiplies. */
+size_t SymTableHashFn_word(const void *pvKey, size_t uLength);
+
+/* Return the SipHash-2-4 of the uLength bytes at pvKey under the 128-bit
+   key auKey. Without auKey, inputs that collide cannot be chosen. */
+size_t SymTableHashFn_sip(const void *pvKey, size_t uLength,
+                          const unsigned long long auKey[2]);
+
+/* Fill auKey with the process-wide key for SymTableHashFn_sip. The key
+   is drawn once, on the first call, from /dev/urandom if it can be read,
+   or else from the clock and addresses, so every keyed table of the
+   process hashes alike. The first call is not thread-safe. */
+void SymTableHashFn_processKey(unsigned long long auKey[2]);
+
+#endif
@@ -0,0 +1,149 @@
+/*--------------------------------------------------------------------*/
+/* symtableintern.c                                                   */
+/* Author: Chinmayi R                                                 */
+/*--------------------------------------------------------------------*/
+#include "symtable.h"
+#include "symtableintern.h"
+#include "symtablearena.h"
+
+/* Number of slots in the pool's index when the first string is interned.
+   The slot count is always a power of two. */
+enum {INITIAL_SLOT_COUNT = 256};
+
+/* The intern pool. Each interned string is stored in the arena right
+   after a copy of its hash and its length, and the index is an
+   open-addressing table of pointers to those strings, kept at most half
+   full. The pool is process-wide and not synchronized. */
+static struct {
+    /* Storage for hash and length headers and string bytes */
+    struct SymTableArena arena;
+    /* Open-addressing index of interned strings; NULL slots are empty */
+    const char **slots;
+    /* Number of slots in the index */
+    size_t slotCount;
+    /* Number of interned strings */
+    size_t len;
+} sPool;
+
+/* Return the multiply-by-65599 hash of the string pcKey, and store the
+   length of pcKey in *puLength. */
+static size_t SymTableIntern_hashKey(const char *pcKey, size_t *puLength)
+{
+    const size_t HASH_MULTIPLIER = 65599;
+    size_t u;
+    size_t uHash = 0;
+
+    assert(pcKey != NULL);
+    assert(puLength != NULL);
+
+    for (u = 0; pcKey[u] != '\0'; u++)
+        uHash = uHash * HASH_MULTIPLIER + (size_t)pcKey[u];
+
+    *puLength = u;
+    return uHash;
+}
+
+/* Return the hash that the intern pool stored for pcInterned. */
+size_t SymTableIntern_hash(const char *pcInterned)
+{
+    size_t uHash;
+    assert(pcInterned != NULL);
+    memcpy(&uHash, pcInterned - 2 * sizeof(size_t), sizeof(uHash));
+    return uHash;
+}
+
+/* Return the length that the intern pool stored for pcInterned. */
+size_t SymTableIntern_length(const char *pcInterned)
+{
+    size_t uLength;
+    assert(pcInterned != NULL);
+    memcpy(&uLength, pcInterned - sizeof(size_t), sizeof(uLength));
+    return uLength;
+}
+
+/* Return the index of the slot of the pool that holds the string equal
+   to pcKey, whose hash is uHash, or of the empty slot where it belongs. */
+static size_t SymTableIntern_findSlot(const char *pcKey, size_t uHash)
+{
+    size_t mask = sPool.slotCount - 1;
+    size_t i = uHash & mask;
+
+    while (sPool.slots[i] != NULL)
+    {
+        if (SymTableIntern_hash(sPool.slots[i]) == uHash
+            && strcmp(sPool.slots[i], pcKey) == 0)
+            break;
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+/* Give the pool's index slotCount slots, reinserting every interned
+   string. Return 1 on success, or 0 if memory is exhausted. */
+static int SymTableIntern_resize(size_t slotCount)
+{
+    const char **old_slots = sPool.slots;
+    size_t old_count = sPool.slotCount;
+    size_t i;
+
+    sPool.slots = (const char **) calloc(slotCount, sizeof(*sPool.slots));
+    if (sPool.slots == NULL) {sPool.slots = old_slots; return 0;}
+    sPool.slotCount = slotCount;
+
+    for (i = 0; i < old_count; i++)
+    {
+        if (old_slots[i] != NULL)
+            sPool.slots[SymTableIntern_findSlot(old_slots[i],
+                SymTableIntern_hash(old_slots[i]))] = old_slots[i];
+    }
+    free(old_slots);
+    return 1;
+}
+
+/* Return the pool's canonical copy of pcKey, adding one if there is
+   none, or NULL if memory is exhausted. */
+const char *SymTable_intern(const char *pcKey)
+{
+    size_t uHash;
+    size_t uLength;
+    size_t i;
+    char *pcCopy;
+
+    assert(pcKey != NULL);
+
+    if (sPool.slots == NULL)
+    {
+        SymTableArena_init(&sPool.arena, sizeof(size_t));
+        if (!SymTableIntern_resize(INITIAL_SLOT_COUNT)) {return NULL;}
+    }
+    else if (sPool.len >= sPool.slotCount / 2)
+    {
+        if (!SymTableIntern_resize(sPool.slotCount * 2)) {return NULL;}
+    }
+
+    uHash = SymTableIntern_hashKey(pcKey, &uLength);
+    i = SymTableIntern_findSlot(pcKey, uHash);
+    if (sPool.slots[i] != NULL) {return sPool.slots[i];}
+
+    pcCopy = SymTableArena_allocBytes(&sPool.arena, 2 * sizeof(size_t) + uLength + 1);
+    if (pcCopy == NULL) {return NULL;}
+    memcpy(pcCopy, &uHash, sizeof(uHash));
+    memcpy(pcCopy + sizeof(size_t), &uLength, sizeof(uLength));
+    pcCopy += 2 * sizeof(size_t);
+    memcpy(pcCopy, pcKey, uLength + 1);
+
+    sPool.slots[i] = pcCopy;
+    ++(sPool.len);
+    return pcCopy;
+}
+
+/* Free every string in the intern pool. */
+void SymTable_internFree(void)
+{
+    if (sPool.slots == NULL) {return;}
+    SymTableArena_free(&sPool.arena);
+    free(sPool.slots);
+    sPool.slots = NULL;
+    sPool.slotCount = 0;
+    sPool.len = 0;
+}
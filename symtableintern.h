@@ -0,0 +1,24 @@
+/*--------------------------------------------------------------------*/
+/* symtableintern.h                                                   */
+/* Author: Chinmayi R                                                 */
+/*--------------------------------------------------------------------*/
+#include <stddef.h>
+
+#ifndef SYMTABLEINTERN_INCLUDED
+#define SYMTABLEINTERN_INCLUDED
+
+/* Interface between the string intern pool and the SymTable
+   implementations. Clients use SymTable_intern and SymTable_internFree
+   from symtable.h instead. */
+
+/* Return the hash that the intern pool stored for pcInterned, a string
+   returned by SymTable_intern. It is the assignment's multiply-by-65599
+   hash of the string, so implementations built on that hash can use it
+   without reading the string. */
+size_t SymTableIntern_hash(const char *pcInterned);
+
+/* Return the length of pcInterned, a string returned by SymTable_intern,
+   without reading the string. */
+size_t SymTableIntern_length(const char *pcInterned);
+
+#endif
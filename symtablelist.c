@@ -3,39 +3,199 @@
 /* Author: Chinmayi R                                                 */
 /*--------------------------------------------------------------------*/
 #include "symtable.h"
+#include "symtablearena.h"
+#include "symtableparallel.h"
+#include "symtablestats.h"
+#include "symtabletrace.h"
+
+/* Size of the key buffer inside each node. Keys shorter than this are
+   stored in the node itself; longer keys are stored in the arena. */
+enum {INLINE_KEY_SIZE = 24};
+
+/* Values of the last byte of a node's inline_key when its key is at
+   long_key: KEY_ARENA if the node owns that copy in the arena, or
+   KEY_SHARED if it belongs to the intern pool. */
+enum {KEY_ARENA = 1, KEY_SHARED = 2};
 
 /* A Node_T object represents a single key-value binding within a symbol table. */
 typedef struct Node Node_T;
 /* Each node contains:
-   - key: a unique string identifier for the binding.
+   - next: a pointer to the next binding in a linked list.
    - value: a pointer to the associated data.
-   - next: a pointer to the next binding in a linked list. */
+   - key: a unique string identifier for the binding, either stored in
+     key.inline_key, or at key.long_key with the last byte of
+     key.inline_key set to KEY_ARENA or KEY_SHARED. */
 struct Node {
-    /* Unique string identifier */
-    const char *key;   
-    /* Pointer to associated data */
-    const void *value; 
     /* Pointer to next node in the list */
     struct Node *next; 
+    /* Pointer to associated data */
+    const void *value; 
+    /* Unique string identifier, inline if short enough */
+    union {
+        char inline_key[INLINE_KEY_SIZE];
+        char *long_key;
+    } key;
 };
 
 /* A SymTable_T object represents a symbol table implemented as a linked list.
    It contains:
    - first: a pointer to the first node in the list.
-   - len: the number of key-value bindings stored in the table. */
+   - len: the number of key-value bindings stored in the table.
+   - arena: the per-table allocator for nodes and keys.
+   - reorder: how a successful lookup reorders the list.
+   - stats: in a build with SYMTABLE_STATS, the instrumentation
+     counters. */
 struct SymTable {
     /* Pointer to first node in linked list */
     struct Node *first; 
     /* Number of key-value bindings */
     size_t len;         
+    /* Slab of nodes and size-classed key storage */
+    struct SymTableArena arena;
+    /* Self-organizing mode, SYMTABLE_REORDER_NONE unless set */
+    enum SymTable_Reorder reorder;
+#ifdef SYMTABLE_STATS
+    /* Instrumentation counters */
+    struct SymTableStats stats;
+#endif
+#ifdef SYMTABLE_TRACE
+    /* Id of the table in the trace */
+    size_t traceId;
+#endif
 };
 
-/* Free the memory associated with the Node pointer pBinding, including
-   its key but not the value it points to. */
-static void SymTable_node_free(Node_T *pBinding){ /* function name Node_free does not match module name symtablelist.c. Should I replace? */
+/* Return the key of the node pBinding. */
+static const char *SymTable_node_key(const Node_T *pBinding)
+{
+    assert(pBinding != NULL);
+    if (pBinding->key.inline_key[INLINE_KEY_SIZE - 1] == '\0')
+        return pBinding->key.inline_key;
+    return pBinding->key.long_key;
+}
+
+/* Store pcKey, which has length uLength, in pBinding. If iShared, store
+   the pointer pcKey itself; otherwise store a copy, inline if it fits and
+   in the arena of oSymTable if not. Return 1 on success, or 0 if memory
+   is exhausted. */
+static int SymTable_node_setKey(SymTable_T oSymTable, Node_T *pBinding, const char *pcKey,
+                                size_t uLength, int iShared)
+{
+    char *long_key;
+
+    assert(oSymTable != NULL);
+    assert(pBinding != NULL);
+
+    if (iShared)
+    {
+        pBinding->key.inline_key[INLINE_KEY_SIZE - 1] = KEY_SHARED;
+        pBinding->key.long_key = (char *)pcKey;
+        return 1;
+    }
+    if (uLength < INLINE_KEY_SIZE)
+    {
+        memset(pBinding->key.inline_key, 0, INLINE_KEY_SIZE);
+        memcpy(pBinding->key.inline_key, pcKey, uLength);
+        return 1;
+    }
+    long_key = SymTableArena_allocBytes(&oSymTable->arena, uLength + 1);
+    if (long_key == NULL) {return 0;}
+    memcpy(long_key, pcKey, uLength);
+    long_key[uLength] = '\0';
+    pBinding->key.inline_key[INLINE_KEY_SIZE - 1] = KEY_ARENA;
+    pBinding->key.long_key = long_key;
+    return 1;
+}
+
+/* Reorder oSymTable as its mode says after a lookup found the node
+   *ppLink. ppPrevLink is the link to the node before it, or NULL if the
+   node is first. Move-to-front pulls the node to the head of the list;
+   transpose swaps it with the node before it. */
+static void SymTable_node_promote(SymTable_T oSymTable, Node_T **ppLink, Node_T **ppPrevLink)
+{
+    Node_T *pBinding = *ppLink;
+    Node_T *pPrev;
+
+    if (ppPrevLink == NULL) {return;}
+    switch (oSymTable->reorder)
+    {
+    case SYMTABLE_REORDER_MOVE_TO_FRONT:
+        *ppLink = pBinding->next;
+        pBinding->next = oSymTable->first;
+        oSymTable->first = pBinding;
+        break;
+    case SYMTABLE_REORDER_TRANSPOSE:
+        pPrev = *ppPrevLink;
+        pPrev->next = pBinding->next;
+        pBinding->next = pPrev;
+        *ppPrevLink = pBinding;
+        break;
+    default:
+        break;
+    }
+}
+
+/* Return the node of oSymTable whose key is pcKey, or NULL if there is
+   none. The node found is promoted as the table's mode says. */
+static Node_T *SymTable_node_find(SymTable_T oSymTable, const char *pcKey)
+{
+    Node_T **ppLink;
+    Node_T **ppPrevLink = NULL;
+    Node_T *pBinding;
+    size_t uProbes = 0;
+
+    for (ppLink = &oSymTable->first; *ppLink != NULL; ppLink = &(*ppLink)->next)
+    {
+        pBinding = *ppLink;
+        SymTableStats_probe(uProbes);
+        if (strcmp(SymTable_node_key(pBinding), pcKey) == 0)
+        {
+            SymTableStats_lookup(&oSymTable->stats, uProbes, 1);
+            SymTable_node_promote(oSymTable, ppLink, ppPrevLink);
+            return pBinding;
+        }
+        ppPrevLink = ppLink;
+    }
+    SymTableStats_lookup(&oSymTable->stats, uProbes, 0);
+    return NULL;
+}
+
+/* Return the node of oSymTable whose key is the uLength characters at
+   pcKey, which need not be NUL-terminated, or NULL if there is none.
+   The node found is promoted as the table's mode says. */
+static Node_T *SymTable_node_findN(SymTable_T oSymTable, const char *pcKey, size_t uLength)
+{
+    Node_T **ppLink;
+    Node_T **ppPrevLink = NULL;
+    Node_T *pBinding;
+    const char *key;
+    size_t uProbes = 0;
+
+    for (ppLink = &oSymTable->first; *ppLink != NULL; ppLink = &(*ppLink)->next)
+    {
+        pBinding = *ppLink;
+        SymTableStats_probe(uProbes);
+        key = SymTable_node_key(pBinding);
+        if (strncmp(key, pcKey, uLength) == 0 && key[uLength] == '\0')
+        {
+            SymTableStats_lookup(&oSymTable->stats, uProbes, 1);
+            SymTable_node_promote(oSymTable, ppLink, ppPrevLink);
+            return pBinding;
+        }
+        ppPrevLink = ppLink;
+    }
+    SymTableStats_lookup(&oSymTable->stats, uProbes, 0);
+    return NULL;
+}
+
+/* Return the Node pointer pBinding, and the copy of its key if it owns
+   one, to the arena of oSymTable for reuse by a later put. */
+static void SymTable_node_free(SymTable_T oSymTable, Node_T *pBinding){ /* function name Node_free does not match module name symtablelist.c. Should I replace? */
+    assert(oSymTable != NULL);
     assert(pBinding != NULL);
-    free((char *)pBinding->key);
-    free(pBinding);
+    if (pBinding->key.inline_key[INLINE_KEY_SIZE - 1] == KEY_ARENA)
+        SymTableArena_freeBytes(&oSymTable->arena, pBinding->key.long_key,
+                                strlen(pBinding->key.long_key) + 1);
+    SymTableArena_freeBlock(&oSymTable->arena, pBinding);
 }
 
 /* Why are we making a list with just pointer first, cant we directly refer to list using a pointer: SymTable *root = ...*/
@@ -49,27 +209,39 @@ SymTable_T SymTable_new(void)
  pSymtable = calloc(1, sizeof(*pSymtable));
  if(pSymtable == NULL) {return NULL;}
  pSymtable->len = 0;
+ SymTableArena_init(&pSymtable->arena, sizeof(Node_T));
+ SymTableTrace_created(pSymtable);
  return pSymtable;
 }
 
+/* A linked list compares keys without hashing them, so create a table
+   exactly as SymTable_new does whatever eHashFunction is. */
+SymTable_T SymTable_newWithHash(enum SymTable_HashFunction eHashFunction)
+{
+ (void) eHashFunction;
+ return SymTable_new();
+}
+
 /* Free all memory associated with the symbol table oSymTable, 
-   including all bindings and the table structure itself. */
+   including all bindings and the table structure itself. Nodes and
+   keys are released a chunk at a time with the arena. */
 void SymTable_free(SymTable_T oSymTable)
 {
-    Node_T *pBinding = oSymTable->first;
-    Node_T *next;
-
     assert(oSymTable != NULL);
 
-    for ( ; pBinding != NULL; pBinding = next) {
-        next = pBinding->next;
-        SymTable_node_free(pBinding);
-    }
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_FREE, NULL, 0);
+    SymTableArena_free(&oSymTable->arena);
     free(oSymTable);
 }
 
 /* Return the number of key-value bindings stored in the symbol table oSymTable. */
-size_t SymTable_getLength(SymTable_T oSymTable){assert(oSymTable != NULL); return oSymTable->len;}
+size_t SymTable_getLength(SymTable_T oSymTable)
+{
+    assert(oSymTable != NULL);
+
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_LENGTH, NULL, 0);
+    return oSymTable->len;
+}
 
 /* Insert a new binding with key pcKey and value pvValue into the symbol table oSymTable. 
    If pcKey already exists in oSymTable, the function does nothing and returns 0.
@@ -81,12 +253,12 @@ int SymTable_put(SymTable_T oSymTable, const char *pcKey, const void *pvValue)
     assert(oSymTable != NULL);
     assert(pcKey != NULL);
 
-    if(SymTable_contains(oSymTable, pcKey)){return 0;}
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_PUT, pcKey, strlen(pcKey));
+    if(SymTable_node_find(oSymTable, pcKey) != NULL){return 0;}
 
-    newNode = (Node_T *) calloc(1, sizeof(Node_T));
+    newNode = (Node_T *) SymTableArena_allocBlock(&oSymTable->arena);
     if(newNode == NULL) {return 0;}
-    newNode->key = (const char*)malloc(strlen(pcKey) + 1);
-    strcpy((char*)newNode->key, pcKey);
+    if(!SymTable_node_setKey(oSymTable, newNode, pcKey, strlen(pcKey), 0)) {SymTableArena_freeBlock(&oSymTable->arena, newNode); return 0;}
     newNode->value = pvValue;
     newNode->next = oSymTable->first;
     oSymTable->first = newNode;
@@ -98,61 +270,46 @@ int SymTable_put(SymTable_T oSymTable, const char *pcKey, const void *pvValue)
    Returns the old value associated with pcKey if it exists, otherwise returns NULL. */
 void *SymTable_replace(SymTable_T oSymTable, const char *pcKey, const void *pvValue)
 {
-    Node_T *pBinding = oSymTable->first;
+    Node_T *pBinding;
     const void *temp;
     
     assert(oSymTable != NULL);
     assert(pcKey != NULL);
     /*assert(pvValue != NULL);*/
 
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_REPLACE, pcKey, strlen(pcKey));
+    pBinding = SymTable_node_find(oSymTable, pcKey);
     if (pBinding == NULL) {return NULL;}
 
-    for (; pBinding != NULL; pBinding = pBinding->next)
-    {
-        if (strcmp(pBinding->key, pcKey) == 0) {
-            temp = pBinding->value;
-            pBinding->value = pvValue;
-            return (void *) temp;}
-    }
-    return NULL;
+    temp = pBinding->value;
+    pBinding->value = pvValue;
+    return (void *) temp;
 }
 
 /* Check if the symbol table oSymTable contains a binding for pcKey. 
    Returns 1 if pcKey is found, 0 otherwise. */
 int SymTable_contains(SymTable_T oSymTable, const char *pcKey)
 {
-    Node_T *pBinding = oSymTable->first;
-    
     assert(oSymTable != NULL);
     assert(pcKey != NULL);
 
-    if (pBinding == NULL) {return 0;}
-
-    for (; pBinding != NULL; pBinding = pBinding->next) 
-    {
-        if (strcmp(pBinding->key, pcKey) == 0) 
-            return 1;
-    }
-    return 0;
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_CONTAINS, pcKey, strlen(pcKey));
+    return SymTable_node_find(oSymTable, pcKey) != NULL;
 }
 
 /* Retrieve the value associated with pcKey in the symbol table oSymTable.
    Returns NULL if pcKey is not found. */
 void *SymTable_get(SymTable_T oSymTable, const char *pcKey)
 {
-    Node_T *pBinding = oSymTable->first;
+    Node_T *pBinding;
 
     assert(oSymTable != NULL);
     assert(pcKey != NULL);
 
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_GET, pcKey, strlen(pcKey));
+    pBinding = SymTable_node_find(oSymTable, pcKey);
     if (pBinding == NULL) {return NULL;}
-
-    for (; pBinding != NULL; pBinding = pBinding->next) 
-    {
-        if (strcmp(pBinding->key, pcKey) == 0) 
-            return (void *) pBinding->value;
-    }
-    return NULL;
+    return (void *) pBinding->value;
 }
 
 /* Remove the binding for pcKey from the symbol table oSymTable, freeing its memory.
@@ -162,24 +319,29 @@ void *SymTable_remove(SymTable_T oSymTable, const char *pcKey)
     Node_T *pBinding = oSymTable->first;
     Node_T *prev;
     const void *temp;
+    size_t uProbes = 0;
     
     assert(oSymTable != NULL);
     assert(pcKey != NULL);
 
-    if (pBinding == NULL) {return NULL;}
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_REMOVE, pcKey, strlen(pcKey));
+    if (pBinding == NULL) {SymTableStats_lookup(&oSymTable->stats, uProbes, 0); return NULL;}
 
     prev = NULL;
     for ( ; pBinding != NULL; pBinding = pBinding->next) {
-        if (strcmp(pBinding->key, pcKey) == 0) { /* Diff from above!!!!! Note differences!!!*/
+        SymTableStats_probe(uProbes);
+        if (strcmp(SymTable_node_key(pBinding), pcKey) == 0) { /* Diff from above!!!!! Note differences!!!*/
+            SymTableStats_lookup(&oSymTable->stats, uProbes, 1);
             if (prev == NULL) {oSymTable->first = pBinding->next;}
             else {prev->next = pBinding->next;}
             --(oSymTable->len);
             temp = pBinding->value;
-            SymTable_node_free(pBinding);
+            SymTable_node_free(oSymTable, pBinding);
             return (void *) temp;
         }
         prev = pBinding;
     }
+    SymTableStats_lookup(&oSymTable->stats, uProbes, 0);
     return NULL;
 }
 
@@ -194,6 +356,376 @@ void SymTable_map(SymTable_T oSymTable, void (*pfApply)(const char *pcKey, void
 
     /*assert(pfApply != NULL);Can It be null?? Is assert needed*/
 
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_MAP, NULL, 0);
     for ( ; pBinding != NULL; pBinding = pBinding->next)
-    (*pfApply)(pBinding->key, (void *) pBinding->value, (void *) pvExtra); /* Am I supposed to cast here with (void *) like this?*/
-}
\ No newline at end of file
+    (*pfApply)(SymTable_node_key(pBinding), (void *) pBinding->value, (void *) pvExtra); /* Am I supposed to cast here with (void *) like this?*/
+}
+
+/* Apply pfApply to each binding of oSymTable in list order until it
+   returns nonzero, and return that value, or 0 if it never does. */
+int SymTable_mapUntil(SymTable_T oSymTable,
+                      int (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+                      const void *pvExtra)
+{
+    Node_T *pBinding;
+    int iResult;
+
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    for (pBinding = oSymTable->first; pBinding != NULL; pBinding = pBinding->next)
+    {
+        iResult = (*pfApply)(SymTable_node_key(pBinding), (void *) pBinding->value, (void *) pvExtra);
+        if (iResult != 0) {return iResult;}
+    }
+    return 0;
+}
+
+/* Start a traversal of oSymTable in *psIter at the first node. */
+void SymTable_iterBegin(SymTable_T oSymTable, struct SymTable_Iter *psIter)
+{
+    assert(oSymTable != NULL);
+    assert(psIter != NULL);
+
+    psIter->pvNext = oSymTable->first;
+    psIter->uIndex = 0;
+}
+
+/* Store the key and value of the node *psIter has reached in *ppcKey
+   and *ppvValue, unless they are NULL, and move *psIter to the next
+   node. Returns 1, or 0 if the traversal has passed the last node. */
+int SymTable_iterNext(SymTable_T oSymTable, struct SymTable_Iter *psIter,
+                      const char **ppcKey, void **ppvValue)
+{
+    const Node_T *pBinding;
+
+    assert(oSymTable != NULL);
+    assert(psIter != NULL);
+
+    pBinding = (const Node_T *) psIter->pvNext;
+    if (pBinding == NULL) {return 0;}
+    if (ppcKey != NULL) {*ppcKey = SymTable_node_key(pBinding);}
+    if (ppvValue != NULL) {*ppvValue = (void *) pBinding->value;}
+    psIter->pvNext = pBinding->next;
+    return 1;
+}
+
+/* Apply pfApply to each binding of oSymTable from up to uThreadCount
+   threads. A linked list cannot be split between threads, so the bindings are
+   gathered into an array first. */
+void SymTable_mapParallel(SymTable_T oSymTable,
+                          void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+                          const void *pvExtra, size_t uThreadCount)
+{
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    SymTableParallel_mapGathered(oSymTable, oSymTable->len, pfApply, pvExtra, uThreadCount);
+}
+
+/* Like SymTable_mapParallel, but with an accumulator per thread that is
+   merged into *pvResult at the end. */
+void SymTable_mapReduce(SymTable_T oSymTable,
+                        void (*pfApply)(const char *pcKey, void *pvValue,
+                                        void *pvAccumulator, void *pvExtra),
+                        void (*pfMerge)(void *pvResult, const void *pvAccumulator, void *pvExtra),
+                        size_t uAccumulatorSize, void *pvResult, const void *pvExtra,
+                        size_t uThreadCount)
+{
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    SymTableParallel_reduceGathered(oSymTable, oSymTable->len, pfApply, pfMerge,
+                                    uAccumulatorSize, pvResult, pvExtra, uThreadCount);
+}
+
+/* A linked list never resizes, so reject any maximum load factor and
+   return 0. */
+int SymTable_setMaxLoadFactor(SymTable_T oSymTable, double dMaxLoadFactor)
+{
+    assert(oSymTable != NULL);
+    (void) dMaxLoadFactor;
+    return 0;
+}
+
+/* A linked list has no buckets to presize, and its nodes come from the
+   arena as bindings are put, so there is nothing to reserve; return 1. */
+int SymTable_reserve(SymTable_T oSymTable, size_t uCount)
+{
+    assert(oSymTable != NULL);
+    (void) uCount;
+    return 1;
+}
+
+/* A linked list holds no spare buckets, so there is nothing to shrink. */
+void SymTable_shrinkToFit(SymTable_T oSymTable)
+{
+    assert(oSymTable != NULL);
+}
+
+/* A linked list never resizes, so it cannot resize incrementally either;
+   return 0. */
+int SymTable_setIncrementalResize(SymTable_T oSymTable, int iEnabled)
+{
+    assert(oSymTable != NULL);
+    (void) iEnabled;
+    return 0;
+}
+
+/* Set the self-organizing mode of oSymTable to eReorder, which takes
+   effect from the next lookup. Returns 1. */
+int SymTable_setReorder(SymTable_T oSymTable, enum SymTable_Reorder eReorder)
+{
+    assert(oSymTable != NULL);
+    assert(eReorder == SYMTABLE_REORDER_NONE || eReorder == SYMTABLE_REORDER_MOVE_TO_FRONT
+           || eReorder == SYMTABLE_REORDER_TRANSPOSE);
+
+    oSymTable->reorder = eReorder;
+    return 1;
+}
+
+/* Fill *psStats with the state of oSymTable, reporting its single list
+   as one bucket that never grows. In a build with SYMTABLE_STATS, also
+   report its counters, the list as its one chain, and the memory held
+   by its arena. */
+void SymTable_getStats(SymTable_T oSymTable, struct SymTable_Stats *psStats)
+{
+    assert(oSymTable != NULL);
+    assert(psStats != NULL);
+
+    psStats->uLength = oSymTable->len;
+    psStats->uBucketCount = 1;
+    psStats->uGrowAt = (size_t)-1;
+    psStats->uShrinkAt = 0;
+    psStats->uResizeCount = 0;
+    psStats->dLoadFactor = (double)oSymTable->len;
+    psStats->dMaxLoadFactor = 0.0;
+
+    SymTableStats_clear(psStats);
+#ifdef SYMTABLE_STATS
+    SymTableStats_report(&oSymTable->stats, psStats);
+    SymTableStats_addChain(psStats, oSymTable->len);
+    psStats->uBytesAllocated = sizeof(*oSymTable) + oSymTable->arena.bytesReserved;
+#endif
+}
+
+/* Insert a new binding with the interned key pcInterned and value pvValue
+   into oSymTable, sharing the intern pool's copy of the key. If the key
+   already exists, does nothing and returns 0. Returns 1 on success. */
+int SymTable_putInterned(SymTable_T oSymTable, const char *pcInterned, const void *pvValue)
+{
+    Node_T *newNode;
+
+    assert(oSymTable != NULL);
+    assert(pcInterned != NULL);
+
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_PUT, pcInterned, strlen(pcInterned));
+    if(SymTable_node_find(oSymTable, pcInterned) != NULL){return 0;}
+
+    newNode = (Node_T *) SymTableArena_allocBlock(&oSymTable->arena);
+    if(newNode == NULL) {return 0;}
+    SymTable_node_setKey(oSymTable, newNode, pcInterned, 0, 1);
+    newNode->value = pvValue;
+    newNode->next = oSymTable->first;
+    oSymTable->first = newNode;
+    ++(oSymTable->len);
+    return 1;
+}
+
+/* Retrieve the value associated with the interned key pcInterned in
+   oSymTable. Nodes that share the pointer pcInterned match without
+   strcmp. Returns NULL if the key is not found. */
+void *SymTable_getInterned(SymTable_T oSymTable, const char *pcInterned)
+{
+    Node_T **ppLink;
+    Node_T **ppPrevLink = NULL;
+    Node_T *pBinding;
+    const char *key;
+    size_t uProbes = 0;
+
+    assert(oSymTable != NULL);
+    assert(pcInterned != NULL);
+
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_GET, pcInterned, strlen(pcInterned));
+    for (ppLink = &oSymTable->first; *ppLink != NULL; ppLink = &(*ppLink)->next)
+    {
+        pBinding = *ppLink;
+        SymTableStats_probe(uProbes);
+        key = SymTable_node_key(pBinding);
+        if (key == pcInterned || strcmp(key, pcInterned) == 0)
+        {
+            SymTableStats_lookup(&oSymTable->stats, uProbes, 1);
+            SymTable_node_promote(oSymTable, ppLink, ppPrevLink);
+            return (void *) pBinding->value;
+        }
+        ppPrevLink = ppLink;
+    }
+    SymTableStats_lookup(&oSymTable->stats, uProbes, 0);
+    return NULL;
+}
+
+/* Return the multiply-by-65599 hash of the uLength characters at pcKey.
+   The list does not use hashes, but accepts them for compatibility with
+   the hash table implementations. */
+size_t SymTable_hashKey(SymTable_T oSymTable, const char *pcKey, size_t uLength)
+{
+    const size_t HASH_MULTIPLIER = 65599;
+    size_t u;
+    size_t uHash = 0;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    for (u = 0; u < uLength; u++)
+        uHash = uHash * HASH_MULTIPLIER + (size_t)pcKey[u];
+    return uHash;
+}
+
+/* Insert a new binding whose key is the uLength characters at pcKey and
+   whose value is pvValue into oSymTable. If the key already exists,
+   does nothing and returns 0. Returns 1 on success. */
+int SymTable_putN(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+                  const void *pvValue)
+{
+    Node_T *newNode;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_PUT, pcKey, uLength);
+    if(SymTable_node_findN(oSymTable, pcKey, uLength) != NULL){return 0;}
+
+    newNode = (Node_T *) SymTableArena_allocBlock(&oSymTable->arena);
+    if(newNode == NULL) {return 0;}
+    if(!SymTable_node_setKey(oSymTable, newNode, pcKey, uLength, 0)) {SymTableArena_freeBlock(&oSymTable->arena, newNode); return 0;}
+    newNode->value = pvValue;
+    newNode->next = oSymTable->first;
+    oSymTable->first = newNode;
+    ++(oSymTable->len);
+    return 1;
+}
+
+/* Retrieve the value associated with the uLength characters at pcKey in
+   oSymTable. Returns NULL if the key is not found. */
+void *SymTable_getN(SymTable_T oSymTable, const char *pcKey, size_t uLength)
+{
+    Node_T *pBinding;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_GET, pcKey, uLength);
+    pBinding = SymTable_node_findN(oSymTable, pcKey, uLength);
+    if (pBinding == NULL) {return NULL;}
+    return (void *) pBinding->value;
+}
+
+/* Same as SymTable_putN; the list ignores uHash. */
+int SymTable_putHashed(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+                       size_t uHash, const void *pvValue)
+{
+    (void)uHash;
+    return SymTable_putN(oSymTable, pcKey, uLength, pvValue);
+}
+
+/* Same as SymTable_getN; the list ignores uHash. */
+void *SymTable_getHashed(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+                         size_t uHash)
+{
+    (void)uHash;
+    return SymTable_getN(oSymTable, pcKey, uLength);
+}
+
+/* Return a pointer to the value of the binding of oSymTable whose key is
+   pcKey, first inserting a binding with value pvValue at the front of
+   the list if there is none. Set *piCreated, if piCreated is not NULL,
+   to 1 if a binding was inserted and to 0 otherwise. The list is walked
+   once. Returns NULL if memory is exhausted. */
+const void **SymTable_getOrPut(SymTable_T oSymTable, const char *pcKey,
+                               const void *pvValue, int *piCreated)
+{
+    Node_T *pBinding;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_GET_OR_PUT, pcKey, strlen(pcKey));
+    if (piCreated != NULL) {*piCreated = 0;}
+    pBinding = SymTable_node_find(oSymTable, pcKey);
+    if (pBinding != NULL) {return &pBinding->value;}
+
+    pBinding = (Node_T *) SymTableArena_allocBlock(&oSymTable->arena);
+    if(pBinding == NULL) {return NULL;}
+    if(!SymTable_node_setKey(oSymTable, pBinding, pcKey, strlen(pcKey), 0)) {SymTableArena_freeBlock(&oSymTable->arena, pBinding); return NULL;}
+    pBinding->value = pvValue;
+    pBinding->next = oSymTable->first;
+    oSymTable->first = pBinding;
+    ++(oSymTable->len);
+    if (piCreated != NULL) {*piCreated = 1;}
+    return &pBinding->value;
+}
+
+/* Store in ppvValues[i] the value associated with ppcKeys[i] in
+   oSymTable, or NULL if it is absent, for each i below uCount. The list
+   has no buckets to prefetch, so this is a loop over SymTable_get. */
+void SymTable_getBatch(SymTable_T oSymTable, const char *const *ppcKeys,
+                       size_t uCount, void **ppvValues)
+{
+    size_t u;
+
+    assert(oSymTable != NULL);
+    assert(ppcKeys != NULL || uCount == 0);
+    assert(ppvValues != NULL || uCount == 0);
+
+    for (u = 0; u < uCount; u++)
+        ppvValues[u] = SymTable_get(oSymTable, ppcKeys[u]);
+}
+
+/* Put a binding of ppcKeys[i] to ppvValues[i] into oSymTable for each i
+   below uCount, in order, as SymTable_put would. If piResults is not
+   NULL, store SymTable_put's result for each key in piResults[i].
+   Returns the number of bindings inserted. */
+size_t SymTable_putBatch(SymTable_T oSymTable, const char *const *ppcKeys,
+                         const void *const *ppvValues, size_t uCount, int *piResults)
+{
+    size_t u;
+    size_t uInserted = 0;
+    int iResult;
+
+    assert(oSymTable != NULL);
+    assert(ppcKeys != NULL || uCount == 0);
+    assert(ppvValues != NULL || uCount == 0);
+
+    for (u = 0; u < uCount; u++)
+    {
+        iResult = SymTable_put(oSymTable, ppcKeys[u], ppvValues[u]);
+        if (piResults != NULL) {piResults[u] = iResult;}
+        uInserted += (size_t)iResult;
+    }
+    return uInserted;
+}
+
+/* Remove the binding for ppcKeys[i] from oSymTable for each i below
+   uCount, in order, and store the value it had, or NULL if it was
+   absent, in ppvValues[i] unless ppvValues is NULL. Returns the number
+   of bindings removed. */
+size_t SymTable_removeBatch(SymTable_T oSymTable, const char *const *ppcKeys,
+                            size_t uCount, void **ppvValues)
+{
+    size_t u;
+    size_t uRemoved = 0;
+    size_t uOldLength;
+    void *pvValue;
+
+    assert(oSymTable != NULL);
+    assert(ppcKeys != NULL || uCount == 0);
+
+    for (u = 0; u < uCount; u++)
+    {
+        uOldLength = oSymTable->len;
+        pvValue = SymTable_remove(oSymTable, ppcKeys[u]);
+        uRemoved += uOldLength - oSymTable->len;
+        if (ppvValues != NULL) {ppvValues[u] = pvValue;}
+    }
+    return uRemoved;
+}
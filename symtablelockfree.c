@@ -0,0 +1,700 @@
+/*--------------------------------------------------------------------*/
+/* symtablelockfree.c                                                 */
+/* Author: Chinmayi R                                                 */
+/*--------------------------------------------------------------------*/
+#include "symtable.h"
+#include <pthread.h>
+
+/* A thread-safe chained hash table for read-mostly use. It implements
+   the core functions of symtable.h (SymTable_new through SymTable_map).
+
+   Readers (SymTable_get and SymTable_contains) take no locks and perform
+   no atomic read-modify-write operations: they announce the current
+   epoch in a per-thread record, follow acquire loads from the bucket
+   array to the binding, and clear the announcement. Writers serialize on
+   a per-table mutex and publish new bindings and bucket arrays with
+   release stores. A resize builds a new bucket array of copied bindings,
+   so a reader on the old array always sees complete chains.
+
+   Unlinked bindings and replaced bucket arrays are retired rather than
+   freed. Every retired object records the global epoch read after it
+   was unlinked, with a sequentially consistent fence between the unlink
+   and the read that pairs with the fence after a reader's announcement.
+   So a reader that announced a later epoch cannot see the object, and
+   it is freed once the epoch has advanced twice since. The epoch only
+   advances when every reader that is inside a lookup has announced the
+   current epoch, so no reader can still hold a pointer to a freed
+   object.
+
+   Requires the GCC __atomic builtins. */
+
+/* Number of buckets of a new table. */
+enum {INITIAL_BUCKET_COUNT = 509};
+
+/* Number of retired objects a table accumulates before a writer tries
+   to advance the epoch and free them. */
+enum {RECLAIM_THRESHOLD = 64};
+
+/* Size of the key buffer inside each binding. Keys shorter than this are
+   stored in the binding itself; longer keys are stored on the heap. */
+enum {INLINE_KEY_SIZE = 24};
+
+/* Default maximum load factor (bindings per bucket) before a put grows
+   the table. Can be overridden at build time with
+   -DSYMTABLE_MAX_LOAD_FACTOR. */
+#ifndef SYMTABLE_MAX_LOAD_FACTOR
+#define SYMTABLE_MAX_LOAD_FACTOR 1.0
+#endif
+
+/* Atomic accesses to fields that readers and writers share. */
+#define SymTable_loadAcquire(p) __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define SymTable_storeRelease(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+
+/* A Binding_T object represents a single key-value pair within a symbol table. */
+typedef struct Binding Binding_T;
+/* Each binding contains:
+   - next: a pointer to the next binding in a linked list, read by
+     readers with acquire loads.
+   - hash: the full hash of key.
+   - value: a pointer to the associated data, read by readers with
+     acquire loads.
+   - limbo, retired: the next retired binding of the table and the epoch
+     at which this one was retired, used only by writers.
+   - ownsKey: whether freeing the binding frees a long key, which is
+     false once a resize has copied the binding.
+   - key: a unique string identifier for the binding, either stored in
+     key.inline_key, or on the heap at key.long_key with the last byte
+     of key.inline_key set to 1 to tell the two apart. */
+struct Binding {
+    /* Pointer to next node in the list */
+    struct Binding *next;
+
+    /* Full hash of key */
+    size_t hash;
+
+    /* Pointer to associated data */
+    const void *value;
+
+    /* Next retired binding */
+    struct Binding *limbo;
+
+    /* Epoch at which the binding was retired */
+    unsigned long retired;
+
+    /* Whether the binding owns key.long_key */
+    int ownsKey;
+
+    /* Unique string identifier, inline if short enough */
+    union {
+        char inline_key[INLINE_KEY_SIZE];
+        char *long_key;
+    } key;
+};
+
+/* A Buckets object is a bucket array together with its size, so that a
+   reader gets a consistent pair from one pointer load. */
+struct Buckets {
+    /* Number of buckets */
+    size_t size;
+
+    /* Next retired bucket array */
+    struct Buckets *limbo;
+
+    /* Epoch at which the array was retired */
+    unsigned long retired;
+
+    /* First binding of each bucket, read by readers with acquire loads */
+    struct Binding *heads[];
+};
+
+/* A SymTable object represents a hash table. It contains:
+   - buckets: the current bucket array, read by readers with an acquire
+     load.
+   - len: the number of key-value bindings.
+   - growAt: the value of len at which the next put grows the table.
+   - lock: the mutex that serializes writers.
+   - retiredBindings, retiredBuckets, retiredCount: the objects that
+     writers have unlinked but not yet freed, newest first.
+   - reclaimedAt: the global epoch at the last reclamation attempt. */
+struct SymTable {
+    /* Current bucket array */
+    struct Buckets *buckets;
+
+    /* Number of key-value bindings */
+    size_t len;
+
+    /* Length at which the next put grows the table */
+    size_t growAt;
+
+    /* Writer mutex */
+    pthread_mutex_t lock;
+
+    /* Retired bindings, newest first */
+    struct Binding *retiredBindings;
+
+    /* Retired bucket arrays, newest first */
+    struct Buckets *retiredBuckets;
+
+    /* Number of retired objects */
+    size_t retiredCount;
+
+    /* Global epoch at the last reclamation attempt */
+    unsigned long reclaimedAt;
+};
+
+/* A Reader object is the epoch announcement of one thread. epoch is the
+   global epoch the thread observed when it entered its current lookup,
+   or 0 outside lookups. Records are never freed; a thread's record is
+   released for reuse when the thread exits. */
+struct Reader {
+    /* Announced epoch, or 0 */
+    unsigned long epoch;
+
+    /* Next record of the registry */
+    struct Reader *next;
+
+    /* Whether a live thread owns the record */
+    int inUse;
+};
+
+/* The global epoch shared by every table. It starts at 1 so that 0 can
+   mean "not reading". */
+static unsigned long ulEpoch = 1;
+
+/* The registry of reader records, and the mutex guarding its changes.
+   Writers walk it without the mutex using acquire loads. */
+static struct Reader *psReaders = NULL;
+static pthread_mutex_t sReadersLock = PTHREAD_MUTEX_INITIALIZER;
+
+/* The thread-specific key that holds each thread's reader record. */
+static pthread_key_t sReaderKey;
+static pthread_once_t sReaderKeyOnce = PTHREAD_ONCE_INIT;
+static int iReaderKeyValid = 0;
+
+/* Release the reader record pvReader of an exiting thread. */
+static void SymTable_readerExit(void *pvReader)
+{
+    struct Reader *psReader = (struct Reader *)pvReader;
+    SymTable_storeRelease(&psReader->epoch, 0UL);
+    pthread_mutex_lock(&sReadersLock);
+    psReader->inUse = 0;
+    pthread_mutex_unlock(&sReadersLock);
+}
+
+/* Create the thread-specific key of reader records. */
+static void SymTable_readerKeyInit(void)
+{
+    iReaderKeyValid = pthread_key_create(&sReaderKey, SymTable_readerExit) == 0;
+}
+
+/* Return the calling thread's reader record, registering one on the
+   thread's first lookup, or NULL if memory is exhausted. */
+static struct Reader *SymTable_reader(void)
+{
+    struct Reader *psReader;
+
+    pthread_once(&sReaderKeyOnce, SymTable_readerKeyInit);
+    if (!iReaderKeyValid) {return NULL;}
+    psReader = (struct Reader *) pthread_getspecific(sReaderKey);
+    if (psReader != NULL) {return psReader;}
+
+    pthread_mutex_lock(&sReadersLock);
+    for (psReader = psReaders; psReader != NULL; psReader = psReader->next)
+        if (!psReader->inUse) {break;}
+    if (psReader == NULL)
+    {
+        psReader = (struct Reader *) calloc(1, sizeof(*psReader));
+        if (psReader != NULL)
+        {
+            psReader->next = psReaders;
+            SymTable_storeRelease(&psReaders, psReader);
+        }
+    }
+    if (psReader != NULL) {psReader->inUse = 1;}
+    pthread_mutex_unlock(&sReadersLock);
+
+    if (psReader != NULL && pthread_setspecific(sReaderKey, psReader) != 0)
+    {
+        pthread_mutex_lock(&sReadersLock);
+        psReader->inUse = 0;
+        pthread_mutex_unlock(&sReadersLock);
+        psReader = NULL;
+    }
+    return psReader;
+}
+
+/* Announce that psReader is entering a lookup. The fence orders the
+   announcement before every load of the lookup, and pairs with the
+   fences in SymTable_advanceEpoch and SymTable_retireEpoch. */
+static void SymTable_readEnter(struct Reader *psReader)
+{
+    __atomic_store_n(&psReader->epoch, SymTable_loadAcquire(&ulEpoch), __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+/* Announce that psReader has left its lookup. */
+static void SymTable_readExit(struct Reader *psReader)
+{
+    SymTable_storeRelease(&psReader->epoch, 0UL);
+}
+
+/* Advance the global epoch if every reader inside a lookup has
+   announced it, and return the global epoch. */
+static unsigned long SymTable_advanceEpoch(void)
+{
+    struct Reader *psReader;
+    unsigned long ulCurrent;
+    unsigned long ulSeen;
+
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    ulCurrent = SymTable_loadAcquire(&ulEpoch);
+    for (psReader = SymTable_loadAcquire(&psReaders); psReader != NULL;
+         psReader = psReader->next)
+    {
+        ulSeen = SymTable_loadAcquire(&psReader->epoch);
+        if (ulSeen != 0 && ulSeen != ulCurrent) {return ulCurrent;}
+    }
+    /* Writers of other tables may advance it at the same time. */
+    __atomic_compare_exchange_n(&ulEpoch, &ulCurrent, ulCurrent + 1, 0,
+                                __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+    return SymTable_loadAcquire(&ulEpoch);
+}
+
+/* Return the epoch to record in an object that the caller has just
+   unlinked or replaced with a release store. The fence orders that
+   store before the load of the epoch, and pairs with the fence in
+   SymTable_readEnter: a reader that announced an epoch later than the
+   returned one cannot see the object. */
+static unsigned long SymTable_retireEpoch(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    return SymTable_loadAcquire(&ulEpoch);
+}
+
+/* Return the full hash value of the string pcKey. Reduce it to a bucket
+   index with % bucket count. */
+static size_t SymTable_hash(const char *pcKey)
+{
+   const size_t HASH_MULTIPLIER = 65599;
+   size_t u;
+   size_t uHash = 0;
+
+   assert(pcKey != NULL);
+
+   for (u = 0; pcKey[u] != '\0'; u++)
+      uHash = uHash * HASH_MULTIPLIER + (size_t)pcKey[u];
+
+   return uHash;
+}
+
+/* Return the key of the binding pBinding. */
+static const char *SymTable_bindingKey(const Binding_T *pBinding)
+{
+    assert(pBinding != NULL);
+    if (pBinding->key.inline_key[INLINE_KEY_SIZE - 1] == '\0')
+        return pBinding->key.inline_key;
+    return pBinding->key.long_key;
+}
+
+/* Free the binding pBinding and the long key it owns, if any. */
+static void SymTable_binding_free(Binding_T *pBinding)
+{
+    assert(pBinding != NULL);
+    if (pBinding->ownsKey && pBinding->key.inline_key[INLINE_KEY_SIZE - 1] != '\0')
+        free(pBinding->key.long_key);
+    free(pBinding);
+}
+
+/* Return a new bucket array of size empty buckets, or NULL if memory is
+   exhausted. */
+static struct Buckets *SymTable_newBuckets(size_t size)
+{
+    struct Buckets *psBuckets;
+
+    if (size > ((size_t)-1 - sizeof(struct Buckets)) / sizeof(Binding_T *)) {return NULL;}
+    psBuckets = (struct Buckets *) calloc(1, sizeof(struct Buckets)
+                                             + size * sizeof(Binding_T *));
+    if (psBuckets == NULL) {return NULL;}
+    psBuckets->size = size;
+    return psBuckets;
+}
+
+/* Recompute the length at which oSymTable grows, from its current
+   bucket count. */
+static void SymTable_setGrowAt(SymTable_T oSymTable)
+{
+    double limit = SYMTABLE_MAX_LOAD_FACTOR * (double)oSymTable->buckets->size;
+    if (limit >= (double)((size_t)-1)) {oSymTable->growAt = (size_t)-1;}
+    else if (limit < 1.0) {oSymTable->growAt = 1;}
+    else {oSymTable->growAt = (size_t)limit;}
+}
+
+/* Free the objects oSymTable retired at least two epochs before the
+   current one, first trying to advance the epoch. Nothing more can be
+   freed until the epoch changes, so the lists are only walked once per
+   epoch. The caller holds the writer mutex. */
+static void SymTable_reclaim(SymTable_T oSymTable)
+{
+    unsigned long ulCurrent = SymTable_advanceEpoch();
+    Binding_T **ppBinding;
+    Binding_T *pBinding;
+    struct Buckets **ppBuckets;
+    struct Buckets *psBuckets;
+
+    if (ulCurrent == oSymTable->reclaimedAt) {return;}
+    oSymTable->reclaimedAt = ulCurrent;
+
+    /* Both lists are newest first, so everything after the first object
+       old enough to free is old enough too. */
+    for (ppBinding = &oSymTable->retiredBindings; *ppBinding != NULL;
+         ppBinding = &(*ppBinding)->limbo)
+        if ((*ppBinding)->retired + 2 <= ulCurrent) {break;}
+    while (*ppBinding != NULL)
+    {
+        pBinding = *ppBinding;
+        *ppBinding = pBinding->limbo;
+        SymTable_binding_free(pBinding);
+        --(oSymTable->retiredCount);
+    }
+
+    for (ppBuckets = &oSymTable->retiredBuckets; *ppBuckets != NULL;
+         ppBuckets = &(*ppBuckets)->limbo)
+        if ((*ppBuckets)->retired + 2 <= ulCurrent) {break;}
+    while (*ppBuckets != NULL)
+    {
+        psBuckets = *ppBuckets;
+        *ppBuckets = psBuckets->limbo;
+        free(psBuckets);
+        --(oSymTable->retiredCount);
+    }
+}
+
+/* Retire the unlinked binding pBinding of oSymTable. The caller holds
+   the writer mutex. */
+static void SymTable_retireBinding(SymTable_T oSymTable, Binding_T *pBinding)
+{
+    pBinding->retired = SymTable_retireEpoch();
+    pBinding->limbo = oSymTable->retiredBindings;
+    oSymTable->retiredBindings = pBinding;
+    ++(oSymTable->retiredCount);
+}
+
+/* Give oSymTable a bucket array of twice as many buckets plus one,
+   holding copies of its bindings, publish it, and retire the old array
+   and bindings. If memory is exhausted the table keeps its buckets. The
+   caller holds the writer mutex. */
+static void SymTable_grow(SymTable_T oSymTable)
+{
+    struct Buckets *old_buckets = oSymTable->buckets;
+    struct Buckets *new_buckets;
+    Binding_T *pBinding;
+    Binding_T *pCopy;
+    Binding_T *next;
+    size_t size;
+    size_t i;
+
+    if (old_buckets->size > ((size_t)-1 / sizeof(Binding_T *)) / 2) {return;}
+    size = 2 * old_buckets->size + 1;
+    new_buckets = SymTable_newBuckets(size);
+    if (new_buckets == NULL) {return;}
+
+    for (i = 0; i < old_buckets->size; i++)
+    {
+        for (pBinding = old_buckets->heads[i]; pBinding != NULL; pBinding = pBinding->next)
+        {
+            pCopy = (Binding_T *) malloc(sizeof(*pCopy));
+            if (pCopy == NULL) {break;}
+            *pCopy = *pBinding;
+            pCopy->next = new_buckets->heads[pCopy->hash % size];
+            new_buckets->heads[pCopy->hash % size] = pCopy;
+        }
+        if (pBinding != NULL) {break;}
+    }
+    if (i < old_buckets->size)
+    {
+        /* Out of memory: the copies share keys, so free only the copies. */
+        for (i = 0; i < size; i++)
+            for (pBinding = new_buckets->heads[i]; pBinding != NULL; pBinding = next)
+            {
+                next = pBinding->next;
+                free(pBinding);
+            }
+        free(new_buckets);
+        return;
+    }
+
+    SymTable_storeRelease(&oSymTable->buckets, new_buckets);
+    SymTable_setGrowAt(oSymTable);
+
+    /* The copies now own the long keys. */
+    for (i = 0; i < old_buckets->size; i++)
+        for (pBinding = old_buckets->heads[i]; pBinding != NULL; pBinding = pBinding->next)
+        {
+            pBinding->ownsKey = 0;
+            SymTable_retireBinding(oSymTable, pBinding);
+        }
+    old_buckets->retired = SymTable_retireEpoch();
+    old_buckets->limbo = oSymTable->retiredBuckets;
+    oSymTable->retiredBuckets = old_buckets;
+    ++(oSymTable->retiredCount);
+}
+
+/* Return the binding of the bucket array psBuckets whose key is pcKey,
+   where uHash is the full hash of pcKey, or NULL if there is none. Every
+   link is followed with an acquire load, so this is safe for readers. */
+static Binding_T *SymTable_find(struct Buckets *psBuckets, const char *pcKey, size_t uHash)
+{
+    Binding_T *pBinding = SymTable_loadAcquire(&psBuckets->heads[uHash % psBuckets->size]);
+
+    for (; pBinding != NULL; pBinding = SymTable_loadAcquire(&pBinding->next))
+    {
+        if (pBinding->hash == uHash && strcmp(SymTable_bindingKey(pBinding), pcKey) == 0)
+            return pBinding;
+    }
+    return NULL;
+}
+
+/* Create a new symbol table and return a pointer to it, or NULL if
+   memory is exhausted. */
+SymTable_T SymTable_new(void)
+{
+    struct SymTable *pSymtable;
+
+    pSymtable = (struct SymTable *) calloc(1, sizeof(*pSymtable));
+    if (pSymtable == NULL) {return NULL;}
+    pSymtable->buckets = SymTable_newBuckets(INITIAL_BUCKET_COUNT);
+    if (pSymtable->buckets == NULL) {free(pSymtable); return NULL;}
+    if (pthread_mutex_init(&pSymtable->lock, NULL) != 0)
+    {
+        free(pSymtable->buckets);
+        free(pSymtable);
+        return NULL;
+    }
+    SymTable_setGrowAt(pSymtable);
+    return pSymtable;
+}
+
+/* Free all memory associated with the symbol table oSymTable,
+   including all bindings and the table structure itself. No other
+   thread may be using oSymTable. */
+void SymTable_free(SymTable_T oSymTable)
+{
+    Binding_T *pBinding;
+    Binding_T *next;
+    struct Buckets *psBuckets;
+    size_t i;
+
+    assert(oSymTable != NULL);
+
+    for (i = 0; i < oSymTable->buckets->size; i++)
+        for (pBinding = oSymTable->buckets->heads[i]; pBinding != NULL; pBinding = next)
+        {
+            next = pBinding->next;
+            SymTable_binding_free(pBinding);
+        }
+    free(oSymTable->buckets);
+    for (pBinding = oSymTable->retiredBindings; pBinding != NULL; pBinding = next)
+    {
+        next = pBinding->limbo;
+        SymTable_binding_free(pBinding);
+    }
+    while (oSymTable->retiredBuckets != NULL)
+    {
+        psBuckets = oSymTable->retiredBuckets;
+        oSymTable->retiredBuckets = psBuckets->limbo;
+        free(psBuckets);
+    }
+    pthread_mutex_destroy(&oSymTable->lock);
+    free(oSymTable);
+}
+
+/* Return the number of key-value bindings stored in the symbol table oSymTable. */
+size_t SymTable_getLength(SymTable_T oSymTable)
+{
+    assert(oSymTable != NULL);
+    return __atomic_load_n(&oSymTable->len, __ATOMIC_RELAXED);
+}
+
+/* Insert a new binding with key pcKey and value pvValue into the symbol table oSymTable.
+   If pcKey already exists in oSymTable, the function does nothing and returns 0.
+   Returns 1 on successful insertion. */
+int SymTable_put(SymTable_T oSymTable, const char *pcKey, const void *pvValue)
+{
+    Binding_T *newBinding;
+    Binding_T **ppHead;
+    size_t hash_value;
+    size_t key_len;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    hash_value = SymTable_hash(pcKey);
+    pthread_mutex_lock(&oSymTable->lock);
+    if (SymTable_find(oSymTable->buckets, pcKey, hash_value) != NULL)
+    {
+        pthread_mutex_unlock(&oSymTable->lock);
+        return 0;
+    }
+    if (oSymTable->len >= oSymTable->growAt) {SymTable_grow(oSymTable);}
+    if (oSymTable->retiredCount >= RECLAIM_THRESHOLD) {SymTable_reclaim(oSymTable);}
+
+    newBinding = (Binding_T *) calloc(1, sizeof(*newBinding));
+    if (newBinding == NULL) {pthread_mutex_unlock(&oSymTable->lock); return 0;}
+    key_len = strlen(pcKey);
+    if (key_len < INLINE_KEY_SIZE)
+        memcpy(newBinding->key.inline_key, pcKey, key_len);
+    else
+    {
+        newBinding->key.long_key = (char *) malloc(key_len + 1);
+        if (newBinding->key.long_key == NULL)
+        {
+            free(newBinding);
+            pthread_mutex_unlock(&oSymTable->lock);
+            return 0;
+        }
+        memcpy(newBinding->key.long_key, pcKey, key_len + 1);
+        newBinding->key.inline_key[INLINE_KEY_SIZE - 1] = 1;
+        newBinding->ownsKey = 1;
+    }
+    newBinding->hash = hash_value;
+    newBinding->value = pvValue;
+
+    /* The binding is complete before the release store makes it visible. */
+    ppHead = &oSymTable->buckets->heads[hash_value % oSymTable->buckets->size];
+    newBinding->next = *ppHead;
+    SymTable_storeRelease(ppHead, newBinding);
+    __atomic_store_n(&oSymTable->len, oSymTable->len + 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&oSymTable->lock);
+    return 1;
+}
+
+/* Replace the value associated with pcKey in the symbol table oSymTable with pvValue.
+   Returns the old value associated with pcKey if it exists, otherwise returns NULL. */
+void *SymTable_replace(SymTable_T oSymTable, const char *pcKey, const void *pvValue)
+{
+    Binding_T *pBinding;
+    const void *temp = NULL;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    pthread_mutex_lock(&oSymTable->lock);
+    pBinding = SymTable_find(oSymTable->buckets, pcKey, SymTable_hash(pcKey));
+    if (pBinding != NULL)
+    {
+        temp = pBinding->value;
+        SymTable_storeRelease(&pBinding->value, pvValue);
+    }
+    pthread_mutex_unlock(&oSymTable->lock);
+    return (void *) temp;
+}
+
+/* Check if the symbol table oSymTable contains a binding for pcKey.
+   Returns 1 if pcKey is found, 0 otherwise. Takes no lock. */
+int SymTable_contains(SymTable_T oSymTable, const char *pcKey)
+{
+    struct Reader *psReader;
+    size_t hash_value;
+    int iFound;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    hash_value = SymTable_hash(pcKey);
+    psReader = SymTable_reader();
+    if (psReader == NULL)
+    {
+        pthread_mutex_lock(&oSymTable->lock);
+        iFound = SymTable_find(oSymTable->buckets, pcKey, hash_value) != NULL;
+        pthread_mutex_unlock(&oSymTable->lock);
+        return iFound;
+    }
+    SymTable_readEnter(psReader);
+    iFound = SymTable_find(SymTable_loadAcquire(&oSymTable->buckets), pcKey, hash_value) != NULL;
+    SymTable_readExit(psReader);
+    return iFound;
+}
+
+/* Retrieve the value associated with pcKey in the symbol table oSymTable.
+   Returns NULL if pcKey is not found. Takes no lock. */
+void *SymTable_get(SymTable_T oSymTable, const char *pcKey)
+{
+    struct Reader *psReader;
+    Binding_T *pBinding;
+    size_t hash_value;
+    const void *temp = NULL;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    hash_value = SymTable_hash(pcKey);
+    psReader = SymTable_reader();
+    if (psReader == NULL)
+    {
+        pthread_mutex_lock(&oSymTable->lock);
+        pBinding = SymTable_find(oSymTable->buckets, pcKey, hash_value);
+        if (pBinding != NULL) {temp = pBinding->value;}
+        pthread_mutex_unlock(&oSymTable->lock);
+        return (void *) temp;
+    }
+    SymTable_readEnter(psReader);
+    pBinding = SymTable_find(SymTable_loadAcquire(&oSymTable->buckets), pcKey, hash_value);
+    if (pBinding != NULL) {temp = SymTable_loadAcquire(&pBinding->value);}
+    SymTable_readExit(psReader);
+    return (void *) temp;
+}
+
+/* Remove the binding for pcKey from the symbol table oSymTable.
+   Returns the value associated with pcKey, or NULL if pcKey is not found.
+   The binding is freed once no reader can still be looking at it. */
+void *SymTable_remove(SymTable_T oSymTable, const char *pcKey)
+{
+    Binding_T **ppLink;
+    Binding_T *pBinding;
+    size_t hash_value;
+    const void *temp = NULL;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    hash_value = SymTable_hash(pcKey);
+    pthread_mutex_lock(&oSymTable->lock);
+    for (ppLink = &oSymTable->buckets->heads[hash_value % oSymTable->buckets->size];
+         *ppLink != NULL; ppLink = &(*ppLink)->next)
+    {
+        pBinding = *ppLink;
+        if (pBinding->hash == hash_value && strcmp(SymTable_bindingKey(pBinding), pcKey) == 0)
+        {
+            /* Readers already on pBinding still reach the rest of the chain. */
+            SymTable_storeRelease(ppLink, pBinding->next);
+            __atomic_store_n(&oSymTable->len, oSymTable->len - 1, __ATOMIC_RELAXED);
+            temp = pBinding->value;
+            SymTable_retireBinding(oSymTable, pBinding);
+            if (oSymTable->retiredCount >= RECLAIM_THRESHOLD) {SymTable_reclaim(oSymTable);}
+            break;
+        }
+    }
+    pthread_mutex_unlock(&oSymTable->lock);
+    return (void *) temp;
+}
+
+/* Apply the function pfApply to each binding in the symbol table oSymTable,
+   passing pcKey, pvValue, and pvExtra as arguments. Writers are locked
+   out for the duration, so pfApply sees a consistent snapshot; it may
+   look keys up in oSymTable but must not change it. */
+void SymTable_map(SymTable_T oSymTable, void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra), const void *pvExtra)
+{
+    Binding_T *pBinding;
+    size_t i;
+
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    pthread_mutex_lock(&oSymTable->lock);
+    for (i = 0; i < oSymTable->buckets->size; i++)
+    {
+        for (pBinding = oSymTable->buckets->heads[i]; pBinding != NULL; pBinding = pBinding->next)
+            (*pfApply)(SymTable_bindingKey(pBinding), (void *) pBinding->value, (void *) pvExtra);
+    }
+    pthread_mutex_unlock(&oSymTable->lock);
+}
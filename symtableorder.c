@@ -0,0 +1,155 @@
+/*--------------------------------------------------------------------*/
+/* symtableorder.c                                                    */
+/* Author: Chinmayi R                                                 */
+/*--------------------------------------------------------------------*/
+#include "symtable.h"
+
+/* SymTable_mapRange and SymTable_mapPrefix for the implementations that
+   keep no key order (the list and the hash tables). The matching
+   bindings are gathered with SymTable_iterNext, sorted with qsort and
+   then applied, which takes O(n + k log k) time. The iterators are used
+   rather than SymTable_map and SymTable_getLength so that a trace build
+   records nothing here. */
+
+/* Number of entries gathered before the first growth */
+enum {INITIAL_ENTRY_COUNT = 16};
+
+/* An Entry object is one binding gathered for sorting. */
+struct Entry {
+    /* The binding's key */
+    const char *key;
+    /* The binding's value */
+    void *value;
+};
+
+/* A Gather object is the state of one gathering pass:
+   - entries: the bindings gathered so far, with room for capacity.
+   - count: the number of entries filled in.
+   - low, high: the range bounds, or NULL for an open end.
+   - prefix: the required key prefix, or NULL, and prefixLength its
+     length. */
+struct Gather {
+    struct Entry *entries;
+    size_t capacity;
+    size_t count;
+    const char *low;
+    const char *high;
+    const char *prefix;
+    size_t prefixLength;
+};
+
+/* Return 1 if pcKey lies in the range of *psGather and starts with its
+   prefix, or 0 otherwise. */
+static int SymTableOrder_selects(const struct Gather *psGather, const char *pcKey)
+{
+    if (psGather->low != NULL && strcmp(pcKey, psGather->low) < 0) {return 0;}
+    if (psGather->high != NULL && strcmp(pcKey, psGather->high) >= 0) {return 0;}
+    if (psGather->prefix != NULL
+        && strncmp(pcKey, psGather->prefix, psGather->prefixLength) != 0) {return 0;}
+    return 1;
+}
+
+/* Add the binding of pcKey to pvValue to the entries of *psGather,
+   doubling them if they are full. Returns 1 on success, or 0 if memory
+   is exhausted. */
+static int SymTableOrder_append(struct Gather *psGather, const char *pcKey, void *pvValue)
+{
+    struct Entry *psEntries;
+    size_t uCapacity;
+
+    if (psGather->count == psGather->capacity)
+    {
+        uCapacity = psGather->capacity == 0 ? INITIAL_ENTRY_COUNT : 2 * psGather->capacity;
+        if (uCapacity > ((size_t)-1) / sizeof(struct Entry)) {return 0;}
+        psEntries = (struct Entry *) realloc(psGather->entries, uCapacity * sizeof(struct Entry));
+        if (psEntries == NULL) {return 0;}
+        psGather->entries = psEntries;
+        psGather->capacity = uCapacity;
+    }
+    psGather->entries[psGather->count].key = pcKey;
+    psGather->entries[psGather->count].value = pvValue;
+    ++(psGather->count);
+    return 1;
+}
+
+/* Return the strcmp order of the keys of the Entry objects pv1 and
+   pv2. */
+static int SymTableOrder_compare(const void *pv1, const void *pv2)
+{
+    return strcmp(((const struct Entry *) pv1)->key, ((const struct Entry *) pv2)->key);
+}
+
+/* Apply pfApply with pvExtra, in key order, to the bindings of oSymTable
+   that the bounds and prefix of *psGather select. Returns 1 on success,
+   or 0 if memory is exhausted. */
+static int SymTableOrder_apply(SymTable_T oSymTable, struct Gather *psGather,
+                               void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+                               const void *pvExtra)
+{
+    struct SymTable_Iter sIter;
+    const char *pcKey;
+    void *pvValue;
+    size_t u;
+
+    psGather->entries = NULL;
+    psGather->capacity = 0;
+    psGather->count = 0;
+
+    SymTable_iterBegin(oSymTable, &sIter);
+    while (SymTable_iterNext(oSymTable, &sIter, &pcKey, &pvValue))
+    {
+        if (SymTableOrder_selects(psGather, pcKey)
+            && !SymTableOrder_append(psGather, pcKey, pvValue))
+        {
+            free(psGather->entries);
+            return 0;
+        }
+    }
+
+    if (psGather->count > 0)
+        qsort(psGather->entries, psGather->count, sizeof(struct Entry), SymTableOrder_compare);
+    for (u = 0; u < psGather->count; u++)
+        (*pfApply)(psGather->entries[u].key, psGather->entries[u].value, (void *) pvExtra);
+
+    free(psGather->entries);
+    return 1;
+}
+
+/* Apply pfApply to each binding of oSymTable whose key is at least pcLow
+   and less than pcHigh, in key order. Returns 1 on success, or 0 if
+   memory is exhausted. */
+int SymTable_mapRange(SymTable_T oSymTable, const char *pcLow, const char *pcHigh,
+                      void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+                      const void *pvExtra)
+{
+    struct Gather sGather;
+
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    sGather.low = pcLow;
+    sGather.high = pcHigh;
+    sGather.prefix = NULL;
+    sGather.prefixLength = 0;
+    return SymTableOrder_apply(oSymTable, &sGather, pfApply, pvExtra);
+}
+
+/* Apply pfApply to each binding of oSymTable whose key starts with
+   pcPrefix, in key order. Returns 1 on success, or 0 if memory is
+   exhausted. */
+int SymTable_mapPrefix(SymTable_T oSymTable, const char *pcPrefix,
+                       void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+                       const void *pvExtra)
+{
+    struct Gather sGather;
+
+    assert(oSymTable != NULL);
+    assert(pcPrefix != NULL);
+    assert(pfApply != NULL);
+
+    sGather.low = NULL;
+    sGather.high = NULL;
+    sGather.prefix = pcPrefix;
+    sGather.prefixLength = strlen(pcPrefix);
+    return SymTableOrder_apply(oSymTable, &sGather, pfApply, pvExtra);
+}
@@ -0,0 +1,331 @@
+/*--------------------------------------------------------------------*/
+/* symtableparallel.c                                                 */
+/* Author: Chinmayi R                                                 */
+/*--------------------------------------------------------------------*/
+
+/* posix_memalign is POSIX.1-2001, not C99. */
+#define _POSIX_C_SOURCE 200112L
+
+#include "symtableparallel.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+/* The parallel traversal behind SymTable_mapParallel and
+   SymTable_mapReduce. The slots of a table are split into one
+   contiguous range per thread. A thread takes pieces of its own range
+   by advancing the range's cursor atomically, and once its range is
+   used up it takes pieces of the other threads' ranges in the same way,
+   so threads that drew long chains are helped by the others instead of
+   being waited for. Cursors only move forward, so one pass over all the
+   ranges finds every piece left. The calling thread is one of the
+   workers; threads that cannot be started simply leave their ranges to
+   be taken by the others.
+
+   Requires the GCC __atomic builtins. */
+
+enum {
+    /* Bytes that keep the data of two threads off a common cache line */
+    CACHE_LINE = 64,
+    /* Fewest slots worth starting another thread for */
+    MIN_SLOTS_PER_THREAD = 4096,
+    /* Pieces each range is cut into, so that there is work to take */
+    CHUNKS_PER_THREAD = 64,
+    /* Fewest slots in a piece */
+    MIN_CHUNK = 32
+};
+
+/* A Range object is one thread's share of the slots: next is the first
+   slot not yet taken and end is one past the last. It fills a cache
+   line, and the array of them is allocated on a cache line boundary,
+   so that the cursors of different threads do not share one. */
+union Range {
+    struct {
+        size_t next;
+        size_t end;
+    } cursor;
+    char pad[CACHE_LINE];
+};
+
+/* A Job object is the traversal that all of its threads share:
+   - source, walk: the structure and the function that visits a slice of
+     its slots.
+   - apply, extra: the function to call on each binding and the client's
+     argument to it.
+   - ranges: one Range per thread, and threadCount their number.
+   - chunk: the number of slots a thread takes at a time. */
+struct Job {
+    const void *source;
+    void (*walk)(const void *pvSource, size_t uBegin, size_t uEnd,
+                 const struct SymTableParallel_Visit *psVisit);
+    void (*apply)(const char *pcKey, void *pvValue, void *pvAccumulator, void *pvExtra);
+    void *extra;
+    union Range *ranges;
+    size_t threadCount;
+    size_t chunk;
+};
+
+/* A Worker object is one thread of a Job: index is the number of the
+   Range it starts with, accumulator its own accumulator or NULL, and
+   started whether thread was created. */
+struct Worker {
+    struct Job *job;
+    size_t index;
+    void *accumulator;
+    pthread_t thread;
+    int started;
+};
+
+/* Return uSize bytes that start on a cache line boundary, or NULL if
+   memory is exhausted. malloc only guarantees a much smaller alignment.
+   Free the bytes with free. */
+static void *SymTableParallel_allocLines(size_t uSize)
+{
+    void *pvBytes;
+
+    if (posix_memalign(&pvBytes, CACHE_LINE, uSize) != 0) {return NULL;}
+    return pvBytes;
+}
+
+/* A Plain object adapts a SymTable_map style function and its extra
+   argument to a traversal with accumulators. */
+struct Plain {
+    void (*apply)(const char *pcKey, void *pvValue, void *pvExtra);
+    const void *extra;
+};
+
+/* An Entry object is one binding gathered from a table that cannot be
+   split into slots. */
+struct Entry {
+    /* The binding's key */
+    const char *key;
+    /* The binding's value */
+    void *value;
+};
+
+/* Take pieces of the Job of the Worker pvWorker, first from its own
+   Range and then from every other, until none is left, and visit them.
+   This is the body of every thread of the Job. */
+static void *SymTableParallel_work(void *pvWorker)
+{
+    struct Worker *psWorker = (struct Worker *) pvWorker;
+    struct Job *psJob = psWorker->job;
+    struct SymTableParallel_Visit sVisit;
+    union Range *psRange;
+    size_t uPass;
+    size_t uBegin;
+    size_t uEnd;
+
+    sVisit.pfApply = psJob->apply;
+    sVisit.pvAccumulator = psWorker->accumulator;
+    sVisit.pvExtra = psJob->extra;
+
+    for (uPass = 0; uPass < psJob->threadCount; uPass++)
+    {
+        psRange = &psJob->ranges[(psWorker->index + uPass) % psJob->threadCount];
+        for (;;)
+        {
+            uBegin = __atomic_fetch_add(&psRange->cursor.next, psJob->chunk, __ATOMIC_RELAXED);
+            if (uBegin >= psRange->cursor.end) {break;}
+            uEnd = psRange->cursor.end - uBegin < psJob->chunk ? psRange->cursor.end
+                                                               : uBegin + psJob->chunk;
+            (*psJob->walk)(psJob->source, uBegin, uEnd, &sVisit);
+        }
+    }
+    return NULL;
+}
+
+/* Visit the uSlotCount slots of pvSource with pfWalk and pfApply from up
+   to uThreadCount threads, each with its own copy of *pvResult as its
+   accumulator, and merge the copies into *pvResult with pfMerge. */
+void SymTableParallel_reduce(const void *pvSource, size_t uSlotCount,
+                             void (*pfWalk)(const void *pvSource, size_t uBegin, size_t uEnd,
+                                            const struct SymTableParallel_Visit *psVisit),
+                             void (*pfApply)(const char *pcKey, void *pvValue,
+                                             void *pvAccumulator, void *pvExtra),
+                             void (*pfMerge)(void *pvResult, const void *pvAccumulator, void *pvExtra),
+                             size_t uAccumulatorSize, void *pvResult, const void *pvExtra,
+                             size_t uThreadCount)
+{
+    struct Job sJob;
+    struct SymTableParallel_Visit sVisit;
+    struct Worker *psWorkers;
+    char *pcAccumulators = NULL;
+    size_t uStride;
+    size_t uShare;
+    size_t uExtra;
+    size_t i;
+
+    assert(pfWalk != NULL);
+    assert(pfApply != NULL);
+    assert(pfMerge != NULL || uAccumulatorSize == 0);
+    assert(pvResult != NULL || uAccumulatorSize == 0);
+
+    if (uThreadCount > uSlotCount / MIN_SLOTS_PER_THREAD) {uThreadCount = uSlotCount / MIN_SLOTS_PER_THREAD;}
+
+    /* Each accumulator starts its own cache line, as the array of them
+       is allocated on a line boundary. */
+    uStride = (uAccumulatorSize + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+    psWorkers = NULL;
+    sJob.ranges = NULL;
+    if (uThreadCount > 1 && uThreadCount <= ((size_t)-1) / (uStride > CACHE_LINE ? uStride : CACHE_LINE))
+    {
+        psWorkers = (struct Worker *) calloc(uThreadCount, sizeof(*psWorkers));
+        sJob.ranges = (union Range *) SymTableParallel_allocLines(uThreadCount * sizeof(*sJob.ranges));
+        if (uStride > 0) {pcAccumulators = (char *) SymTableParallel_allocLines(uThreadCount * uStride);}
+    }
+
+    /* Too small, or out of memory: the calling thread does it all, with
+       the result as its accumulator. */
+    if (psWorkers == NULL || sJob.ranges == NULL || (uStride > 0 && pcAccumulators == NULL))
+    {
+        free(pcAccumulators);
+        free(sJob.ranges);
+        free(psWorkers);
+        sVisit.pfApply = pfApply;
+        sVisit.pvAccumulator = uAccumulatorSize > 0 ? pvResult : NULL;
+        sVisit.pvExtra = (void *) pvExtra;
+        (*pfWalk)(pvSource, 0, uSlotCount, &sVisit);
+        return;
+    }
+
+    sJob.source = pvSource;
+    sJob.walk = pfWalk;
+    sJob.apply = pfApply;
+    sJob.extra = (void *) pvExtra;
+    sJob.threadCount = uThreadCount;
+    sJob.chunk = uSlotCount / (uThreadCount * CHUNKS_PER_THREAD);
+    if (sJob.chunk < MIN_CHUNK) {sJob.chunk = MIN_CHUNK;}
+
+    uShare = uSlotCount / uThreadCount;
+    uExtra = uSlotCount % uThreadCount;
+    for (i = 0; i < uThreadCount; i++)
+    {
+        sJob.ranges[i].cursor.next = i * uShare + (i < uExtra ? i : uExtra);
+        sJob.ranges[i].cursor.end = sJob.ranges[i].cursor.next + uShare + (i < uExtra);
+        psWorkers[i].job = &sJob;
+        psWorkers[i].index = i;
+        if (uStride > 0)
+        {
+            psWorkers[i].accumulator = pcAccumulators + i * uStride;
+            memcpy(psWorkers[i].accumulator, pvResult, uAccumulatorSize);
+        }
+    }
+
+    for (i = 1; i < uThreadCount; i++)
+        psWorkers[i].started = pthread_create(&psWorkers[i].thread, NULL,
+                                              SymTableParallel_work, &psWorkers[i]) == 0;
+    SymTableParallel_work(&psWorkers[0]);
+    for (i = 1; i < uThreadCount; i++)
+        if (psWorkers[i].started) {pthread_join(psWorkers[i].thread, NULL);}
+
+    /* An accumulator of a thread that never started still holds the
+       identity, so merging it changes nothing. */
+    for (i = 0; i < uThreadCount && uStride > 0; i++)
+        (*pfMerge)(pvResult, psWorkers[i].accumulator, (void *) pvExtra);
+
+    free(pcAccumulators);
+    free(sJob.ranges);
+    free(psWorkers);
+}
+
+/* Call the SymTable_map style function of the Plain pvPlain with
+   pcKey, pvValue and its extra argument. */
+static void SymTableParallel_applyPlain(const char *pcKey, void *pvValue,
+                                        void *pvAccumulator, void *pvPlain)
+{
+    const struct Plain *psPlain = (const struct Plain *) pvPlain;
+
+    (void) pvAccumulator;
+    (*psPlain->apply)(pcKey, pvValue, (void *) psPlain->extra);
+}
+
+/* Visit the uSlotCount slots of pvSource with pfWalk, calling pfApply
+   with pvExtra, from up to uThreadCount threads. */
+void SymTableParallel_map(const void *pvSource, size_t uSlotCount,
+                          void (*pfWalk)(const void *pvSource, size_t uBegin, size_t uEnd,
+                                         const struct SymTableParallel_Visit *psVisit),
+                          void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+                          const void *pvExtra, size_t uThreadCount)
+{
+    struct Plain sPlain;
+
+    assert(pfApply != NULL);
+
+    sPlain.apply = pfApply;
+    sPlain.extra = pvExtra;
+    SymTableParallel_reduce(pvSource, uSlotCount, pfWalk, SymTableParallel_applyPlain,
+                            NULL, 0, NULL, &sPlain, uThreadCount);
+}
+
+/* Visit the Entry objects uBegin up to uEnd of the array pvEntries
+   with psVisit. */
+static void SymTableParallel_walkEntries(const void *pvEntries, size_t uBegin, size_t uEnd,
+                                         const struct SymTableParallel_Visit *psVisit)
+{
+    const struct Entry *psEntries = (const struct Entry *) pvEntries;
+    size_t i;
+
+    for (i = uBegin; i < uEnd; i++)
+        (*psVisit->pfApply)(psEntries[i].key, psEntries[i].value,
+                            psVisit->pvAccumulator, psVisit->pvExtra);
+}
+
+/* Gather the uLength bindings of oSymTable into an array and reduce
+   them with SymTableParallel_reduce, or reduce them in the calling
+   thread if there are too few to share or no memory for the array. */
+void SymTableParallel_reduceGathered(SymTable_T oSymTable, size_t uLength,
+                                     void (*pfApply)(const char *pcKey, void *pvValue,
+                                                     void *pvAccumulator, void *pvExtra),
+                                     void (*pfMerge)(void *pvResult, const void *pvAccumulator,
+                                                     void *pvExtra),
+                                     size_t uAccumulatorSize, void *pvResult,
+                                     const void *pvExtra, size_t uThreadCount)
+{
+    struct SymTable_Iter sIter;
+    struct Entry *psEntries = NULL;
+    size_t i;
+    const char *pcKey;
+    void *pvValue;
+
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    if (uThreadCount > 1 && uLength / MIN_SLOTS_PER_THREAD > 1
+        && uLength <= ((size_t)-1) / sizeof(*psEntries))
+        psEntries = (struct Entry *) malloc(uLength * sizeof(*psEntries));
+
+    SymTable_iterBegin(oSymTable, &sIter);
+    if (psEntries == NULL)
+    {
+        /* Not worth gathering, or out of memory: the calling thread does
+           it all. */
+        while (SymTable_iterNext(oSymTable, &sIter, &pcKey, &pvValue))
+            (*pfApply)(pcKey, pvValue, uAccumulatorSize > 0 ? pvResult : NULL, (void *) pvExtra);
+        return;
+    }
+
+    for (i = 0; i < uLength; i++)
+        if (! SymTable_iterNext(oSymTable, &sIter, &psEntries[i].key, &psEntries[i].value)) {break;}
+    assert(i == uLength);
+    SymTableParallel_reduce(psEntries, uLength, SymTableParallel_walkEntries, pfApply,
+                            pfMerge, uAccumulatorSize, pvResult, pvExtra, uThreadCount);
+    free(psEntries);
+}
+
+/* Gather the uLength bindings of oSymTable into an array and visit
+   them with SymTableParallel_map, or in the calling thread alone. */
+void SymTableParallel_mapGathered(SymTable_T oSymTable, size_t uLength,
+                                  void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+                                  const void *pvExtra, size_t uThreadCount)
+{
+    struct Plain sPlain;
+
+    assert(pfApply != NULL);
+
+    sPlain.apply = pfApply;
+    sPlain.extra = pvExtra;
+    SymTableParallel_reduceGathered(oSymTable, uLength, SymTableParallel_applyPlain, NULL, 0,
+                                    NULL, &sPlain, uThreadCount);
+}
@@ -0,0 +1,67 @@
+/*--------------------------------------------------------------------*/
+/* symtableparallel.h                                                 */
+/* Author: Chinmayi R                                                 */
+/*--------------------------------------------------------------------*/
+#include "symtable.h"
+#include <stddef.h>
+
+#ifndef SYMTABLEPARALLEL_INCLUDED
+#define SYMTABLEPARALLEL_INCLUDED
+
+/* Interface between the parallel traversal and the SymTable
+   implementations. Clients use SymTable_mapParallel and
+   SymTable_mapReduce from symtable.h instead. */
+
+/* A SymTableParallel_Visit object is what one thread applies to each
+   binding it visits. */
+struct SymTableParallel_Visit {
+    /* Function to call with each binding's key and value */
+    void (*pfApply)(const char *pcKey, void *pvValue, void *pvAccumulator, void *pvExtra);
+    /* The visiting thread's accumulator, or NULL */
+    void *pvAccumulator;
+    /* The client's extra argument */
+    void *pvExtra;
+};
+
+/* Visit each binding of pvSource, a structure of uSlotCount slots such
+   as buckets, from up to uThreadCount threads, and then fold each
+   thread's accumulator into *pvResult with pfMerge as SymTable_mapReduce
+   describes. pfWalk(pvSource, uBegin, uEnd, psVisit) must visit the
+   bindings in slots uBegin up to uEnd with psVisit. pfMerge may be NULL
+   when uAccumulatorSize is 0. */
+void SymTableParallel_reduce(const void *pvSource, size_t uSlotCount,
+                             void (*pfWalk)(const void *pvSource, size_t uBegin, size_t uEnd,
+                                            const struct SymTableParallel_Visit *psVisit),
+                             void (*pfApply)(const char *pcKey, void *pvValue,
+                                             void *pvAccumulator, void *pvExtra),
+                             void (*pfMerge)(void *pvResult, const void *pvAccumulator, void *pvExtra),
+                             size_t uAccumulatorSize, void *pvResult, const void *pvExtra,
+                             size_t uThreadCount);
+
+/* Like SymTableParallel_reduce, but call pfApply with each binding and
+   pvExtra alone, as SymTable_mapParallel describes. */
+void SymTableParallel_map(const void *pvSource, size_t uSlotCount,
+                          void (*pfWalk)(const void *pvSource, size_t uBegin, size_t uEnd,
+                                         const struct SymTableParallel_Visit *psVisit),
+                          void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+                          const void *pvExtra, size_t uThreadCount);
+
+/* SymTable_mapReduce for an implementation whose bindings cannot be
+   split into slots: they are gathered into an array with SymTable_iterNext
+   first, and the array is split instead. uLength is the number of
+   bindings of oSymTable, passed in so that no call here is recorded in
+   a trace build. */
+void SymTableParallel_reduceGathered(SymTable_T oSymTable, size_t uLength,
+                                     void (*pfApply)(const char *pcKey, void *pvValue,
+                                                     void *pvAccumulator, void *pvExtra),
+                                     void (*pfMerge)(void *pvResult, const void *pvAccumulator,
+                                                     void *pvExtra),
+                                     size_t uAccumulatorSize, void *pvResult,
+                                     const void *pvExtra, size_t uThreadCount);
+
+/* SymTable_mapParallel in the same way as SymTableParallel_reduceGathered. */
+void SymTableParallel_mapGathered(SymTable_T oSymTable, size_t uLength,
+                                  void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+                                  const void *pvExtra, size_t uThreadCount);
+
+#endif
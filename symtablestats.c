@@ -0,0 +1,65 @@
+/*--------------------------------------------------------------------*/
+/* symtablestats.c                                                    */
+/* Author: Chinmayi R                                                 */
+/*--------------------------------------------------------------------*/
+
+/* clock_gettime and CLOCK_MONOTONIC are POSIX, not C99. */
+#define _POSIX_C_SOURCE 199309L
+
+#include "symtablestats.h"
+#include <assert.h>
+#include <string.h>
+#include <time.h>
+
+/* Return the current monotonic wall-clock time in nanoseconds. */
+double SymTableStats_now(void)
+{
+    struct timespec sTime;
+
+    clock_gettime(CLOCK_MONOTONIC, &sTime);
+    return (double)sTime.tv_sec * 1e9 + (double)sTime.tv_nsec;
+}
+
+/* Set every instrumentation member of *psStats to 0. */
+void SymTableStats_clear(struct SymTable_Stats *psStats)
+{
+    assert(psStats != NULL);
+
+    psStats->iInstrumented = 0;
+    psStats->uLookups = 0;
+    psStats->uHits = 0;
+    psStats->uMisses = 0;
+    psStats->dMeanProbes = 0.0;
+    psStats->uMaxProbes = 0;
+    memset(psStats->auChainLengths, 0, sizeof(psStats->auChainLengths));
+    psStats->dResizeNs = 0.0;
+    psStats->uBytesAllocated = 0;
+}
+
+/* Copy the counters of *psCounters into *psStats and mark it as
+   instrumented. */
+void SymTableStats_report(const struct SymTableStats *psCounters,
+                          struct SymTable_Stats *psStats)
+{
+    assert(psCounters != NULL);
+    assert(psStats != NULL);
+
+    psStats->iInstrumented = 1;
+    psStats->uLookups = psCounters->lookups;
+    psStats->uHits = psCounters->hits;
+    psStats->uMisses = psCounters->lookups - psCounters->hits;
+    psStats->dMeanProbes = psCounters->lookups == 0 ? 0.0
+        : (double)psCounters->probes / (double)psCounters->lookups;
+    psStats->uMaxProbes = psCounters->maxProbes;
+    psStats->dResizeNs = psCounters->resizeNs;
+}
+
+/* Count one more chain of uLength bindings in the histogram of
+   *psStats, in the last entry if it is that long or longer. */
+void SymTableStats_addChain(struct SymTable_Stats *psStats, size_t uLength)
+{
+    assert(psStats != NULL);
+
+    if (uLength >= SYMTABLE_STATS_CHAIN_LENGTHS) {uLength = SYMTABLE_STATS_CHAIN_LENGTHS - 1;}
+    ++(psStats->auChainLengths[uLength]);
+}
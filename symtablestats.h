@@ -0,0 +1,80 @@
+/*--------------------------------------------------------------------*/
+/* symtablestats.h                                                    */
+/* Author: Chinmayi R                                                 */
+/*--------------------------------------------------------------------*/
+#include "symtable.h"
+#include <stddef.h>
+
+#ifndef SYMTABLESTATS_INCLUDED
+#define SYMTABLESTATS_INCLUDED
+
+/* Interface between the instrumentation counters and the SymTable
+   implementations. Clients read the counters with SymTable_getStats
+   from symtable.h instead.
+
+   An implementation embeds a SymTableStats object and updates it
+   through the macros below only when compiled with SYMTABLE_STATS
+   defined. Otherwise the macros expand to casts to void of their probe
+   count argument, which the compiler discards, so the hooks can stay in
+   production builds at no cost. Macro arguments may be evaluated more
+   than once. */
+
+/* A SymTableStats object holds the counters of one instrumented table. */
+struct SymTableStats {
+    /* Number of key searches */
+    size_t lookups;
+    /* Number of key searches that found their key */
+    size_t hits;
+    /* Total probes over all key searches */
+    size_t probes;
+    /* Most probes of a single key search */
+    size_t maxProbes;
+    /* Total nanoseconds spent resizing */
+    double resizeNs;
+    /* Start of the resize being timed */
+    double resizeStart;
+};
+
+#ifdef SYMTABLE_STATS
+
+/* Count one more probe in the size_t variable uProbes. */
+#define SymTableStats_probe(uProbes) ((void)++(uProbes))
+
+/* Record in the SymTableStats *psStats a key search that took uProbes
+   probes and found its key if iHit. */
+#define SymTableStats_lookup(psStats, uProbes, iHit)                      \
+    ((void)(++(psStats)->lookups, (psStats)->hits += ((iHit) != 0),       \
+            (psStats)->probes += (uProbes),                               \
+            (psStats)->maxProbes = (uProbes) > (psStats)->maxProbes       \
+                                   ? (uProbes) : (psStats)->maxProbes))
+
+/* Start and stop timing a resize, adding its time to *psStats. */
+#define SymTableStats_startResize(psStats) ((void)((psStats)->resizeStart = SymTableStats_now()))
+#define SymTableStats_stopResize(psStats) \
+    ((void)((psStats)->resizeNs += SymTableStats_now() - (psStats)->resizeStart))
+
+#else
+
+#define SymTableStats_probe(uProbes) ((void)(uProbes))
+#define SymTableStats_lookup(psStats, uProbes, iHit) ((void)(uProbes))
+#define SymTableStats_startResize(psStats) ((void)0)
+#define SymTableStats_stopResize(psStats) ((void)0)
+
+#endif
+
+/* Return the current monotonic wall-clock time in nanoseconds. */
+double SymTableStats_now(void);
+
+/* Set every instrumentation member of *psStats to 0. */
+void SymTableStats_clear(struct SymTable_Stats *psStats);
+
+/* Copy the counters of *psCounters into *psStats and mark it as
+   instrumented. The chain lengths and bytes are left to the caller. */
+void SymTableStats_report(const struct SymTableStats *psCounters,
+                          struct SymTable_Stats *psStats);
+
+/* Count one more chain of uLength bindings in the histogram of
+   *psStats. */
+void SymTableStats_addChain(struct SymTable_Stats *psStats, size_t uLength);
+
+#endif
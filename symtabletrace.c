@@ -0,0 +1,217 @@
+/*--------------------------------------------------------------------*/
+/* symtabletrace.c                                                    */
+/* Author: Chinmayi R                                                 */
+/*--------------------------------------------------------------------*/
+
+/* clock_gettime and CLOCK_MONOTONIC are POSIX, not C99. */
+#define _POSIX_C_SOURCE 199309L
+
+#include "symtabletrace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <assert.h>
+
+/* Size of the stdio buffer of the trace file. */
+enum {TRACE_BUFFER_SIZE = 1 << 16};
+
+/* Most bytes a varint of a 64-bit number takes. */
+enum {MAX_VARINT_LENGTH = 10};
+
+/* Trace file to which records are written, or NULL before the first
+   record and after a failure to open it. */
+static FILE *psTraceFile;
+
+/* 1 once opening the trace file has failed, so that it is not retried. */
+static int iTraceFailed;
+
+/* Id that the next table created will get. */
+static size_t uNextTable;
+
+/* Time of the last record, in nanoseconds. */
+static uint64_t uLastNs;
+
+/* Names of the operations, indexed by SymTableTrace_Op. */
+static const char *const OP_NAMES[SYMTABLETRACE_OP_COUNT] = {
+    "new", "free", "length", "put", "replace", "contains", "get",
+    "remove", "map", "getorput"
+};
+
+/* Return the current monotonic wall-clock time in nanoseconds. */
+static uint64_t SymTableTrace_now(void)
+{
+    struct timespec sTime;
+
+    clock_gettime(CLOCK_MONOTONIC, &sTime);
+    return (uint64_t)sTime.tv_sec * 1000000000u + (uint64_t)sTime.tv_nsec;
+}
+
+/* Flush and close the trace file at exit. */
+static void SymTableTrace_close(void)
+{
+    if (psTraceFile != NULL) {fclose(psTraceFile);}
+    psTraceFile = NULL;
+}
+
+/* Open the trace file and write its magic number, unless that has
+   already been done or has failed. Return 1 if the file is open. */
+static int SymTableTrace_open(void)
+{
+    const char *pcPath;
+
+    if (psTraceFile != NULL) {return 1;}
+    if (iTraceFailed) {return 0;}
+
+    pcPath = getenv("SYMTABLE_TRACE_FILE");
+    if (pcPath == NULL) {pcPath = "symtable.trace";}
+    psTraceFile = fopen(pcPath, "wb");
+    if (psTraceFile == NULL
+        || fwrite(SYMTABLETRACE_MAGIC, 1, SYMTABLETRACE_MAGIC_LENGTH, psTraceFile)
+           != SYMTABLETRACE_MAGIC_LENGTH)
+    {
+        fprintf(stderr, "symtable: cannot write trace file %s\n", pcPath);
+        if (psTraceFile != NULL) {fclose(psTraceFile);}
+        psTraceFile = NULL;
+        iTraceFailed = 1;
+        return 0;
+    }
+    setvbuf(psTraceFile, NULL, _IOFBF, TRACE_BUFFER_SIZE);
+    atexit(SymTableTrace_close);
+    uLastNs = SymTableTrace_now();
+    return 1;
+}
+
+/* Write uValue as a varint at pucBuffer and return the number of bytes
+   it takes. */
+static size_t SymTableTrace_putVarint(unsigned char *pucBuffer, uint64_t uValue)
+{
+    size_t uLength = 0;
+
+    while (uValue >= 0x80)
+    {
+        pucBuffer[uLength++] = (unsigned char)(uValue | 0x80);
+        uValue >>= 7;
+    }
+    pucBuffer[uLength++] = (unsigned char)uValue;
+    return uLength;
+}
+
+/* Decode the varint at the start of the uSize bytes at pucBuffer into
+   *puValue. Return the number of bytes it takes, or 0 if it is
+   truncated or too long. */
+static size_t SymTableTrace_getVarint(const unsigned char *pucBuffer, size_t uSize,
+                                      uint64_t *puValue)
+{
+    uint64_t uValue = 0;
+    size_t i;
+
+    for (i = 0; i < uSize && i < MAX_VARINT_LENGTH; i++)
+    {
+        uValue |= (uint64_t)(pucBuffer[i] & 0x7f) << (7 * i);
+        if ((pucBuffer[i] & 0x80) == 0)
+        {
+            *puValue = uValue;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+/* Record the creation of a table and return its id. */
+size_t SymTableTrace_newTable(void)
+{
+    size_t uTable = uNextTable++;
+
+    SymTableTrace_write(uTable, SYMTABLETRACE_NEW, NULL, 0);
+    return uTable;
+}
+
+/* Record the operation eOp on the table whose id is uTable, with the
+   uLength characters at pcKey as its key if pcKey is not NULL. Write
+   nothing if the trace file cannot be opened. */
+void SymTableTrace_write(size_t uTable, enum SymTableTrace_Op eOp,
+                         const char *pcKey, size_t uLength)
+{
+    unsigned char aucHeader[1 + 3 * MAX_VARINT_LENGTH];
+    size_t uHeaderLength;
+    uint64_t uNow;
+
+    assert(eOp < SYMTABLETRACE_OP_COUNT);
+    assert((pcKey != NULL) == SymTableTrace_hasKey(eOp));
+
+    if (!SymTableTrace_open()) {return;}
+
+    uNow = SymTableTrace_now();
+    aucHeader[0] = (unsigned char)eOp;
+    uHeaderLength = 1;
+    uHeaderLength += SymTableTrace_putVarint(aucHeader + uHeaderLength, uTable);
+    uHeaderLength += SymTableTrace_putVarint(aucHeader + uHeaderLength, uNow - uLastNs);
+    if (pcKey != NULL)
+        uHeaderLength += SymTableTrace_putVarint(aucHeader + uHeaderLength, uLength);
+    uLastNs = uNow;
+
+    fwrite(aucHeader, 1, uHeaderLength, psTraceFile);
+    if (pcKey != NULL) {fwrite(pcKey, 1, uLength, psTraceFile);}
+}
+
+/* Return 1 if the records of eOp carry a key, or 0 otherwise. */
+int SymTableTrace_hasKey(enum SymTableTrace_Op eOp)
+{
+    switch (eOp)
+    {
+        case SYMTABLETRACE_PUT:
+        case SYMTABLETRACE_REPLACE:
+        case SYMTABLETRACE_CONTAINS:
+        case SYMTABLETRACE_GET:
+        case SYMTABLETRACE_REMOVE:
+        case SYMTABLETRACE_GET_OR_PUT:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/* Return the name of eOp. */
+const char *SymTableTrace_opName(enum SymTableTrace_Op eOp)
+{
+    assert(eOp < SYMTABLETRACE_OP_COUNT);
+    return OP_NAMES[eOp];
+}
+
+/* Decode into *psRecord the record at the start of the uSize bytes at
+   pucBuffer. Return the number of bytes it takes, or 0 if the bytes are
+   truncated or do not hold a record. */
+size_t SymTableTrace_decode(const unsigned char *pucBuffer, size_t uSize,
+                            struct SymTableTrace_Record *psRecord)
+{
+    uint64_t uValue;
+    size_t uUsed;
+    size_t uOffset;
+
+    assert(pucBuffer != NULL || uSize == 0);
+    assert(psRecord != NULL);
+
+    if (uSize == 0 || pucBuffer[0] >= SYMTABLETRACE_OP_COUNT) {return 0;}
+    psRecord->op = (enum SymTableTrace_Op)pucBuffer[0];
+    uOffset = 1;
+
+    uUsed = SymTableTrace_getVarint(pucBuffer + uOffset, uSize - uOffset, &uValue);
+    if (uUsed == 0 || (size_t)uValue != uValue) {return 0;}
+    psRecord->table = (size_t)uValue;
+    uOffset += uUsed;
+
+    uUsed = SymTableTrace_getVarint(pucBuffer + uOffset, uSize - uOffset, &psRecord->delta);
+    if (uUsed == 0) {return 0;}
+    uOffset += uUsed;
+
+    psRecord->key = NULL;
+    psRecord->keyLength = 0;
+    if (!SymTableTrace_hasKey(psRecord->op)) {return uOffset;}
+
+    uUsed = SymTableTrace_getVarint(pucBuffer + uOffset, uSize - uOffset, &uValue);
+    if (uUsed == 0 || uValue > uSize - uOffset - uUsed) {return 0;}
+    uOffset += uUsed;
+    psRecord->key = (const char *)(pucBuffer + uOffset);
+    psRecord->keyLength = (size_t)uValue;
+    return uOffset + psRecord->keyLength;
+}
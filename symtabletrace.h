@@ -0,0 +1,107 @@
+/*--------------------------------------------------------------------*/
+/* symtabletrace.h                                                    */
+/* Author: Chinmayi R                                                 */
+/*--------------------------------------------------------------------*/
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef SYMTABLETRACE_INCLUDED
+#define SYMTABLETRACE_INCLUDED
+
+/* Interface between the trace recorder and the SymTable
+   implementations, and the trace format that the replayer reads.
+
+   An implementation compiled with SYMTABLE_TRACE defined embeds a
+   traceId in each table and logs every call of the core interface
+   through the macros below to the file that the environment variable
+   SYMTABLE_TRACE_FILE names, or to symtable.trace if it is unset.
+   Otherwise the macros expand to nothing. The recorder is not thread
+   safe, so neither is an implementation that uses it.
+
+   A trace is the SYMTABLETRACE_MAGIC_LENGTH bytes of
+   SYMTABLETRACE_MAGIC followed by one record per call:
+   - one byte, the SymTableTrace_Op of the call;
+   - the id of the table, as a varint;
+   - the nanoseconds since the previous record, or since the trace
+     was opened, as a varint;
+   - for an operation that takes a key, the length of the key as a
+     varint and then its bytes.
+   A varint holds 7 bits per byte, least significant first, with the
+   high bit set in every byte but the last. Tables are numbered from 0
+   in the order they were created. */
+
+#define SYMTABLETRACE_MAGIC "SYMTRC01"
+enum {SYMTABLETRACE_MAGIC_LENGTH = 8};
+
+/* The operations a trace records. The variants of a core operation,
+   such as SymTable_getInterned, SymTable_getN or each key of
+   SymTable_getBatch, are recorded as the core operation. */
+enum SymTableTrace_Op {
+    SYMTABLETRACE_NEW,
+    SYMTABLETRACE_FREE,
+    SYMTABLETRACE_LENGTH,
+    SYMTABLETRACE_PUT,
+    SYMTABLETRACE_REPLACE,
+    SYMTABLETRACE_CONTAINS,
+    SYMTABLETRACE_GET,
+    SYMTABLETRACE_REMOVE,
+    SYMTABLETRACE_MAP,
+    SYMTABLETRACE_GET_OR_PUT,
+    SYMTABLETRACE_OP_COUNT
+};
+
+/* A SymTableTrace_Record object is one decoded record of a trace. */
+struct SymTableTrace_Record {
+    /* The operation */
+    enum SymTableTrace_Op op;
+    /* The id of the table it was applied to */
+    size_t table;
+    /* Nanoseconds since the previous record */
+    uint64_t delta;
+    /* The key, which is not NUL-terminated, or NULL */
+    const char *key;
+    /* The length of the key */
+    size_t keyLength;
+};
+
+#ifdef SYMTABLE_TRACE
+
+/* Give the new table oSymTable the next table id and record its
+   creation. */
+#define SymTableTrace_created(oSymTable) \
+    ((void)((oSymTable)->traceId = SymTableTrace_newTable()))
+
+/* Record the operation eOp on oSymTable with the uLength characters at
+   pcKey as its key, or with no key if pcKey is NULL. */
+#define SymTableTrace_record(oSymTable, eOp, pcKey, uLength) \
+    SymTableTrace_write((oSymTable)->traceId, (eOp), (pcKey), (uLength))
+
+#else
+
+#define SymTableTrace_created(oSymTable) ((void)0)
+#define SymTableTrace_record(oSymTable, eOp, pcKey, uLength) ((void)0)
+
+#endif
+
+/* Record the creation of a table and return its id. */
+size_t SymTableTrace_newTable(void);
+
+/* Record the operation eOp on the table whose id is uTable, with the
+   uLength characters at pcKey as its key if pcKey is not NULL. */
+void SymTableTrace_write(size_t uTable, enum SymTableTrace_Op eOp,
+                         const char *pcKey, size_t uLength);
+
+/* Return 1 if the records of eOp carry a key, or 0 otherwise. */
+int SymTableTrace_hasKey(enum SymTableTrace_Op eOp);
+
+/* Return the name of eOp, such as "get". */
+const char *SymTableTrace_opName(enum SymTableTrace_Op eOp);
+
+/* Decode into *psRecord the record at the start of the uSize bytes at
+   pucBuffer, which follow the magic number of a trace. Return the
+   number of bytes it takes, or 0 if the bytes are truncated or do not
+   hold a record. psRecord->key points into pucBuffer. */
+size_t SymTableTrace_decode(const unsigned char *pucBuffer, size_t uSize,
+                            struct SymTableTrace_Record *psRecord);
+
+#endif
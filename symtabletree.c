@@ -0,0 +1,1067 @@
+/*--------------------------------------------------------------------*/
+/* symtabletree.c                                                     */
+/* Author: Chinmayi R                                                 */
+/*--------------------------------------------------------------------*/
+#include "symtable.h"
+#include "symtablearena.h"
+#include "symtableparallel.h"
+#include "symtablestats.h"
+#include "symtabletrace.h"
+#include "symtableintern.h"
+
+/* Most keys a node holds. It is odd, so that two nodes holding
+   MIN_KEYS keys and the separator between them fit in one node. */
+enum {MAX_KEYS = 31};
+
+/* Fewest keys a node other than the root holds. */
+enum {MIN_KEYS = MAX_KEYS / 2};
+
+/* A Node object is one node of a B+-tree. Every binding lives in a
+   leaf, and the leaves are linked in key order. An internal node with
+   count keys has count + 1 children; keys[i] is the smallest key in the
+   subtree children[i + 1] and points at that key's copy in its leaf, so
+   separators cost no memory of their own. Next to the keys, a node packs
+   the first eight bytes of each as a big-endian integer in prefixes, so
+   a binary search over a node mostly compares integers in one array
+   instead of chasing key pointers. */
+struct Node {
+    /* 1 for a leaf, 0 for an internal node */
+    int isLeaf;
+
+    /* Number of keys in the node */
+    int count;
+
+    /* First eight bytes of each key, zero-padded, most significant first */
+    unsigned long long prefixes[MAX_KEYS];
+
+    /* Keys, in increasing strcmp order */
+    const char *keys[MAX_KEYS];
+
+    union {
+        /* Subtrees of an internal node */
+        struct Node *children[MAX_KEYS + 1];
+
+        /* Bindings of a leaf */
+        struct {
+            /* Value of each key */
+            const void *values[MAX_KEYS];
+            /* 1 if the key belongs to the intern pool, 0 if to the leaf */
+            unsigned char shared[MAX_KEYS];
+            /* Next leaf in key order, or NULL */
+            struct Node *next;
+        } leaf;
+    } u;
+};
+
+/* A SymTable object represents a B+-tree of bindings ordered by key.
+   It contains:
+   - root: the root node, a leaf while the table is small.
+   - len: the number of key-value bindings stored in the table.
+   - arena: the per-table allocator for nodes.
+   - stats: in a build with SYMTABLE_STATS, the instrumentation
+     counters.
+   - traceId: in a build with SYMTABLE_TRACE, the id of the table in
+     the trace. */
+struct SymTable {
+    /* Root of the tree */
+    struct Node *root;
+
+    /* Number of key-value bindings stored */
+    size_t len;
+
+    /* Slab of nodes */
+    struct SymTableArena arena;
+
+#ifdef SYMTABLE_STATS
+    /* Instrumentation counters */
+    struct SymTableStats stats;
+#endif
+
+#ifdef SYMTABLE_TRACE
+    /* Id of the table in the trace */
+    size_t traceId;
+#endif
+};
+
+/* A Probe object is a key being searched for: the length characters at
+   key, which need not be NUL-terminated, and their packed prefix. */
+struct Probe {
+    const char *key;
+    size_t length;
+    unsigned long long prefix;
+};
+
+/* Return the first eight of the uLength characters at pcKey, padded
+   with zero bytes, as a big-endian integer, so that integer order is
+   strcmp order on the first eight characters. */
+static unsigned long long SymTable_prefix(const char *pcKey, size_t uLength)
+{
+    unsigned long long ullPrefix = 0;
+    size_t u;
+
+    for (u = 0; u < 8; u++)
+        ullPrefix = (ullPrefix << 8)
+            | (u < uLength ? (unsigned long long)(unsigned char)pcKey[u] : 0);
+    return ullPrefix;
+}
+
+/* Fill *psProbe for the uLength characters at pcKey. */
+static void SymTable_setProbe(struct Probe *psProbe, const char *pcKey, size_t uLength)
+{
+    psProbe->key = pcKey;
+    psProbe->length = uLength;
+    psProbe->prefix = SymTable_prefix(pcKey, uLength);
+}
+
+/* Return a negative number, 0 or a positive number as the string
+   pcStored is less than, equal to or greater than the uLength characters
+   at pcKey, comparing characters as unsigned char like strcmp. */
+static int SymTable_compareTail(const char *pcStored, const char *pcKey, size_t uLength)
+{
+    size_t u;
+    unsigned char c1;
+    unsigned char c2;
+
+    for (u = 0; u < uLength; u++)
+    {
+        c1 = (unsigned char)pcStored[u];
+        c2 = (unsigned char)pcKey[u];
+        if (c1 != c2) {return c1 < c2 ? -1 : 1;}
+    }
+    return pcStored[uLength] != '\0';
+}
+
+/* Return a negative number, 0 or a positive number as key i of pNode is
+   less than, equal to or greater than the key of *psProbe. Equal
+   prefixes whose last byte is zero mean both keys end within their
+   first eight characters, and so are equal. */
+static int SymTable_compare(const struct Node *pNode, int i, const struct Probe *psProbe)
+{
+    if (pNode->prefixes[i] != psProbe->prefix)
+        return pNode->prefixes[i] < psProbe->prefix ? -1 : 1;
+    if ((psProbe->prefix & 0xff) == 0) {return 0;}
+    return SymTable_compareTail(pNode->keys[i] + 8, psProbe->key + 8, psProbe->length - 8);
+}
+
+/* Return the index of the first key of pNode that is not less than the
+   key of *psProbe, or pNode->count if there is none. Set *piFound to 1
+   if that key equals the key of *psProbe, or to 0 otherwise. */
+static int SymTable_lowerBound(const struct Node *pNode, const struct Probe *psProbe,
+                               int *piFound)
+{
+    int iLow = 0;
+    int iHigh = pNode->count;
+    int iMid;
+    int iOrder = 1;
+
+    while (iLow < iHigh)
+    {
+        iMid = (iLow + iHigh) / 2;
+        if (SymTable_compare(pNode, iMid, psProbe) < 0) {iLow = iMid + 1;}
+        else {iHigh = iMid;}
+    }
+    if (iLow < pNode->count) {iOrder = SymTable_compare(pNode, iLow, psProbe);}
+    *piFound = iOrder == 0;
+    return iLow;
+}
+
+/* Return the index of the child of the internal node pNode whose
+   subtree holds the key of *psProbe, if any subtree does. Set *piFound to
+   1 if the key is the separator just left of that child. */
+static int SymTable_childIndex(const struct Node *pNode, const struct Probe *psProbe,
+                               int *piFound)
+{
+    int i = SymTable_lowerBound(pNode, psProbe, piFound);
+    return *piFound ? i + 1 : i;
+}
+
+/* Return a new empty leaf (if iLeaf) or internal node from the arena of
+   oSymTable, or NULL if memory is exhausted. */
+static struct Node *SymTable_newNode(SymTable_T oSymTable, int iLeaf)
+{
+    struct Node *pNode = (struct Node *) SymTableArena_allocBlock(&oSymTable->arena);
+    if (pNode == NULL) {return NULL;}
+    pNode->isLeaf = iLeaf;
+    pNode->count = 0;
+    if (iLeaf) {pNode->u.leaf.next = NULL;}
+    return pNode;
+}
+
+/* Copy uCount keys of pSrc starting at iSrc over those of pDest starting
+   at iDest, with their values and ownership if the nodes are leaves. The
+   ranges may overlap. Children are not moved. */
+static void SymTable_moveKeys(struct Node *pDest, int iDest, const struct Node *pSrc,
+                              int iSrc, int uCount)
+{
+    if (uCount <= 0) {return;}
+    memmove(&pDest->prefixes[iDest], &pSrc->prefixes[iSrc], (size_t)uCount * sizeof(pSrc->prefixes[0]));
+    memmove(&pDest->keys[iDest], &pSrc->keys[iSrc], (size_t)uCount * sizeof(pSrc->keys[0]));
+    if (pSrc->isLeaf)
+    {
+        memmove(&pDest->u.leaf.values[iDest], &pSrc->u.leaf.values[iSrc],
+                (size_t)uCount * sizeof(pSrc->u.leaf.values[0]));
+        memmove(&pDest->u.leaf.shared[iDest], &pSrc->u.leaf.shared[iSrc],
+                (size_t)uCount * sizeof(pSrc->u.leaf.shared[0]));
+    }
+}
+
+/* Copy uCount children of the internal node pSrc starting at iSrc over
+   those of pDest starting at iDest. The ranges may overlap. */
+static void SymTable_moveChildren(struct Node *pDest, int iDest, const struct Node *pSrc,
+                                  int iSrc, int uCount)
+{
+    if (uCount <= 0) {return;}
+    memmove(&pDest->u.children[iDest], &pSrc->u.children[iSrc],
+            (size_t)uCount * sizeof(pSrc->u.children[0]));
+}
+
+/* Split the full child i of the internal node pParent in two, moving the
+   upper half of its keys into a new right sibling and the separator
+   between them into pParent. Return 1 on success, or 0 if memory is
+   exhausted, in which case nothing changes. */
+static int SymTable_splitChild(SymTable_T oSymTable, struct Node *pParent, int i)
+{
+    struct Node *pChild = pParent->u.children[i];
+    struct Node *pRight;
+    int iMid = pChild->count / 2;
+
+    assert(pChild->count == MAX_KEYS);
+    assert(pParent->count < MAX_KEYS);
+
+    pRight = SymTable_newNode(oSymTable, pChild->isLeaf);
+    if (pRight == NULL) {return 0;}
+
+    /* Make room for the separator and the new child in pParent. */
+    SymTable_moveKeys(pParent, i + 1, pParent, i, pParent->count - i);
+    SymTable_moveChildren(pParent, i + 2, pParent, i + 1, pParent->count - i);
+
+    if (pChild->isLeaf)
+    {
+        /* The right leaf keeps every upper key; its first is copied up. */
+        SymTable_moveKeys(pRight, 0, pChild, iMid, pChild->count - iMid);
+        pRight->count = pChild->count - iMid;
+        pRight->u.leaf.next = pChild->u.leaf.next;
+        pChild->u.leaf.next = pRight;
+        pParent->keys[i] = pRight->keys[0];
+        pParent->prefixes[i] = pRight->prefixes[0];
+    }
+    else
+    {
+        /* The middle key moves up and the keys above it move right. */
+        SymTable_moveKeys(pRight, 0, pChild, iMid + 1, pChild->count - iMid - 1);
+        SymTable_moveChildren(pRight, 0, pChild, iMid + 1, pChild->count - iMid);
+        pRight->count = pChild->count - iMid - 1;
+        pParent->keys[i] = pChild->keys[iMid];
+        pParent->prefixes[i] = pChild->prefixes[iMid];
+    }
+    pChild->count = iMid;
+    pParent->u.children[i + 1] = pRight;
+    ++(pParent->count);
+    return 1;
+}
+
+/* Find the binding of oSymTable whose key is that of *psProbe, inserting
+   one with value pvValue if there is none, and return a pointer to its
+   value, or NULL if memory is exhausted. A new binding shares the probed
+   characters if iShared, or owns a copy otherwise. Set *piCreated to 1
+   if a binding was inserted and to 0 otherwise. Full nodes on the way
+   down are split first, so the leaf always has room. */
+static const void **SymTable_insert(SymTable_T oSymTable, const struct Probe *psProbe,
+                                    int iShared, const void *pvValue, int *piCreated)
+{
+    struct Node *pNode;
+    struct Node *pRoot;
+    char *pcCopy;
+    int i;
+    int iFound;
+    size_t uProbes = 1;
+
+    *piCreated = 0;
+    if (oSymTable->root->count == MAX_KEYS)
+    {
+        pRoot = SymTable_newNode(oSymTable, 0);
+        if (pRoot == NULL) {return NULL;}
+        pRoot->u.children[0] = oSymTable->root;
+        if (!SymTable_splitChild(oSymTable, pRoot, 0))
+        {
+            SymTableArena_freeBlock(&oSymTable->arena, pRoot);
+            return NULL;
+        }
+        oSymTable->root = pRoot;
+    }
+
+    pNode = oSymTable->root;
+    while (!pNode->isLeaf)
+    {
+        i = SymTable_childIndex(pNode, psProbe, &iFound);
+        if (pNode->u.children[i]->count == MAX_KEYS)
+        {
+            if (!SymTable_splitChild(oSymTable, pNode, i)) {return NULL;}
+            if (SymTable_compare(pNode, i, psProbe) <= 0) {i++;}
+        }
+        pNode = pNode->u.children[i];
+        SymTableStats_probe(uProbes);
+    }
+
+    i = SymTable_lowerBound(pNode, psProbe, &iFound);
+    SymTableStats_lookup(&oSymTable->stats, uProbes, iFound);
+    if (iFound) {return &pNode->u.leaf.values[i];}
+
+    if (iShared) {pcCopy = (char *) psProbe->key;}
+    else
+    {
+        pcCopy = (char *) malloc(psProbe->length + 1);
+        if (pcCopy == NULL) {return NULL;}
+        memcpy(pcCopy, psProbe->key, psProbe->length);
+        pcCopy[psProbe->length] = '\0';
+    }
+
+    SymTable_moveKeys(pNode, i + 1, pNode, i, pNode->count - i);
+    pNode->keys[i] = pcCopy;
+    pNode->prefixes[i] = psProbe->prefix;
+    pNode->u.leaf.values[i] = pvValue;
+    pNode->u.leaf.shared[i] = (unsigned char)(iShared != 0);
+    ++(pNode->count);
+    ++(oSymTable->len);
+    *piCreated = 1;
+    return &pNode->u.leaf.values[i];
+}
+
+/* Return the leaf of oSymTable that holds the key of *psProbe, and store
+   its index there in *piIndex, or return NULL if the key is absent. */
+static struct Node *SymTable_find(SymTable_T oSymTable, const struct Probe *psProbe,
+                                  int *piIndex)
+{
+    struct Node *pNode = oSymTable->root;
+    int iFound;
+    size_t uProbes = 1;
+
+    while (!pNode->isLeaf)
+    {
+        pNode = pNode->u.children[SymTable_childIndex(pNode, psProbe, &iFound)];
+        SymTableStats_probe(uProbes);
+    }
+    *piIndex = SymTable_lowerBound(pNode, psProbe, &iFound);
+    SymTableStats_lookup(&oSymTable->stats, uProbes, iFound);
+    return iFound ? pNode : NULL;
+}
+
+/* Merge child i + 1 of the internal node pParent into child i, which
+   together hold at most MAX_KEYS keys, and free it. */
+static void SymTable_mergeChildren(SymTable_T oSymTable, struct Node *pParent, int i)
+{
+    struct Node *pLeft = pParent->u.children[i];
+    struct Node *pRight = pParent->u.children[i + 1];
+
+    if (pLeft->isLeaf)
+    {
+        SymTable_moveKeys(pLeft, pLeft->count, pRight, 0, pRight->count);
+        pLeft->count += pRight->count;
+        pLeft->u.leaf.next = pRight->u.leaf.next;
+    }
+    else
+    {
+        /* The separator comes down between the two halves. */
+        pLeft->keys[pLeft->count] = pParent->keys[i];
+        pLeft->prefixes[pLeft->count] = pParent->prefixes[i];
+        SymTable_moveKeys(pLeft, pLeft->count + 1, pRight, 0, pRight->count);
+        SymTable_moveChildren(pLeft, pLeft->count + 1, pRight, 0, pRight->count + 1);
+        pLeft->count += pRight->count + 1;
+    }
+
+    SymTable_moveKeys(pParent, i, pParent, i + 1, pParent->count - i - 1);
+    SymTable_moveChildren(pParent, i + 1, pParent, i + 2, pParent->count - i - 1);
+    --(pParent->count);
+    SymTableArena_freeBlock(&oSymTable->arena, pRight);
+}
+
+/* Give child i of the internal node pParent, which holds only MIN_KEYS
+   keys, at least one more, by moving one over from a sibling that can
+   spare it or else by merging it with a sibling. Return the index the
+   child's keys then have in pParent. No memory is allocated. */
+static int SymTable_fixChild(SymTable_T oSymTable, struct Node *pParent, int i)
+{
+    struct Node *pChild = pParent->u.children[i];
+    struct Node *pLeft = i > 0 ? pParent->u.children[i - 1] : NULL;
+    struct Node *pRight = i < pParent->count ? pParent->u.children[i + 1] : NULL;
+
+    if (pLeft != NULL && pLeft->count > MIN_KEYS)
+    {
+        /* Rotate the largest key of the left sibling through pParent. */
+        SymTable_moveKeys(pChild, 1, pChild, 0, pChild->count);
+        if (pChild->isLeaf)
+        {
+            SymTable_moveKeys(pChild, 0, pLeft, pLeft->count - 1, 1);
+            pParent->keys[i - 1] = pChild->keys[0];
+            pParent->prefixes[i - 1] = pChild->prefixes[0];
+        }
+        else
+        {
+            SymTable_moveChildren(pChild, 1, pChild, 0, pChild->count + 1);
+            pChild->keys[0] = pParent->keys[i - 1];
+            pChild->prefixes[0] = pParent->prefixes[i - 1];
+            pChild->u.children[0] = pLeft->u.children[pLeft->count];
+            pParent->keys[i - 1] = pLeft->keys[pLeft->count - 1];
+            pParent->prefixes[i - 1] = pLeft->prefixes[pLeft->count - 1];
+        }
+        --(pLeft->count);
+        ++(pChild->count);
+        return i;
+    }
+
+    if (pRight != NULL && pRight->count > MIN_KEYS)
+    {
+        /* Rotate the smallest key of the right sibling through pParent. */
+        if (pChild->isLeaf)
+        {
+            SymTable_moveKeys(pChild, pChild->count, pRight, 0, 1);
+            SymTable_moveKeys(pRight, 0, pRight, 1, pRight->count - 1);
+            pParent->keys[i] = pRight->keys[0];
+            pParent->prefixes[i] = pRight->prefixes[0];
+        }
+        else
+        {
+            pChild->keys[pChild->count] = pParent->keys[i];
+            pChild->prefixes[pChild->count] = pParent->prefixes[i];
+            pChild->u.children[pChild->count + 1] = pRight->u.children[0];
+            pParent->keys[i] = pRight->keys[0];
+            pParent->prefixes[i] = pRight->prefixes[0];
+            SymTable_moveKeys(pRight, 0, pRight, 1, pRight->count - 1);
+            SymTable_moveChildren(pRight, 0, pRight, 1, pRight->count);
+        }
+        --(pRight->count);
+        ++(pChild->count);
+        return i;
+    }
+
+    if (pLeft != NULL)
+    {
+        SymTable_mergeChildren(oSymTable, pParent, i - 1);
+        return i - 1;
+    }
+    SymTable_mergeChildren(oSymTable, pParent, i);
+    return i;
+}
+
+/* Remove the binding of oSymTable whose key is that of *psProbe and
+   return its value, or NULL if there is none. Every node on the way down
+   is given more than MIN_KEYS keys first, so the leaf can lose one
+   without underflowing. If the key is also a separator, that separator
+   is repointed at the key that now starts its subtree. */
+static void *SymTable_removeProbe(SymTable_T oSymTable, const struct Probe *psProbe)
+{
+    struct Node *pNode = oSymTable->root;
+    struct Node *pSeparator = NULL;
+    struct Node *pOldRoot;
+    const void *pvValue;
+    int iSeparator = 0;
+    int iFound;
+    int i;
+    size_t uProbes = 1;
+
+    while (!pNode->isLeaf)
+    {
+        i = SymTable_childIndex(pNode, psProbe, &iFound);
+        if (pNode->u.children[i]->count <= MIN_KEYS)
+        {
+            SymTable_fixChild(oSymTable, pNode, i);
+            i = SymTable_childIndex(pNode, psProbe, &iFound);
+        }
+        if (iFound) {pSeparator = pNode; iSeparator = i - 1;}
+        pNode = pNode->u.children[i];
+        SymTableStats_probe(uProbes);
+    }
+
+    /* Merging the root's last two children leaves it with one child. */
+    while (!oSymTable->root->isLeaf && oSymTable->root->count == 0)
+    {
+        pOldRoot = oSymTable->root;
+        oSymTable->root = pOldRoot->u.children[0];
+        SymTableArena_freeBlock(&oSymTable->arena, pOldRoot);
+    }
+
+    i = SymTable_lowerBound(pNode, psProbe, &iFound);
+    SymTableStats_lookup(&oSymTable->stats, uProbes, iFound);
+    if (!iFound) {return NULL;}
+
+    pvValue = pNode->u.leaf.values[i];
+    if (!pNode->u.leaf.shared[i]) {free((char *) pNode->keys[i]);}
+    SymTable_moveKeys(pNode, i, pNode, i + 1, pNode->count - i - 1);
+    --(pNode->count);
+    --(oSymTable->len);
+
+    if (pSeparator != NULL)
+    {
+        assert(i == 0 && pNode->count > 0);
+        pSeparator->keys[iSeparator] = pNode->keys[0];
+        pSeparator->prefixes[iSeparator] = pNode->prefixes[0];
+    }
+    return (void *) pvValue;
+}
+
+/* Return the leftmost leaf of oSymTable. */
+static struct Node *SymTable_firstLeaf(SymTable_T oSymTable)
+{
+    struct Node *pNode = oSymTable->root;
+    while (!pNode->isLeaf) {pNode = pNode->u.children[0];}
+    return pNode;
+}
+
+/* Create a new symbol table and return a pointer to it.
+   The table is initially empty: its root is an empty leaf. */
+SymTable_T SymTable_new(void)
+{
+    struct SymTable *pSymtable;
+
+    pSymtable = (struct SymTable *) calloc(1, sizeof(*pSymtable));
+    if (pSymtable == NULL) {return NULL;}
+    SymTableArena_init(&pSymtable->arena, sizeof(struct Node));
+    pSymtable->root = SymTable_newNode(pSymtable, 1);
+    if (pSymtable->root == NULL) {free(pSymtable); return NULL;}
+    pSymtable->len = 0;
+    SymTableTrace_created(pSymtable);
+    return pSymtable;
+}
+
+/* A B+-tree compares keys without hashing them, so create a table
+   exactly as SymTable_new does whatever eHashFunction is. */
+SymTable_T SymTable_newWithHash(enum SymTable_HashFunction eHashFunction)
+{
+    (void) eHashFunction;
+    return SymTable_new();
+}
+
+/* Free all memory associated with the symbol table oSymTable,
+   including all bindings and the table structure itself. The keys are
+   freed leaf by leaf and the nodes a chunk at a time with the arena. */
+void SymTable_free(SymTable_T oSymTable)
+{
+    struct Node *pNode;
+    int i;
+
+    assert(oSymTable != NULL);
+
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_FREE, NULL, 0);
+    for (pNode = SymTable_firstLeaf(oSymTable); pNode != NULL; pNode = pNode->u.leaf.next)
+    {
+        for (i = 0; i < pNode->count; i++)
+            if (!pNode->u.leaf.shared[i]) {free((char *) pNode->keys[i]);}
+    }
+    SymTableArena_free(&oSymTable->arena);
+    free(oSymTable);
+}
+
+/* Return the number of key-value bindings stored in the symbol table oSymTable. */
+size_t SymTable_getLength(SymTable_T oSymTable)
+{
+    assert(oSymTable != NULL);
+
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_LENGTH, NULL, 0);
+    return oSymTable->len;
+}
+
+/* Insert a new binding with key pcKey and value pvValue into the symbol table oSymTable.
+   If pcKey already exists in oSymTable, the function does nothing and returns 0.
+   Returns 1 on successful insertion. */
+int SymTable_put(SymTable_T oSymTable, const char *pcKey, const void *pvValue)
+{
+    struct Probe sProbe;
+    int iCreated;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    SymTable_setProbe(&sProbe, pcKey, strlen(pcKey));
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_PUT, pcKey, sProbe.length);
+    return SymTable_insert(oSymTable, &sProbe, 0, pvValue, &iCreated) != NULL && iCreated;
+}
+
+/* Replace the value associated with pcKey in the symbol table oSymTable with pvValue.
+   Returns the old value associated with pcKey if it exists, otherwise returns NULL. */
+void *SymTable_replace(SymTable_T oSymTable, const char *pcKey, const void *pvValue)
+{
+    struct Probe sProbe;
+    struct Node *pNode;
+    const void *temp;
+    int i;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    SymTable_setProbe(&sProbe, pcKey, strlen(pcKey));
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_REPLACE, pcKey, sProbe.length);
+    pNode = SymTable_find(oSymTable, &sProbe, &i);
+    if (pNode == NULL) {return NULL;}
+
+    temp = pNode->u.leaf.values[i];
+    pNode->u.leaf.values[i] = pvValue;
+    return (void *) temp;
+}
+
+/* Check if the symbol table oSymTable contains a binding for pcKey.
+   Returns 1 if pcKey is found, 0 otherwise. */
+int SymTable_contains(SymTable_T oSymTable, const char *pcKey)
+{
+    struct Probe sProbe;
+    int i;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    SymTable_setProbe(&sProbe, pcKey, strlen(pcKey));
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_CONTAINS, pcKey, sProbe.length);
+    return SymTable_find(oSymTable, &sProbe, &i) != NULL;
+}
+
+/* Retrieve the value associated with pcKey in the symbol table oSymTable.
+   Returns NULL if pcKey is not found. */
+void *SymTable_get(SymTable_T oSymTable, const char *pcKey)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_getN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/* Remove the binding for pcKey from the symbol table oSymTable, freeing its memory.
+   Returns the value associated with pcKey, or NULL if pcKey is not found. */
+void *SymTable_remove(SymTable_T oSymTable, const char *pcKey)
+{
+    struct Probe sProbe;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    SymTable_setProbe(&sProbe, pcKey, strlen(pcKey));
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_REMOVE, pcKey, sProbe.length);
+    return SymTable_removeProbe(oSymTable, &sProbe);
+}
+
+/* Apply the function pfApply to each binding in the symbol table
+   oSymTable, in increasing key order, passing pcKey, pvValue, and
+   pvExtra as arguments. */
+void SymTable_map(SymTable_T oSymTable, void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra), const void *pvExtra)
+{
+    struct Node *pNode;
+    int i;
+
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_MAP, NULL, 0);
+    for (pNode = SymTable_firstLeaf(oSymTable); pNode != NULL; pNode = pNode->u.leaf.next)
+    {
+        for (i = 0; i < pNode->count; i++)
+            (*pfApply)(pNode->keys[i], (void *) pNode->u.leaf.values[i], (void *) pvExtra);
+    }
+}
+
+/* Apply pfApply with pvExtra to the bindings of oSymTable in key order,
+   starting with the first whose key is not less than pcLow (or with the
+   first of all if pcLow is NULL) and stopping before the first whose
+   key is not less than pcHigh, if pcHigh is not NULL, or does not start
+   with the uPrefixLength characters at pcPrefix, if pcPrefix is not
+   NULL. */
+static void SymTable_mapFrom(SymTable_T oSymTable, const char *pcLow, const char *pcHigh,
+                             const char *pcPrefix, size_t uPrefixLength,
+                             void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+                             const void *pvExtra)
+{
+    struct Probe sProbe;
+    struct Node *pNode = oSymTable->root;
+    int i = 0;
+    int iFound;
+
+    if (pcLow == NULL) {pNode = SymTable_firstLeaf(oSymTable);}
+    else
+    {
+        SymTable_setProbe(&sProbe, pcLow, strlen(pcLow));
+        while (!pNode->isLeaf)
+            pNode = pNode->u.children[SymTable_childIndex(pNode, &sProbe, &iFound)];
+        i = SymTable_lowerBound(pNode, &sProbe, &iFound);
+    }
+
+    for (; pNode != NULL; pNode = pNode->u.leaf.next, i = 0)
+    {
+        for (; i < pNode->count; i++)
+        {
+            if (pcHigh != NULL && strcmp(pNode->keys[i], pcHigh) >= 0) {return;}
+            if (pcPrefix != NULL && strncmp(pNode->keys[i], pcPrefix, uPrefixLength) != 0) {return;}
+            (*pfApply)(pNode->keys[i], (void *) pNode->u.leaf.values[i], (void *) pvExtra);
+        }
+    }
+}
+
+/* Apply pfApply to each binding of oSymTable whose key is at least pcLow
+   and less than pcHigh, in key order, in O(log n + k) time. Returns 1. */
+int SymTable_mapRange(SymTable_T oSymTable, const char *pcLow, const char *pcHigh,
+                      void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+                      const void *pvExtra)
+{
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    SymTable_mapFrom(oSymTable, pcLow, pcHigh, NULL, 0, pfApply, pvExtra);
+    return 1;
+}
+
+/* Apply pfApply to each binding of oSymTable whose key starts with
+   pcPrefix, in key order, in O(log n + k) time. Every such key is at
+   least pcPrefix, and they are contiguous from there on. Returns 1. */
+int SymTable_mapPrefix(SymTable_T oSymTable, const char *pcPrefix,
+                       void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+                       const void *pvExtra)
+{
+    assert(oSymTable != NULL);
+    assert(pcPrefix != NULL);
+    assert(pfApply != NULL);
+
+    SymTable_mapFrom(oSymTable, pcPrefix, NULL, pcPrefix, strlen(pcPrefix), pfApply, pvExtra);
+    return 1;
+}
+
+/* Apply pfApply to each binding of oSymTable in key order until it
+   returns nonzero, and return that value, or 0 if it never does. */
+int SymTable_mapUntil(SymTable_T oSymTable,
+                      int (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+                      const void *pvExtra)
+{
+    struct Node *pNode;
+    int iResult;
+    int i;
+
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    for (pNode = SymTable_firstLeaf(oSymTable); pNode != NULL; pNode = pNode->u.leaf.next)
+    {
+        for (i = 0; i < pNode->count; i++)
+        {
+            iResult = (*pfApply)(pNode->keys[i], (void *) pNode->u.leaf.values[i], (void *) pvExtra);
+            if (iResult != 0) {return iResult;}
+        }
+    }
+    return 0;
+}
+
+/* Start a traversal of oSymTable in *psIter at the first key of the
+   leftmost leaf. */
+void SymTable_iterBegin(SymTable_T oSymTable, struct SymTable_Iter *psIter)
+{
+    assert(oSymTable != NULL);
+    assert(psIter != NULL);
+
+    psIter->pvNext = SymTable_firstLeaf(oSymTable);
+    psIter->uIndex = 0;
+}
+
+/* Store the key and value *psIter has reached in *ppcKey and *ppvValue,
+   unless they are NULL, and move *psIter to the next key, following the
+   leaf links. Returns 1, or 0 if the traversal has passed the last
+   key. */
+int SymTable_iterNext(SymTable_T oSymTable, struct SymTable_Iter *psIter,
+                      const char **ppcKey, void **ppvValue)
+{
+    const struct Node *pNode;
+
+    assert(oSymTable != NULL);
+    assert(psIter != NULL);
+
+    pNode = (const struct Node *) psIter->pvNext;
+    while (pNode != NULL && psIter->uIndex >= (size_t)pNode->count)
+    {
+        pNode = pNode->u.leaf.next;
+        psIter->uIndex = 0;
+    }
+    psIter->pvNext = pNode;
+    if (pNode == NULL) {return 0;}
+
+    if (ppcKey != NULL) {*ppcKey = pNode->keys[psIter->uIndex];}
+    if (ppvValue != NULL) {*ppvValue = (void *) pNode->u.leaf.values[psIter->uIndex];}
+    ++(psIter->uIndex);
+    return 1;
+}
+
+/* Apply pfApply to each binding of oSymTable from up to uThreadCount
+   threads. A chain of leaves cannot be split between threads, so the bindings are
+   gathered into an array first. */
+void SymTable_mapParallel(SymTable_T oSymTable,
+                          void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+                          const void *pvExtra, size_t uThreadCount)
+{
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    SymTableParallel_mapGathered(oSymTable, oSymTable->len, pfApply, pvExtra, uThreadCount);
+}
+
+/* Like SymTable_mapParallel, but with an accumulator per thread that is
+   merged into *pvResult at the end. */
+void SymTable_mapReduce(SymTable_T oSymTable,
+                        void (*pfApply)(const char *pcKey, void *pvValue,
+                                        void *pvAccumulator, void *pvExtra),
+                        void (*pfMerge)(void *pvResult, const void *pvAccumulator, void *pvExtra),
+                        size_t uAccumulatorSize, void *pvResult, const void *pvExtra,
+                        size_t uThreadCount)
+{
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    SymTableParallel_reduceGathered(oSymTable, oSymTable->len, pfApply, pfMerge,
+                                    uAccumulatorSize, pvResult, pvExtra, uThreadCount);
+}
+
+/* A B+-tree has no load factor, so reject any maximum load factor and
+   return 0. */
+int SymTable_setMaxLoadFactor(SymTable_T oSymTable, double dMaxLoadFactor)
+{
+    assert(oSymTable != NULL);
+    (void) dMaxLoadFactor;
+    return 0;
+}
+
+/* A B+-tree grows and shrinks a node at a time, so there is nothing to
+   reserve; return 1. */
+int SymTable_reserve(SymTable_T oSymTable, size_t uCount)
+{
+    assert(oSymTable != NULL);
+    (void) uCount;
+    return 1;
+}
+
+/* A B+-tree merges nodes as bindings are removed, so there is nothing
+   left to shrink. */
+void SymTable_shrinkToFit(SymTable_T oSymTable)
+{
+    assert(oSymTable != NULL);
+}
+
+/* A B+-tree never resizes as a whole, so it cannot resize incrementally;
+   return 0. */
+int SymTable_setIncrementalResize(SymTable_T oSymTable, int iEnabled)
+{
+    assert(oSymTable != NULL);
+    (void) iEnabled;
+    return 0;
+}
+
+/* A B+-tree must keep its keys sorted, so it cannot reorder. Returns 1
+   if eReorder is SYMTABLE_REORDER_NONE, or 0 otherwise. */
+int SymTable_setReorder(SymTable_T oSymTable, enum SymTable_Reorder eReorder)
+{
+    assert(oSymTable != NULL);
+    return eReorder == SYMTABLE_REORDER_NONE;
+}
+
+/* Fill *psStats with the state of oSymTable, reporting the tree as one
+   bucket that never grows. In a build with SYMTABLE_STATS, also report
+   its counters and the memory held by its nodes and key copies. */
+void SymTable_getStats(SymTable_T oSymTable, struct SymTable_Stats *psStats)
+{
+#ifdef SYMTABLE_STATS
+    const struct Node *pLeaf;
+    int i;
+#endif
+
+    assert(oSymTable != NULL);
+    assert(psStats != NULL);
+
+    psStats->uLength = oSymTable->len;
+    psStats->uBucketCount = 1;
+    psStats->uGrowAt = (size_t)-1;
+    psStats->uShrinkAt = 0;
+    psStats->uResizeCount = 0;
+    psStats->dLoadFactor = (double)oSymTable->len;
+    psStats->dMaxLoadFactor = 0.0;
+
+    SymTableStats_clear(psStats);
+#ifdef SYMTABLE_STATS
+    SymTableStats_report(&oSymTable->stats, psStats);
+    psStats->uBytesAllocated = sizeof(*oSymTable) + oSymTable->arena.bytesReserved;
+    for (pLeaf = SymTable_firstLeaf(oSymTable); pLeaf != NULL; pLeaf = pLeaf->u.leaf.next)
+        for (i = 0; i < pLeaf->count; i++)
+            if (!pLeaf->u.leaf.shared[i]) {psStats->uBytesAllocated += strlen(pLeaf->keys[i]) + 1;}
+#endif
+}
+
+/* Insert a new binding with the interned key pcInterned and value pvValue
+   into oSymTable, sharing the intern pool's copy of the key. If the key
+   already exists, does nothing and returns 0. Returns 1 on success. */
+int SymTable_putInterned(SymTable_T oSymTable, const char *pcInterned, const void *pvValue)
+{
+    struct Probe sProbe;
+    int iCreated;
+
+    assert(oSymTable != NULL);
+    assert(pcInterned != NULL);
+
+    SymTable_setProbe(&sProbe, pcInterned, SymTableIntern_length(pcInterned));
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_PUT, pcInterned, sProbe.length);
+    return SymTable_insert(oSymTable, &sProbe, 1, pvValue, &iCreated) != NULL && iCreated;
+}
+
+/* Retrieve the value associated with the interned key pcInterned in
+   oSymTable, using the length the intern pool stored for it.
+   Returns NULL if the key is not found. */
+void *SymTable_getInterned(SymTable_T oSymTable, const char *pcInterned)
+{
+    assert(oSymTable != NULL);
+    assert(pcInterned != NULL);
+
+    return SymTable_getN(oSymTable, pcInterned, SymTableIntern_length(pcInterned));
+}
+
+/* Return the multiply-by-65599 hash of the uLength characters at pcKey.
+   The tree does not use hashes, but accepts them for compatibility with
+   the hash table implementations. */
+size_t SymTable_hashKey(SymTable_T oSymTable, const char *pcKey, size_t uLength)
+{
+    const size_t HASH_MULTIPLIER = 65599;
+    size_t u;
+    size_t uHash = 0;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    for (u = 0; u < uLength; u++)
+        uHash = uHash * HASH_MULTIPLIER + (size_t)pcKey[u];
+    return uHash;
+}
+
+/* Insert a new binding whose key is the uLength characters at pcKey and
+   whose value is pvValue into oSymTable. If the key already exists,
+   does nothing and returns 0. Returns 1 on success. */
+int SymTable_putN(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+                  const void *pvValue)
+{
+    struct Probe sProbe;
+    int iCreated;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    SymTable_setProbe(&sProbe, pcKey, uLength);
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_PUT, pcKey, uLength);
+    return SymTable_insert(oSymTable, &sProbe, 0, pvValue, &iCreated) != NULL && iCreated;
+}
+
+/* Retrieve the value associated with the uLength characters at pcKey in
+   oSymTable. Returns NULL if the key is not found. */
+void *SymTable_getN(SymTable_T oSymTable, const char *pcKey, size_t uLength)
+{
+    struct Probe sProbe;
+    struct Node *pNode;
+    int i;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    SymTable_setProbe(&sProbe, pcKey, uLength);
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_GET, pcKey, uLength);
+    pNode = SymTable_find(oSymTable, &sProbe, &i);
+    if (pNode == NULL) {return NULL;}
+    return (void *) pNode->u.leaf.values[i];
+}
+
+/* Same as SymTable_putN; the tree ignores uHash. */
+int SymTable_putHashed(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+                       size_t uHash, const void *pvValue)
+{
+    (void)uHash;
+    return SymTable_putN(oSymTable, pcKey, uLength, pvValue);
+}
+
+/* Same as SymTable_getN; the tree ignores uHash. */
+void *SymTable_getHashed(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+                         size_t uHash)
+{
+    (void)uHash;
+    return SymTable_getN(oSymTable, pcKey, uLength);
+}
+
+/* Return a pointer to the value of the binding of oSymTable whose key is
+   pcKey, first inserting a binding with value pvValue if there is none.
+   Set *piCreated, if piCreated is not NULL, to 1 if a binding was
+   inserted and to 0 otherwise. The tree is descended once. Returns NULL
+   if memory is exhausted. */
+const void **SymTable_getOrPut(SymTable_T oSymTable, const char *pcKey,
+                               const void *pvValue, int *piCreated)
+{
+    struct Probe sProbe;
+    const void **ppvValue;
+    int iCreated;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    SymTable_setProbe(&sProbe, pcKey, strlen(pcKey));
+    SymTableTrace_record(oSymTable, SYMTABLETRACE_GET_OR_PUT, pcKey, sProbe.length);
+    ppvValue = SymTable_insert(oSymTable, &sProbe, 0, pvValue, &iCreated);
+    if (piCreated != NULL) {*piCreated = iCreated;}
+    return ppvValue;
+}
+
+/* Store in ppvValues[i] the value associated with ppcKeys[i] in
+   oSymTable, or NULL if it is absent, for each i below uCount. The tree
+   has no buckets to prefetch, so this is a loop over SymTable_get. */
+void SymTable_getBatch(SymTable_T oSymTable, const char *const *ppcKeys,
+                       size_t uCount, void **ppvValues)
+{
+    size_t u;
+
+    assert(oSymTable != NULL);
+    assert(ppcKeys != NULL || uCount == 0);
+    assert(ppvValues != NULL || uCount == 0);
+
+    for (u = 0; u < uCount; u++)
+        ppvValues[u] = SymTable_get(oSymTable, ppcKeys[u]);
+}
+
+/* Put a binding of ppcKeys[i] to ppvValues[i] into oSymTable for each i
+   below uCount, in order, as SymTable_put would. If piResults is not
+   NULL, store SymTable_put's result for each key in piResults[i].
+   Returns the number of bindings inserted. */
+size_t SymTable_putBatch(SymTable_T oSymTable, const char *const *ppcKeys,
+                         const void *const *ppvValues, size_t uCount, int *piResults)
+{
+    size_t u;
+    size_t uInserted = 0;
+    int iResult;
+
+    assert(oSymTable != NULL);
+    assert(ppcKeys != NULL || uCount == 0);
+    assert(ppvValues != NULL || uCount == 0);
+
+    for (u = 0; u < uCount; u++)
+    {
+        iResult = SymTable_put(oSymTable, ppcKeys[u], ppvValues[u]);
+        if (piResults != NULL) {piResults[u] = iResult;}
+        uInserted += (size_t)iResult;
+    }
+    return uInserted;
+}
+
+/* Remove the binding for ppcKeys[i] from oSymTable for each i below
+   uCount, in order, and store the value it had, or NULL if it was
+   absent, in ppvValues[i] unless ppvValues is NULL. Returns the number
+   of bindings removed. */
+size_t SymTable_removeBatch(SymTable_T oSymTable, const char *const *ppcKeys,
+                            size_t uCount, void **ppvValues)
+{
+    size_t u;
+    size_t uRemoved = 0;
+    size_t uOldLength;
+    void *pvValue;
+
+    assert(oSymTable != NULL);
+    assert(ppcKeys != NULL || uCount == 0);
+
+    for (u = 0; u < uCount; u++)
+    {
+        uOldLength = oSymTable->len;
+        pvValue = SymTable_remove(oSymTable, ppcKeys[u]);
+        uRemoved += oSymTable->len != uOldLength;
+        if (ppvValues != NULL) {ppvValues[u] = pvValue;}
+    }
+    return uRemoved;
+}
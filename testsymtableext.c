@@ -0,0 +1,1575 @@
+/*--------------------------------------------------------------------*/
+/* testsymtableext.c                                                  */
+/* Author: Chinmayi R                                                 */
+/*--------------------------------------------------------------------*/
+
+#include "symtable.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/*--------------------------------------------------------------------*/
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/*--------------------------------------------------------------------*/
+
+/* If !iSuccessful, print a message to stdout indicating that the
+   test at line iLineNum failed. */
+
+static void assure(int iSuccessful, int iLineNum)
+{
+   if (! iSuccessful)
+   {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_getStats() and SymTable_setMaxLoadFactor() while
+   putting iBindingCount bindings into a SymTable object. */
+
+static void testGrowthPolicy(int iBindingCount)
+{
+   enum {MAX_KEY_LENGTH = 16};
+
+   SymTable_T oSymTable;
+   struct SymTable_Stats sStats;
+   char acKey[MAX_KEY_LENGTH];
+   int i;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the growth policy of a SymTable object.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   SymTable_getStats(oSymTable, &sStats);
+   ASSURE(sStats.uLength == 0);
+   ASSURE(sStats.uBucketCount > 0);
+   ASSURE(sStats.uResizeCount == 0);
+   ASSURE(sStats.dLoadFactor == 0.0);
+
+   iSuccessful = SymTable_setMaxLoadFactor(oSymTable, 0.0);
+   ASSURE(! iSuccessful);
+   iSuccessful = SymTable_setMaxLoadFactor(oSymTable, -1.0);
+   ASSURE(! iSuccessful);
+
+   /* A table that resizes must honor the requested load factor. */
+   if (SymTable_setMaxLoadFactor(oSymTable, 0.5))
+   {
+      SymTable_getStats(oSymTable, &sStats);
+      ASSURE(sStats.dMaxLoadFactor == 0.5);
+   }
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, NULL);
+      ASSURE(iSuccessful);
+   }
+
+   SymTable_getStats(oSymTable, &sStats);
+   ASSURE(sStats.uLength == (size_t)iBindingCount);
+   ASSURE(sStats.uLength == SymTable_getLength(oSymTable));
+   if (sStats.dMaxLoadFactor > 0.0)
+   {
+      ASSURE(sStats.dLoadFactor <= sStats.dMaxLoadFactor);
+      ASSURE(sStats.uGrowAt >= sStats.uLength);
+      /* Growth must continue past the last fixed bucket count. */
+      if (iBindingCount > 65521 / 2)
+         ASSURE(sStats.uBucketCount > 65521);
+   }
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_contains(oSymTable, acKey));
+   }
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Write into pcKey the key of round i of testChurn(): a short, a long
+   or a very long key in turn. pcKey must have room for 320 characters. */
+
+static void makeChurnKey(char *pcKey, int i)
+{
+   static const size_t auPadding[] = {0, 40, 300};
+   size_t uLength;
+
+   assert(pcKey != NULL);
+
+   uLength = (size_t)sprintf(pcKey, "churn%d", i);
+   memset(pcKey + uLength, 'x', auPadding[i % 3]);
+   pcKey[uLength + auPadding[i % 3]] = '\0';
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test a SymTable object through iBindingCount rounds of putting a new
+   binding and removing an old one, so that its length stays small
+   while many distinct keys of mixed lengths pass through it. */
+
+static void testChurn(int iBindingCount)
+{
+   enum {MAX_KEY_LENGTH = 320, LIVE_COUNT = 100};
+
+   SymTable_T oSymTable;
+   struct SymTable_Stats sStats;
+   char acKey[MAX_KEY_LENGTH];
+   char acOldKey[MAX_KEY_LENGTH];
+   char *pcValue;
+   int i;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a SymTable object under put/remove churn.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      makeChurnKey(acKey, i);
+      iSuccessful = SymTable_put(oSymTable, acKey, "churn");
+      ASSURE(iSuccessful);
+      if (i >= LIVE_COUNT)
+      {
+         makeChurnKey(acOldKey, i - LIVE_COUNT);
+         pcValue = (char*)SymTable_remove(oSymTable, acOldKey);
+         ASSURE((pcValue != NULL) && (strcmp(pcValue, "churn") == 0));
+         ASSURE(! SymTable_contains(oSymTable, acOldKey));
+      }
+      ASSURE(SymTable_contains(oSymTable, acKey));
+   }
+
+   ASSURE(SymTable_getLength(oSymTable) ==
+      (size_t)(iBindingCount < LIVE_COUNT ? iBindingCount : LIVE_COUNT));
+
+   /* Removed bindings and their keys must not make the table grow
+      without bound. */
+   SymTable_getStats(oSymTable, &sStats);
+   ASSURE(sStats.uBucketCount < 100 * LIVE_COUNT);
+   ASSURE(sStats.uBytesAllocated < 1000 * LIVE_COUNT);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Count the binding whose key is pcKey by incrementing the int that
+   pvExtra points to, and check that pvValue is the key's length. */
+
+static void countBinding(const char *pcKey, void *pvValue,
+   void *pvExtra)
+{
+   assert(pcKey != NULL);
+   assert(pvExtra != NULL);
+
+   ASSURE(*(const size_t*)pvValue == strlen(pcKey));
+   (*(int*)pvExtra)++;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test keys of every length from 0 to MAX_KEY_LENGTH - 1, which spans
+   the boundary between keys an implementation stores inside its
+   bindings and keys it stores elsewhere. */
+
+static void testKeyLengths(void)
+{
+   enum {MAX_KEY_LENGTH = 48};
+
+   SymTable_T oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   size_t auLengths[MAX_KEY_LENGTH];
+   size_t *puValue;
+   size_t u;
+   int iCount = 0;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a SymTable object with keys of many lengths.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   for (u = 0; u < MAX_KEY_LENGTH; u++)
+   {
+      memset(acKey, 'k', u);
+      acKey[u] = '\0';
+      auLengths[u] = u;
+      iSuccessful = SymTable_put(oSymTable, acKey, &auLengths[u]);
+      ASSURE(iSuccessful);
+      /* The table must own its copy of the key. */
+      memset(acKey, 'x', u);
+   }
+
+   for (u = 0; u < MAX_KEY_LENGTH; u++)
+   {
+      memset(acKey, 'k', u);
+      acKey[u] = '\0';
+      puValue = (size_t*)SymTable_get(oSymTable, acKey);
+      ASSURE(puValue == &auLengths[u]);
+      if (u > 0)
+      {
+         acKey[u - 1] = 'x';
+         ASSURE(! SymTable_contains(oSymTable, acKey));
+      }
+   }
+
+   SymTable_map(oSymTable, countBinding, &iCount);
+   ASSURE(iCount == MAX_KEY_LENGTH);
+
+   for (u = 0; u < MAX_KEY_LENGTH; u += 2)
+   {
+      memset(acKey, 'k', u);
+      acKey[u] = '\0';
+      puValue = (size_t*)SymTable_remove(oSymTable, acKey);
+      ASSURE(puValue == &auLengths[u]);
+   }
+   ASSURE(SymTable_getLength(oSymTable) == MAX_KEY_LENGTH / 2);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_intern(), SymTable_putInterned() and
+   SymTable_getInterned(), sharing interned keys among several
+   SymTable objects. */
+
+static void testInterning(void)
+{
+   enum {TABLE_COUNT = 4};
+   enum {KEY_COUNT = 64};
+
+   SymTable_T aoSymTables[TABLE_COUNT];
+   const char *apcInterned[KEY_COUNT];
+   char acKey[48];
+   int aiValues[KEY_COUNT];
+   int i;
+   int t;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing interned keys shared by SymTable objects.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   /* Short and long keys, so both inline and out-of-line storage
+      are exercised. */
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      sprintf(acKey, i % 2 ? "short%d" : "a_much_longer_interned_key_%d", i);
+      apcInterned[i] = SymTable_intern(acKey);
+      ASSURE(apcInterned[i] != NULL);
+      ASSURE(apcInterned[i] != acKey);
+      ASSURE(strcmp(apcInterned[i], acKey) == 0);
+      ASSURE(SymTable_intern(acKey) == apcInterned[i]);
+      aiValues[i] = i;
+   }
+   ASSURE(apcInterned[0] != apcInterned[1]);
+
+   for (t = 0; t < TABLE_COUNT; t++)
+   {
+      aoSymTables[t] = SymTable_new();
+      ASSURE(aoSymTables[t] != NULL);
+      /* Table t holds every key whose index is not a multiple of t+2. */
+      for (i = 0; i < KEY_COUNT; i++)
+         if (i % (t + 2) != 0)
+         {
+            iSuccessful = SymTable_putInterned(aoSymTables[t],
+               apcInterned[i], &aiValues[i]);
+            ASSURE(iSuccessful);
+         }
+   }
+
+   for (t = 0; t < TABLE_COUNT; t++)
+      for (i = 0; i < KEY_COUNT; i++)
+      {
+         sprintf(acKey, i % 2 ? "short%d" : "a_much_longer_interned_key_%d", i);
+         if (i % (t + 2) != 0)
+         {
+            ASSURE(SymTable_getInterned(aoSymTables[t], apcInterned[i])
+               == &aiValues[i]);
+            /* Interned and copied keys are the same key. */
+            ASSURE(SymTable_get(aoSymTables[t], acKey) == &aiValues[i]);
+            ASSURE(! SymTable_put(aoSymTables[t], acKey, NULL));
+            ASSURE(! SymTable_putInterned(aoSymTables[t],
+               apcInterned[i], NULL));
+         }
+         else
+         {
+            ASSURE(SymTable_getInterned(aoSymTables[t], apcInterned[i])
+               == NULL);
+            ASSURE(! SymTable_contains(aoSymTables[t], acKey));
+         }
+      }
+
+   /* A key put by copy is found through its interned pointer. */
+   iSuccessful = SymTable_put(aoSymTables[0], "short0", &aiValues[0]);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_getInterned(aoSymTables[0], SymTable_intern("short0"))
+      == &aiValues[0]);
+
+   ASSURE(SymTable_remove(aoSymTables[1], apcInterned[1]) == &aiValues[1]);
+   ASSURE(SymTable_getInterned(aoSymTables[1], apcInterned[1]) == NULL);
+   ASSURE(strcmp(apcInterned[1], "short1") == 0);
+
+   for (t = 0; t < TABLE_COUNT; t++)
+      SymTable_free(aoSymTables[t]);
+   SymTable_internFree();
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_putN(), SymTable_getN(), SymTable_hashKey() and
+   SymTable_getHashed() on slices of a buffer that are not
+   NUL-terminated, reusing each hash in two nested scopes. */
+
+static void testSlices(void)
+{
+   /* Tokens are separated by single spaces; the last is not followed
+      by a NUL in the slice passed to the table. */
+   static const char acSource[] =
+      "alpha beta alphabet a_long_identifier_that_is_not_inline beta";
+   enum {TOKEN_COUNT = 5};
+
+   SymTable_T oOuter;
+   SymTable_T oInner;
+   const char *apcToken[TOKEN_COUNT];
+   size_t auLength[TOKEN_COUNT];
+   size_t uHash;
+   const char *pc;
+   void *pvValue;
+   int i;
+   int iSuccessful;
+   int aiValues[TOKEN_COUNT];
+
+   printf("------------------------------------------------------\n");
+   printf("Testing keys given by length and by precomputed hash.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   pc = acSource;
+   for (i = 0; i < TOKEN_COUNT; i++)
+   {
+      apcToken[i] = pc;
+      while (*pc != ' ' && *pc != '\0')
+         pc++;
+      auLength[i] = (size_t)(pc - apcToken[i]);
+      if (*pc == ' ')
+         pc++;
+      aiValues[i] = i;
+   }
+
+   oOuter = SymTable_new();
+   ASSURE(oOuter != NULL);
+   oInner = SymTable_new();
+   ASSURE(oInner != NULL);
+
+   /* The outer scope holds every token but "alphabet"; tokens 1 and 4
+      are both "beta". */
+   for (i = 0; i < TOKEN_COUNT; i++)
+      if (i != 2)
+      {
+         iSuccessful = SymTable_putN(oOuter, apcToken[i], auLength[i],
+            &aiValues[i]);
+         ASSURE(iSuccessful == (i != 4));
+      }
+   ASSURE(SymTable_getLength(oOuter) == 3);
+
+   /* Stored keys are NUL-terminated copies. */
+   ASSURE(SymTable_get(oOuter, "alpha") == &aiValues[0]);
+   ASSURE(SymTable_get(oOuter, "beta") == &aiValues[1]);
+   ASSURE(SymTable_contains(oOuter,
+      "a_long_identifier_that_is_not_inline"));
+   ASSURE(! SymTable_contains(oOuter, "alphabet"));
+
+   /* A prefix of a stored key is a different key. */
+   ASSURE(SymTable_getN(oOuter, acSource, 3) == NULL);
+   ASSURE(SymTable_getN(oOuter, apcToken[2], auLength[2]) == NULL);
+   ASSURE(SymTable_getN(oOuter, apcToken[2], 5) == &aiValues[0]);
+
+   iSuccessful = SymTable_putN(oInner, apcToken[2], auLength[2],
+      &aiValues[2]);
+   ASSURE(iSuccessful);
+
+   /* Hash each token once and look it up innermost scope first. */
+   for (i = 0; i < TOKEN_COUNT; i++)
+   {
+      uHash = SymTable_hashKey(oInner, apcToken[i], auLength[i]);
+      ASSURE(uHash == SymTable_hashKey(oOuter, apcToken[i], auLength[i]));
+      pvValue = SymTable_getHashed(oInner, apcToken[i], auLength[i], uHash);
+      if (pvValue == NULL)
+         pvValue = SymTable_getHashed(oOuter, apcToken[i], auLength[i],
+            uHash);
+      ASSURE(pvValue == &aiValues[i == 4 ? 1 : i]);
+   }
+
+   /* The empty key. */
+   uHash = SymTable_hashKey(oInner, acSource, 0);
+   iSuccessful = SymTable_putHashed(oInner, acSource, 0, uHash, NULL);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_contains(oInner, ""));
+   ASSURE(! SymTable_putN(oInner, "", 0, NULL));
+
+   SymTable_free(oInner);
+   SymTable_free(oOuter);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_getOrPut() by counting the occurrences of
+   DISTINCT_COUNT keys among iBindingCount lookups. */
+
+static void testGetOrPut(int iBindingCount)
+{
+   enum {DISTINCT_COUNT = 100};
+   enum {MAX_KEY_LENGTH = 16};
+
+   SymTable_T oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   int aiCounts[DISTINCT_COUNT];
+   int iOther = 0;
+   const void **ppvValue;
+   int i;
+   int iCreated;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable_getOrPut().\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   for (i = 0; i < DISTINCT_COUNT; i++)
+      aiCounts[i] = 0;
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i % DISTINCT_COUNT);
+      ppvValue = SymTable_getOrPut(oSymTable, acKey,
+         &aiCounts[i % DISTINCT_COUNT], &iCreated);
+      ASSURE(ppvValue != NULL);
+      ASSURE(iCreated == (i < DISTINCT_COUNT));
+      ASSURE(*ppvValue == &aiCounts[i % DISTINCT_COUNT]);
+      (*(int*)*ppvValue)++;
+   }
+
+   ASSURE(SymTable_getLength(oSymTable) ==
+      (size_t)(iBindingCount < DISTINCT_COUNT
+               ? iBindingCount : DISTINCT_COUNT));
+   for (i = 0; i < DISTINCT_COUNT && i < iBindingCount; i++)
+      ASSURE(aiCounts[i] == iBindingCount / DISTINCT_COUNT
+             + (i < iBindingCount % DISTINCT_COUNT));
+
+   /* Storing through the returned pointer updates the binding. */
+   ppvValue = SymTable_getOrPut(oSymTable, "update", NULL, NULL);
+   ASSURE(ppvValue != NULL);
+   ASSURE(*ppvValue == NULL);
+   *ppvValue = &iOther;
+   ASSURE(SymTable_get(oSymTable, "update") == &iOther);
+   ASSURE(! SymTable_put(oSymTable, "update", NULL));
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_putBatch(), SymTable_getBatch() and
+   SymTable_removeBatch() on a batch of iBindingCount keys in which
+   every key appears twice, so later copies see earlier ones. */
+
+static void testBatch(int iBindingCount)
+{
+   enum {MAX_KEY_LENGTH = 32};
+
+   SymTable_T oSymTable;
+   char (*pacKeys)[MAX_KEY_LENGTH];
+   const char **ppcKeys;
+   void **ppvValues;
+   int *piResults;
+   size_t uCount;
+   size_t u;
+   size_t uResult;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the batch functions.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   /* Keys 2u and 2u+1 are equal; odd-numbered distinct keys are long. */
+   uCount = (size_t)iBindingCount * 2;
+   pacKeys = malloc((uCount + 1) * MAX_KEY_LENGTH);
+   ppcKeys = malloc((uCount + 1) * sizeof(*ppcKeys));
+   ppvValues = malloc((uCount + 1) * sizeof(*ppvValues));
+   piResults = malloc((uCount + 1) * sizeof(*piResults));
+   ASSURE(pacKeys != NULL && ppcKeys != NULL && ppvValues != NULL
+          && piResults != NULL);
+   for (u = 0; u < uCount; u++)
+   {
+      sprintf(pacKeys[u], u / 2 % 2 ? "batch_key_long_enough_%lu" : "b%lu",
+         (unsigned long)(u / 2));
+      ppcKeys[u] = pacKeys[u];
+      ppvValues[u] = pacKeys[u];
+   }
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   uResult = SymTable_putBatch(oSymTable, ppcKeys,
+      (const void *const *)ppvValues, uCount, piResults);
+   ASSURE(uResult == (size_t)iBindingCount);
+   ASSURE(SymTable_getLength(oSymTable) == (size_t)iBindingCount);
+   for (u = 0; u < uCount; u++)
+      ASSURE(piResults[u] == (u % 2 == 0));
+
+   /* Append one absent key. */
+   strcpy(pacKeys[uCount], "absent");
+   ppcKeys[uCount] = pacKeys[uCount];
+   SymTable_getBatch(oSymTable, ppcKeys, uCount + 1, ppvValues);
+   for (u = 0; u < uCount; u++)
+      ASSURE(ppvValues[u] == pacKeys[u - u % 2]);
+   ASSURE(ppvValues[uCount] == NULL);
+
+   /* The second copy of each key finds it already removed. */
+   uResult = SymTable_removeBatch(oSymTable, ppcKeys, uCount + 1,
+      ppvValues);
+   ASSURE(uResult == (size_t)iBindingCount);
+   for (u = 0; u < uCount + 1; u++)
+      ASSURE(ppvValues[u] == (u % 2 == 0 && u < uCount ? pacKeys[u] : NULL));
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+
+   ASSURE(SymTable_putBatch(oSymTable, ppcKeys, NULL, 0, NULL) == 0);
+   ASSURE(SymTable_removeBatch(oSymTable, ppcKeys, uCount, NULL) == 0);
+
+   SymTable_free(oSymTable);
+   free(piResults);
+   free(ppvValues);
+   free(ppcKeys);
+   free(pacKeys);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* A table and the number of its bindings that lookUpBinding() has
+   visited. */
+
+struct LookupCount
+{
+   SymTable_T oSymTable;
+   int iCount;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Look up pcKey in the table of the struct LookupCount that pvExtra
+   points to, check that it is bound to pvValue, and count it. */
+
+static void lookUpBinding(const char *pcKey, void *pvValue,
+   void *pvExtra)
+{
+   struct LookupCount *psCount = pvExtra;
+
+   assert(pcKey != NULL);
+   assert(pvExtra != NULL);
+
+   ASSURE(SymTable_get(psCount->oSymTable, pcKey) == pvValue);
+   psCount->iCount++;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test a SymTable object that resizes incrementally, checking lookups,
+   removals and SymTable_map() while resizes are still in progress, as
+   iBindingCount bindings are put into it and half are removed again. */
+
+static void testIncrementalResize(int iBindingCount)
+{
+   enum {MAX_KEY_LENGTH = 16};
+
+   SymTable_T oSymTable;
+   struct LookupCount sLookups;
+   char (*pacKeys)[MAX_KEY_LENGTH];
+   size_t *puLengths;
+   int i;
+   int iCount;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a SymTable object that resizes incrementally.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   pacKeys = malloc((size_t)(iBindingCount + 1) * MAX_KEY_LENGTH);
+   puLengths = malloc((size_t)(iBindingCount + 1) * sizeof(*puLengths));
+   ASSURE(pacKeys != NULL && puLengths != NULL);
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   /* An implementation may not support the mode; the results must be
+      the same either way. */
+   SymTable_setIncrementalResize(oSymTable, 1);
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(pacKeys[i], "inc%d", i);
+      puLengths[i] = strlen(pacKeys[i]);
+      ASSURE(SymTable_put(oSymTable, pacKeys[i], &puLengths[i]));
+      ASSURE(! SymTable_put(oSymTable, pacKeys[i], &puLengths[i]));
+      /* Keys put long ago may still sit in an old bucket array. */
+      ASSURE(SymTable_get(oSymTable, pacKeys[i / 2]) == &puLengths[i / 2]);
+      if (i % 1024 == 0)
+      {
+         iCount = 0;
+         SymTable_map(oSymTable, countBinding, &iCount);
+         ASSURE(iCount == i + 1);
+      }
+      /* Lookups made by SymTable_map()'s callback must not make it
+         miss bindings in the middle of a resize, such as the first
+         one, which starts within the first few hundred puts. */
+      if (i < 600)
+      {
+         sLookups.oSymTable = oSymTable;
+         sLookups.iCount = 0;
+         SymTable_map(oSymTable, lookUpBinding, &sLookups);
+         ASSURE(sLookups.iCount == i + 1);
+      }
+   }
+   ASSURE(SymTable_getLength(oSymTable) == (size_t)iBindingCount);
+
+   for (i = 0; i < iBindingCount; i += 2)
+      ASSURE(SymTable_remove(oSymTable, pacKeys[i]) == &puLengths[i]);
+   for (i = 0; i < iBindingCount; i++)
+      ASSURE(SymTable_contains(oSymTable, pacKeys[i]) == (i % 2 == 1));
+
+   iCount = 0;
+   SymTable_map(oSymTable, countBinding, &iCount);
+   ASSURE(iCount == iBindingCount / 2);
+   ASSURE(SymTable_getLength(oSymTable) == (size_t)(iBindingCount / 2));
+
+   /* Switching back must finish any resize in progress. */
+   SymTable_setIncrementalResize(oSymTable, 0);
+   for (i = 1; i < iBindingCount; i += 2)
+      ASSURE(SymTable_get(oSymTable, pacKeys[i]) == &puLengths[i]);
+
+   SymTable_free(oSymTable);
+   free(puLengths);
+   free(pacKeys);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_reserve(), SymTable_shrinkToFit() and shrinking on
+   remove with a SymTable object that holds up to iBindingCount
+   bindings. */
+
+static void testReserveAndShrink(int iBindingCount)
+{
+   enum {MAX_KEY_LENGTH = 16};
+
+   SymTable_T oSymTable;
+   struct SymTable_Stats sStats;
+   char acKey[MAX_KEY_LENGTH];
+   size_t uResizes;
+   size_t uPeakBuckets;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable_reserve() and shrinking a SymTable object.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   /* After a reserve, a bulk load must not resize again. */
+   ASSURE(SymTable_reserve(oSymTable, (size_t)iBindingCount));
+   SymTable_getStats(oSymTable, &sStats);
+   ASSURE(sStats.uGrowAt >= (size_t)iBindingCount);
+   uResizes = sStats.uResizeCount;
+   ASSURE(SymTable_reserve(oSymTable, 0));
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_put(oSymTable, acKey, NULL));
+   }
+   SymTable_getStats(oSymTable, &sStats);
+   ASSURE(sStats.uResizeCount == uResizes);
+   uPeakBuckets = sStats.uBucketCount;
+
+   /* Removing almost everything must give the buckets back. */
+   for (i = 1; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_remove(oSymTable, acKey) == NULL);
+      SymTable_getStats(oSymTable, &sStats);
+      ASSURE(sStats.uLength >= sStats.uShrinkAt);
+   }
+   ASSURE(SymTable_getLength(oSymTable) == (size_t)(iBindingCount > 0));
+   if (iBindingCount > 0)
+      ASSURE(SymTable_contains(oSymTable, "0"));
+   SymTable_getStats(oSymTable, &sStats);
+   ASSURE(sStats.uBucketCount <= uPeakBuckets);
+   if (sStats.dMaxLoadFactor > 0.0 && iBindingCount >= 10000)
+      ASSURE(sStats.uBucketCount < uPeakBuckets);
+
+   /* Puts and removes around one length must not resize each time. */
+   uResizes = sStats.uResizeCount;
+   for (i = 0; i < 1000; i++)
+   {
+      ASSURE(SymTable_put(oSymTable, "churn", NULL));
+      ASSURE(SymTable_remove(oSymTable, "churn") == NULL);
+   }
+   SymTable_getStats(oSymTable, &sStats);
+   ASSURE(sStats.uResizeCount == uResizes);
+
+   /* Shrinking to fit must keep every binding. */
+   for (i = 0; i < iBindingCount; i += 3)
+   {
+      sprintf(acKey, "%d", i);
+      SymTable_put(oSymTable, acKey, NULL);
+   }
+   for (i = 0; i < iBindingCount; i += 6)
+   {
+      sprintf(acKey, "%d", i);
+      SymTable_remove(oSymTable, acKey);
+   }
+   SymTable_shrinkToFit(oSymTable);
+   SymTable_getStats(oSymTable, &sStats);
+   if (sStats.dMaxLoadFactor > 0.0)
+      ASSURE(sStats.dLoadFactor <= sStats.dMaxLoadFactor);
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_contains(oSymTable, acKey) == (i % 3 == 0 && i % 6 != 0));
+   }
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable objects created with each hash function, putting
+   iBindingCount bindings with short and long keys into each and looking
+   them up through every lookup path. A hash from SymTable_hashKey() must
+   also work on a second table created with the same function, as the
+   scopes of a nested symbol table are. */
+
+static void testHashFunctions(int iBindingCount)
+{
+   enum {MAX_KEY_LENGTH = 96};
+   static const enum SymTable_HashFunction HASH_FUNCTIONS[] = {
+      SYMTABLE_HASH_LEGACY, SYMTABLE_HASH_WORD, SYMTABLE_HASH_KEYED};
+   enum {HASH_FUNCTION_COUNT =
+      sizeof(HASH_FUNCTIONS) / sizeof(HASH_FUNCTIONS[0])};
+
+   SymTable_T oSymTable;
+   SymTable_T oScope;
+   char acKey[MAX_KEY_LENGTH];
+   const char *pcInterned;
+   size_t uLength;
+   size_t uHash;
+   int iFunction;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable objects with each hash function.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   for (iFunction = 0; iFunction < HASH_FUNCTION_COUNT; iFunction++)
+   {
+      oSymTable = SymTable_newWithHash(HASH_FUNCTIONS[iFunction]);
+      ASSURE(oSymTable != NULL);
+
+      /* Key lengths cycle through 1 to 80, crossing every word and
+         block boundary of the hash functions. Every other key is put
+         with the hash from SymTable_hashKey(), so the plain lookups
+         below check that it is the hash the table uses itself. */
+      for (i = 0; i < iBindingCount; i++)
+      {
+         uLength = (size_t)sprintf(acKey, "%d", i);
+         memset(acKey + uLength, 'x', (size_t)(i % 80));
+         uLength += (size_t)(i % 80);
+         acKey[uLength] = '\0';
+         if (i % 2 == 0)
+            ASSURE(SymTable_put(oSymTable, acKey, (void*)acKey));
+         else
+            ASSURE(SymTable_putHashed(oSymTable, acKey, uLength,
+               SymTable_hashKey(oSymTable, acKey, uLength), (void*)acKey));
+      }
+      ASSURE(SymTable_getLength(oSymTable) == (size_t)iBindingCount);
+
+      for (i = 0; i < iBindingCount; i++)
+      {
+         uLength = (size_t)sprintf(acKey, "%d", i);
+         memset(acKey + uLength, 'x', (size_t)(i % 80));
+         uLength += (size_t)(i % 80);
+         acKey[uLength] = '\0';
+         ASSURE(SymTable_get(oSymTable, acKey) == (void*)acKey);
+         ASSURE(SymTable_getHashed(oSymTable, acKey, uLength,
+            SymTable_hashKey(oSymTable, acKey, uLength)) == (void*)acKey);
+         ASSURE(SymTable_getN(oSymTable, acKey, uLength) == (void*)acKey);
+      }
+      ASSURE(! SymTable_contains(oSymTable, "missing"));
+
+      pcInterned = SymTable_intern("interned key");
+      ASSURE(pcInterned != NULL);
+      ASSURE(SymTable_putInterned(oSymTable, pcInterned, (void*)pcInterned));
+      ASSURE(SymTable_get(oSymTable, "interned key") == (void*)pcInterned);
+      ASSURE(SymTable_getInterned(oSymTable, pcInterned) == (void*)pcInterned);
+      ASSURE(SymTable_remove(oSymTable, "interned key") == (void*)pcInterned);
+
+      oScope = SymTable_newWithHash(HASH_FUNCTIONS[iFunction]);
+      ASSURE(oScope != NULL);
+      for (i = 0; i < iBindingCount; i++)
+      {
+         uLength = (size_t)sprintf(acKey, "%d", i);
+         uHash = SymTable_hashKey(oSymTable, acKey, uLength);
+         ASSURE(SymTable_hashKey(oScope, acKey, uLength) == uHash);
+         if (i % 2 == 0)
+            ASSURE(SymTable_putHashed(oScope, acKey, uLength, uHash,
+               (void*)oScope));
+      }
+      for (i = 0; i < iBindingCount; i++)
+      {
+         uLength = (size_t)sprintf(acKey, "%d", i);
+         ASSURE(SymTable_get(oScope, acKey) ==
+            (i % 2 == 0 ? (void*)oScope : NULL));
+      }
+      SymTable_free(oScope);
+
+      SymTable_free(oSymTable);
+   }
+   SymTable_internFree();
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test how evenly the hash of a SymTable object spreads iBindingCount
+   keys of several regular shapes over its buckets, reducing
+   SymTable_hashKey() modulo the bucket count as a chained table does.
+   No bucket may hold more than MAX_CHAIN keys. */
+
+static void testBucketSpread(int iBindingCount)
+{
+   enum {MAX_KEY_LENGTH = 32, MAX_CHAIN = 16};
+   static const char *const KEY_FORMATS[] = {
+      "%d", "identifier_%d", "%d000", "x%dy%dz"};
+   enum {KEY_FORMAT_COUNT = sizeof(KEY_FORMATS) / sizeof(KEY_FORMATS[0])};
+
+   SymTable_T oSymTable;
+   struct SymTable_Stats sStats;
+   char acKey[MAX_KEY_LENGTH];
+   unsigned *puCounts;
+   unsigned uLongest;
+   size_t uBucket;
+   int iFormat;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the spread of keys over the buckets of a SymTable.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   for (iFormat = 0; iFormat < KEY_FORMAT_COUNT; iFormat++)
+   {
+      oSymTable = SymTable_new();
+      ASSURE(oSymTable != NULL);
+      for (i = 0; i < iBindingCount; i++)
+      {
+         sprintf(acKey, KEY_FORMATS[iFormat], i, i);
+         SymTable_put(oSymTable, acKey, NULL);
+      }
+
+      SymTable_getStats(oSymTable, &sStats);
+      if (sStats.uBucketCount > 1)
+      {
+         puCounts = calloc(sStats.uBucketCount, sizeof(*puCounts));
+         ASSURE(puCounts != NULL);
+         uLongest = 0;
+         for (i = 0; i < iBindingCount; i++)
+         {
+            sprintf(acKey, KEY_FORMATS[iFormat], i, i);
+            uBucket = SymTable_hashKey(oSymTable, acKey, strlen(acKey))
+               % sStats.uBucketCount;
+            if (++puCounts[uBucket] > uLongest)
+               uLongest = puCounts[uBucket];
+         }
+         ASSURE(uLongest <= MAX_CHAIN);
+         free(puCounts);
+      }
+      SymTable_free(oSymTable);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* An Order object follows one ordered traversal:
+   - pcLast: the key of the last binding visited, or NULL.
+   - iCount: the number of bindings visited. */
+
+struct Order
+{
+   const char *pcLast;
+   int iCount;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Check that pcKey follows the last key the Order pvExtra visited, and
+   count it. */
+
+static void checkOrder(const char *pcKey, void *pvValue, void *pvExtra)
+{
+   struct Order *psOrder = (struct Order*)pvExtra;
+
+   assert(pcKey != NULL);
+   assert(pvExtra != NULL);
+   (void)pvValue;
+
+   ASSURE(psOrder->pcLast == NULL || strcmp(psOrder->pcLast, pcKey) < 0);
+   psOrder->pcLast = pcKey;
+   psOrder->iCount++;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of bindings of oSymTable with keys in [pcLow,
+   pcHigh), checking that SymTable_mapRange() visits them in order. */
+
+static int countRange(SymTable_T oSymTable, const char *pcLow,
+   const char *pcHigh)
+{
+   struct Order sOrder = {NULL, 0};
+   ASSURE(SymTable_mapRange(oSymTable, pcLow, pcHigh, checkOrder,
+      &sOrder));
+   return sOrder.iCount;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of bindings of oSymTable with keys that start with
+   pcPrefix, checking that SymTable_mapPrefix() visits them in order. */
+
+static int countPrefix(SymTable_T oSymTable, const char *pcPrefix)
+{
+   struct Order sOrder = {NULL, 0};
+   ASSURE(SymTable_mapPrefix(oSymTable, pcPrefix, checkOrder, &sOrder));
+   return sOrder.iCount;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of integers i with iLow <= i < iHigh and
+   0 <= i < iCount. */
+
+static int countBetween(int iLow, int iHigh, int iCount)
+{
+   if (iHigh > iCount) iHigh = iCount;
+   return iHigh > iLow ? iHigh - iLow : 0;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_mapRange() and SymTable_mapPrefix() on a SymTable
+   object holding iBindingCount bindings put in a scattered order,
+   before and after removing every other one. */
+
+static void testOrderedQueries(int iBindingCount)
+{
+   enum {MAX_KEY_LENGTH = 32, TAIL_COUNT = 100};
+   const unsigned long long STRIDE = 2654435761ULL;
+
+   SymTable_T oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   int iIndex;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing ordered queries on a SymTable object.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   ASSURE(countRange(oSymTable, NULL, NULL) == 0);
+   ASSURE(countPrefix(oSymTable, "") == 0);
+
+   /* Keys of eight characters, and keys that differ only past a long
+      shared prefix. */
+   for (i = 0; i < iBindingCount; i++)
+   {
+      iIndex = (int)(((unsigned long long)i * STRIDE)
+         % (unsigned long long)iBindingCount);
+      sprintf(acKey, "k%07d", iIndex);
+      ASSURE(SymTable_put(oSymTable, acKey, NULL));
+   }
+   for (i = 0; i < TAIL_COUNT; i++)
+   {
+      sprintf(acKey, "longcommonprefix_%d", i);
+      ASSURE(SymTable_put(oSymTable, acKey, NULL));
+   }
+
+   ASSURE(countRange(oSymTable, NULL, NULL) == iBindingCount + TAIL_COUNT);
+   ASSURE(countRange(oSymTable, "k", "l") == iBindingCount);
+   ASSURE(countRange(oSymTable, "k0000010", "k0000020")
+      == countBetween(10, 20, iBindingCount));
+   ASSURE(countRange(oSymTable, "k0000010x", NULL)
+      == countBetween(11, iBindingCount, iBindingCount) + TAIL_COUNT);
+   ASSURE(countRange(oSymTable, NULL, "k0000005")
+      == countBetween(0, 5, iBindingCount));
+   ASSURE(countRange(oSymTable, "l", "k") == 0);
+   ASSURE(countPrefix(oSymTable, "") == iBindingCount + TAIL_COUNT);
+   ASSURE(countPrefix(oSymTable, "k00001")
+      == countBetween(100, 200, iBindingCount));
+   ASSURE(countPrefix(oSymTable, "longcommonprefix_1") == 11);
+   ASSURE(countPrefix(oSymTable, "longcommonprefix_") == TAIL_COUNT);
+   ASSURE(countPrefix(oSymTable, "z") == 0);
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      iIndex = (int)(((unsigned long long)i * STRIDE)
+         % (unsigned long long)iBindingCount);
+      if (iIndex % 2 != 0)
+         continue;
+      sprintf(acKey, "k%07d", iIndex);
+      ASSURE(SymTable_remove(oSymTable, acKey) == NULL);
+      ASSURE(! SymTable_contains(oSymTable, acKey));
+   }
+   ASSURE(countRange(oSymTable, "k", "l") == iBindingCount / 2);
+   ASSURE(countPrefix(oSymTable, "k00001")
+      == countBetween(100, 200, iBindingCount) / 2);
+   for (i = 1; i < iBindingCount; i += 2)
+   {
+      sprintf(acKey, "k%07d", i);
+      ASSURE(SymTable_contains(oSymTable, acKey));
+   }
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Store pcKey in the const char * at pvExtra unless it already holds a
+   key, so that it ends up holding the first key visited. */
+
+static void recordFirst(const char *pcKey, void *pvValue, void *pvExtra)
+{
+   const char **ppcFirst = (const char**)pvExtra;
+
+   assert(pcKey != NULL);
+   assert(pvExtra != NULL);
+   (void)pvValue;
+
+   if (*ppcFirst == NULL)
+      *ppcFirst = pcKey;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_setReorder() in each mode on a SymTable object holding
+   up to iBindingCount bindings: lookups must keep finding every
+   binding, and a key looked up often enough must come first. */
+
+static void testReorder(int iBindingCount)
+{
+   enum {MAX_KEY_LENGTH = 16, MAX_SCOPE = 500};
+   static const enum SymTable_Reorder REORDERS[] = {
+      SYMTABLE_REORDER_NONE, SYMTABLE_REORDER_MOVE_TO_FRONT,
+      SYMTABLE_REORDER_TRANSPOSE};
+   enum {REORDER_COUNT = sizeof(REORDERS) / sizeof(REORDERS[0])};
+
+   SymTable_T oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   size_t auLengths[MAX_SCOPE];
+   const char *pcFirst;
+   int iCount = iBindingCount < MAX_SCOPE ? iBindingCount : MAX_SCOPE;
+   int iReorder;
+   int iIndex;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a self-organizing SymTable object.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   for (iReorder = 0; iReorder < REORDER_COUNT; iReorder++)
+   {
+      oSymTable = SymTable_new();
+      ASSURE(oSymTable != NULL);
+      for (i = 0; i < iCount; i++)
+      {
+         auLengths[i] = (size_t)sprintf(acKey, "%d", i);
+         ASSURE(SymTable_put(oSymTable, acKey, &auLengths[i]));
+      }
+      if (! SymTable_setReorder(oSymTable, REORDERS[iReorder]))
+      {
+         ASSURE(REORDERS[iReorder] != SYMTABLE_REORDER_NONE);
+         SymTable_free(oSymTable);
+         continue;
+      }
+
+      /* Skewed lookups, mostly of small indices. */
+      for (i = 0; i < 4 * iCount; i++)
+      {
+         iIndex = (i % 7 == 0) ? i / 4 : i % 5;
+         if (iIndex >= iCount)
+            iIndex = 0;
+         sprintf(acKey, "%d", iIndex);
+         ASSURE(SymTable_get(oSymTable, acKey) == &auLengths[iIndex]);
+         ASSURE(SymTable_contains(oSymTable, acKey));
+      }
+      ASSURE(SymTable_getLength(oSymTable) == (size_t)iCount);
+      for (i = 0; i < iCount; i++)
+      {
+         sprintf(acKey, "%d", i);
+         ASSURE(SymTable_replace(oSymTable, acKey, &auLengths[i])
+            == &auLengths[i]);
+      }
+      ASSURE(SymTable_get(oSymTable, "missing") == NULL);
+
+      /* One lookup moves a key to the front; iCount swaps do too. */
+      if (REORDERS[iReorder] != SYMTABLE_REORDER_NONE && iCount > 0)
+      {
+         sprintf(acKey, "%d", iCount - 1);
+         for (i = 0; i < iCount; i++)
+         {
+            ASSURE(SymTable_getN(oSymTable, acKey, strlen(acKey))
+               == &auLengths[iCount - 1]);
+            if (REORDERS[iReorder] == SYMTABLE_REORDER_MOVE_TO_FRONT)
+               break;
+         }
+         pcFirst = NULL;
+         SymTable_map(oSymTable, recordFirst, &pcFirst);
+         ASSURE(pcFirst != NULL && strcmp(pcFirst, acKey) == 0);
+      }
+
+      for (i = 0; i < iCount; i++)
+      {
+         sprintf(acKey, "%d", i);
+         ASSURE(SymTable_remove(oSymTable, acKey) == &auLengths[i]);
+      }
+      ASSURE(SymTable_getLength(oSymTable) == 0);
+      SymTable_free(oSymTable);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Count the binding whose value pvValue points to an int in pvExtra's
+   int array by incrementing that int, and stop with a nonzero result
+   once the number of bindings counted reaches the limit that the
+   array's first element holds. */
+
+static int countUntil(const char *pcKey, void *pvValue, void *pvExtra)
+{
+   int *piCounts = (int*)pvExtra;
+
+   assert(pcKey != NULL);
+   assert(pvValue != NULL);
+   assert(pvExtra != NULL);
+
+   (*(int*)pvValue)++;
+   piCounts[1]++;
+   return piCounts[1] == piCounts[0] ? 7 : 0;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_iterBegin(), SymTable_iterNext() and SymTable_mapUntil()
+   with a SymTable object that held iBindingCount bindings and keeps
+   every other one. */
+
+static void testIteration(int iBindingCount)
+{
+   enum {MAX_KEY_LENGTH = 16};
+
+   SymTable_T oSymTable;
+   struct SymTable_Iter sIter;
+   char (*pacKeys)[MAX_KEY_LENGTH];
+   int *piVisits;
+   int aiCounts[2];
+   const char *pcKey;
+   void *pvValue;
+   int i;
+   int iCount;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable iterators and SymTable_mapUntil.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   pacKeys = malloc((size_t)(iBindingCount + 1) * MAX_KEY_LENGTH);
+   piVisits = calloc((size_t)iBindingCount + 1, sizeof(*piVisits));
+   ASSURE(pacKeys != NULL && piVisits != NULL);
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   /* An empty table has nothing to visit. */
+   SymTable_iterBegin(oSymTable, &sIter);
+   ASSURE(! SymTable_iterNext(oSymTable, &sIter, &pcKey, &pvValue));
+   aiCounts[0] = 1;
+   aiCounts[1] = 0;
+   ASSURE(SymTable_mapUntil(oSymTable, countUntil, aiCounts) == 0);
+   ASSURE(aiCounts[1] == 0);
+
+   /* Iteration must also cover a resize still in progress. */
+   SymTable_setIncrementalResize(oSymTable, 1);
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(pacKeys[i], "it%d", i);
+      ASSURE(SymTable_put(oSymTable, pacKeys[i], &piVisits[i]));
+   }
+   for (i = 0; i < iBindingCount; i += 2)
+      ASSURE(SymTable_remove(oSymTable, pacKeys[i]) == &piVisits[i]);
+
+   /* Each remaining binding is visited once, and lookups between steps
+      do not disturb the traversal. */
+   iCount = 0;
+   SymTable_iterBegin(oSymTable, &sIter);
+   while (SymTable_iterNext(oSymTable, &sIter, &pcKey, &pvValue))
+   {
+      ASSURE(SymTable_get(oSymTable, pcKey) == pvValue);
+      (*(int*)pvValue)++;
+      if (iCount++ == iBindingCount / 4)
+         for (i = 1; i < iBindingCount; i += 2)
+            ASSURE(SymTable_get(oSymTable, pacKeys[i]) == &piVisits[i]);
+   }
+   ASSURE(iCount == iBindingCount / 2);
+   ASSURE(! SymTable_iterNext(oSymTable, &sIter, NULL, NULL));
+   for (i = 0; i < iBindingCount; i++)
+      ASSURE(piVisits[i] == i % 2);
+
+   /* A traversal that stops early visits exactly the bindings it
+      counted, and one that does not stop visits them all. */
+   aiCounts[0] = iBindingCount / 4 + 1;
+   aiCounts[1] = 0;
+   ASSURE(SymTable_mapUntil(oSymTable, countUntil, aiCounts)
+      == (aiCounts[0] <= iBindingCount / 2 ? 7 : 0));
+   ASSURE(aiCounts[1] == (aiCounts[0] <= iBindingCount / 2
+      ? aiCounts[0] : iBindingCount / 2));
+   aiCounts[0] = iBindingCount + 1;
+   aiCounts[1] = 0;
+   ASSURE(SymTable_mapUntil(oSymTable, countUntil, aiCounts) == 0);
+   ASSURE(aiCounts[1] == iBindingCount / 2);
+
+   iCount = 0;
+   SymTable_iterBegin(oSymTable, &sIter);
+   while (SymTable_iterNext(oSymTable, &sIter, NULL, &pvValue))
+      iCount += *(int*)pvValue;
+   for (i = 1; i < iBindingCount; i += 2)
+      iCount -= piVisits[i];
+   ASSURE(iCount == 0);
+
+   SymTable_free(oSymTable);
+   free(piVisits);
+   free(pacKeys);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* A Tally object accumulates the number of bindings visited and the
+   total length of their keys. */
+
+struct Tally
+{
+   size_t uCount;
+   size_t uKeyLengths;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Count the visit of pcKey in the int that pvValue points to. */
+
+static void countVisit(const char *pcKey, void *pvValue, void *pvExtra)
+{
+   assert(pcKey != NULL);
+   assert(pvValue != NULL);
+   (void)pvExtra;
+
+   (*(int*)pvValue)++;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Add pcKey to the Tally pvAccumulator. */
+
+static void tallyBinding(const char *pcKey, void *pvValue,
+   void *pvAccumulator, void *pvExtra)
+{
+   struct Tally *psTally = (struct Tally*)pvAccumulator;
+
+   assert(pcKey != NULL);
+   assert(pvAccumulator != NULL);
+   (void)pvValue;
+   (void)pvExtra;
+
+   psTally->uCount++;
+   psTally->uKeyLengths += strlen(pcKey);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Add the Tally pvAccumulator to the Tally pvResult. */
+
+static void mergeTally(void *pvResult, const void *pvAccumulator,
+   void *pvExtra)
+{
+   const struct Tally *psFrom = (const struct Tally*)pvAccumulator;
+
+   (void)pvExtra;
+   ((struct Tally*)pvResult)->uCount += psFrom->uCount;
+   ((struct Tally*)pvResult)->uKeyLengths += psFrom->uKeyLengths;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_mapParallel() and SymTable_mapReduce() with several
+   thread counts on a SymTable object holding iBindingCount bindings. */
+
+static void testParallelMap(int iBindingCount)
+{
+   enum {MAX_KEY_LENGTH = 16};
+   static const size_t THREAD_COUNTS[] = {0, 1, 2, 3, 8};
+   enum {THREAD_COUNT_COUNT =
+      sizeof(THREAD_COUNTS) / sizeof(THREAD_COUNTS[0])};
+
+   SymTable_T oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   int *piVisits;
+   struct Tally sTally;
+   size_t uKeyLengths = 0;
+   int iRound;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable_mapParallel and SymTable_mapReduce.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   piVisits = calloc((size_t)iBindingCount + 1, sizeof(*piVisits));
+   ASSURE(piVisits != NULL);
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "par%d", i);
+      uKeyLengths += strlen(acKey);
+      ASSURE(SymTable_put(oSymTable, acKey, &piVisits[i]));
+   }
+
+   /* Every binding is visited exactly once per traversal, whatever the
+      number of threads. */
+   for (iRound = 0; iRound < THREAD_COUNT_COUNT; iRound++)
+   {
+      SymTable_mapParallel(oSymTable, countVisit, NULL,
+         THREAD_COUNTS[iRound]);
+      for (i = 0; i < iBindingCount; i++)
+         ASSURE(piVisits[i] == iRound + 1);
+
+      sTally.uCount = 0;
+      sTally.uKeyLengths = 0;
+      SymTable_mapReduce(oSymTable, tallyBinding, mergeTally,
+         sizeof(sTally), &sTally, NULL, THREAD_COUNTS[iRound]);
+      ASSURE(sTally.uCount == (size_t)iBindingCount);
+      ASSURE(sTally.uKeyLengths == uKeyLengths);
+   }
+
+   SymTable_free(oSymTable);
+   free(piVisits);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the instrumentation counters of SymTable_getStats() with a
+   SymTable object that holds iBindingCount bindings. In a build without
+   them, they must all be 0. */
+
+static void testInstrumentation(int iBindingCount)
+{
+   enum {MAX_KEY_LENGTH = 24};
+
+   SymTable_T oSymTable;
+   struct SymTable_Stats sStats;
+   char acKey[MAX_KEY_LENGTH];
+   size_t uBytes;
+   size_t uChains = 0;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the instrumentation of SymTable_getStats.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   SymTable_getStats(oSymTable, &sStats);
+   uBytes = sStats.uBytesAllocated;
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "ins%d", i);
+      ASSURE(SymTable_put(oSymTable, acKey, oSymTable));
+   }
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "ins%d", i);
+      ASSURE(SymTable_get(oSymTable, acKey) == oSymTable);
+      sprintf(acKey, "missing%d", i);
+      ASSURE(SymTable_get(oSymTable, acKey) == NULL);
+   }
+   SymTable_getStats(oSymTable, &sStats);
+
+   if (! sStats.iInstrumented)
+   {
+      ASSURE(sStats.uLookups == 0 && sStats.uHits == 0);
+      ASSURE(sStats.uMisses == 0 && sStats.uMaxProbes == 0);
+      ASSURE(sStats.dMeanProbes == 0.0 && sStats.dResizeNs == 0.0);
+      ASSURE(sStats.uBytesAllocated == 0);
+      for (i = 0; i < SYMTABLE_STATS_CHAIN_LENGTHS; i++)
+         ASSURE(sStats.auChainLengths[i] == 0);
+      SymTable_free(oSymTable);
+      return;
+   }
+
+   /* Each put searches first, and so does each get. */
+   ASSURE(sStats.uLookups == sStats.uHits + sStats.uMisses);
+   ASSURE(sStats.uHits >= (size_t)iBindingCount);
+   ASSURE(sStats.uMisses >= 2 * (size_t)iBindingCount);
+   ASSURE(sStats.dMeanProbes <= (double)sStats.uMaxProbes);
+   ASSURE(iBindingCount == 0 || sStats.uMaxProbes > 0);
+   ASSURE(sStats.uBytesAllocated > uBytes);
+   ASSURE(sStats.dResizeNs >= 0.0);
+   ASSURE(sStats.uResizeCount == 0 || sStats.dResizeNs > 0.0);
+   for (i = 0; i < SYMTABLE_STATS_CHAIN_LENGTHS; i++)
+      uChains += sStats.auChainLengths[i];
+   ASSURE(uChains <= sStats.uBucketCount + sStats.uLength);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test many small SymTable objects whose lengths cross the point where
+   an implementation outgrows its initial storage, in both directions.
+   Each must return to its initial bucket count once nearly empty. */
+
+static void testSmallTables(void)
+{
+   enum {MAX_KEY_LENGTH = 16, MAX_LENGTH = 64, TABLE_COUNT = 100};
+
+   SymTable_T aoSymTables[TABLE_COUNT];
+   struct SymTable_Stats sStats;
+   char acKey[MAX_KEY_LENGTH];
+   size_t auInitialBuckets[TABLE_COUNT];
+   int iTable;
+   int i;
+   int j;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing many small SymTable objects.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   for (iTable = 0; iTable < TABLE_COUNT; iTable++)
+   {
+      aoSymTables[iTable] = SymTable_new();
+      ASSURE(aoSymTables[iTable] != NULL);
+      SymTable_getStats(aoSymTables[iTable], &sStats);
+      auInitialBuckets[iTable] = sStats.uBucketCount;
+   }
+
+   for (iTable = 0; iTable < TABLE_COUNT; iTable++)
+      for (i = 0; i < iTable % MAX_LENGTH + 1; i++)
+      {
+         sprintf(acKey, "t%dk%d", iTable, i);
+         ASSURE(SymTable_put(aoSymTables[iTable], acKey, &aoSymTables[iTable]));
+         for (j = 0; j <= i; j++)
+         {
+            sprintf(acKey, "t%dk%d", iTable, j);
+            ASSURE(SymTable_get(aoSymTables[iTable], acKey)
+               == &aoSymTables[iTable]);
+         }
+      }
+
+   for (iTable = 0; iTable < TABLE_COUNT; iTable++)
+   {
+      for (i = iTable % MAX_LENGTH; i > 0; i--)
+      {
+         sprintf(acKey, "t%dk%d", iTable, i);
+         ASSURE(SymTable_remove(aoSymTables[iTable], acKey)
+            == &aoSymTables[iTable]);
+         ASSURE(! SymTable_contains(aoSymTables[iTable], acKey));
+      }
+      ASSURE(SymTable_getLength(aoSymTables[iTable]) == 1);
+      sprintf(acKey, "t%dk0", iTable);
+      ASSURE(SymTable_contains(aoSymTables[iTable], acKey));
+      SymTable_getStats(aoSymTables[iTable], &sStats);
+      ASSURE(sStats.uBucketCount == auInitialBuckets[iTable]);
+      SymTable_free(aoSymTables[iTable]);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the SymTable extension functions.  Write the output of the
+   tests to stdout.  argv[1] is the number of bindings to put into
+   potentially large SymTable objects.  Exit with EXIT_FAILURE if
+   argv[1] is missing or not numeric.  Otherwise return 0. */
+
+int main(int argc, char *argv[])
+{
+   int iBindingCount;
+
+   if (argc != 2)
+   {
+      fprintf(stderr, "Usage: %s bindingcount\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   if ((sscanf(argv[1], "%d", &iBindingCount) != 1)
+       || (iBindingCount < 0))
+   {
+      fprintf(stderr, "bindingcount must be a nonnegative number\n");
+      exit(EXIT_FAILURE);
+   }
+
+   testKeyLengths();
+   testInterning();
+   testSlices();
+   testGetOrPut(iBindingCount);
+   testBatch(iBindingCount);
+   testIncrementalResize(iBindingCount);
+   testHashFunctions(iBindingCount);
+   testBucketSpread(iBindingCount);
+   testGrowthPolicy(iBindingCount);
+   testReserveAndShrink(iBindingCount);
+   testChurn(iBindingCount);
+   testOrderedQueries(iBindingCount);
+   testReorder(iBindingCount);
+   testSmallTables();
+   testIteration(iBindingCount);
+   testParallelMap(iBindingCount);
+   testInstrumentation(iBindingCount);
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}
@@ -0,0 +1,451 @@
+/*--------------------------------------------------------------------*/
+/* testsymtablestress.c                                               */
+/* Author: Chinmayi R                                                 */
+/*--------------------------------------------------------------------*/
+
+#include "symtable.h"
+#ifdef SYMTABLE_CONC_STRIPES
+#include "symtableconc.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+
+/*--------------------------------------------------------------------*/
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/*--------------------------------------------------------------------*/
+
+/* Number of threads started by each test. */
+enum {THREAD_COUNT = 8};
+
+/* Length of the buffers that hold generated keys. */
+enum {MAX_KEY_LENGTH = 48};
+
+/*--------------------------------------------------------------------*/
+
+/* If !iSuccessful, print a message to stdout indicating that the
+   test at line iLineNum failed. */
+
+static void assure(int iSuccessful, int iLineNum)
+{
+   if (! iSuccessful)
+   {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* A Worker object is the argument of one test thread:
+   - oSymTable: the table shared by every thread.
+   - iId: the thread's number, from 0 to THREAD_COUNT - 1.
+   - iCount: the number of keys or operations the thread works on.
+   - piResults: an array of iCount results the thread reports, or NULL.
+   - iSuccesses: a count of successful operations the thread reports. */
+
+struct Worker
+{
+   SymTable_T oSymTable;
+   int iId;
+   int iCount;
+   int *piResults;
+   int iSuccesses;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Start THREAD_COUNT threads running pfRun on the elements of asWorkers,
+   and wait for all of them to finish. */
+
+static void runWorkers(void *(*pfRun)(void *),
+   struct Worker asWorkers[THREAD_COUNT])
+{
+   pthread_t aThreads[THREAD_COUNT];
+   int i;
+   int iError;
+
+   for (i = 0; i < THREAD_COUNT; i++)
+   {
+      iError = pthread_create(&aThreads[i], NULL, pfRun, &asWorkers[i]);
+      ASSURE(iError == 0);
+   }
+   for (i = 0; i < THREAD_COUNT; i++)
+      pthread_join(aThreads[i], NULL);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Make the key of a thread's private binding: thread iId, index i. */
+
+static void privateKey(char *pcKey, int iId, int i)
+{
+   sprintf(pcKey, i % 2 ? "private_%d_%d_with_a_long_tail" : "p%d_%d",
+      iId, i);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Put, look up, replace and remove keys that no other thread uses, so
+   every result must match a single-threaded table. Odd-numbered keys
+   are removed again; even-numbered ones stay bound to the Worker. */
+
+static void *runPrivate(void *pvWorker)
+{
+   struct Worker *psWorker = (struct Worker*)pvWorker;
+   SymTable_T oSymTable = psWorker->oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   int i;
+
+   for (i = 0; i < psWorker->iCount; i++)
+   {
+      privateKey(acKey, psWorker->iId, i);
+      ASSURE(SymTable_put(oSymTable, acKey, acKey));
+      ASSURE(! SymTable_put(oSymTable, acKey, NULL));
+      ASSURE(SymTable_get(oSymTable, acKey) == acKey);
+      ASSURE(SymTable_replace(oSymTable, acKey, psWorker) == acKey);
+      ASSURE(SymTable_contains(oSymTable, acKey));
+      if (i % 2)
+      {
+         ASSURE(SymTable_remove(oSymTable, acKey) == psWorker);
+         ASSURE(SymTable_get(oSymTable, acKey) == NULL);
+      }
+   }
+   return NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Try to put every one of iCount shared keys, recording in piResults
+   which puts succeeded. */
+
+static void *runContendedPut(void *pvWorker)
+{
+   struct Worker *psWorker = (struct Worker*)pvWorker;
+   char acKey[MAX_KEY_LENGTH];
+   int i;
+
+   for (i = 0; i < psWorker->iCount; i++)
+   {
+      sprintf(acKey, "shared%d", i);
+      psWorker->piResults[i] =
+         SymTable_put(psWorker->oSymTable, acKey, psWorker);
+   }
+   return NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Try to remove every one of iCount shared keys, recording in
+   piResults which removes found the key. */
+
+static void *runContendedRemove(void *pvWorker)
+{
+   struct Worker *psWorker = (struct Worker*)pvWorker;
+   char acKey[MAX_KEY_LENGTH];
+   int i;
+
+   for (i = 0; i < psWorker->iCount; i++)
+   {
+      sprintf(acKey, "shared%d", i);
+      psWorker->piResults[i] =
+         SymTable_remove(psWorker->oSymTable, acKey) != NULL;
+   }
+   return NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Even-numbered threads read iCount stable keys, whose values are the
+   keys' numbers, over and over; odd-numbered threads put and remove
+   iCount fresh keys each, growing the table under the readers. */
+
+static void *runReadersAndWriters(void *pvWorker)
+{
+   enum {READ_ROUNDS = 4};
+   struct Worker *psWorker = (struct Worker*)pvWorker;
+   SymTable_T oSymTable = psWorker->oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   int *piValue;
+   int iRound;
+   int i;
+
+   if (psWorker->iId % 2 == 0)
+   {
+      for (iRound = 0; iRound < READ_ROUNDS; iRound++)
+         for (i = 0; i < psWorker->iCount; i++)
+         {
+            sprintf(acKey, "stable%d", i);
+            piValue = (int*)SymTable_get(oSymTable, acKey);
+            ASSURE(piValue != NULL && *piValue == i);
+            psWorker->iSuccesses += piValue != NULL;
+         }
+   }
+   else
+   {
+      for (i = 0; i < psWorker->iCount; i++)
+      {
+         sprintf(acKey, "fresh_%d_%d", psWorker->iId, i);
+         psWorker->iSuccesses += SymTable_put(oSymTable, acKey, acKey);
+      }
+      for (i = 0; i < psWorker->iCount; i += 2)
+      {
+         sprintf(acKey, "fresh_%d_%d", psWorker->iId, i);
+         ASSURE(SymTable_remove(oSymTable, acKey) != NULL);
+      }
+   }
+   return NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test THREAD_COUNT threads each working on iBindingCount keys of their
+   own. */
+
+static void testPrivateKeys(int iBindingCount)
+{
+   SymTable_T oSymTable;
+   struct Worker asWorkers[THREAD_COUNT];
+   char acKey[MAX_KEY_LENGTH];
+   int iThread;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing threads that use disjoint keys.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   for (iThread = 0; iThread < THREAD_COUNT; iThread++)
+   {
+      asWorkers[iThread].oSymTable = oSymTable;
+      asWorkers[iThread].iId = iThread;
+      asWorkers[iThread].iCount = iBindingCount;
+      asWorkers[iThread].piResults = NULL;
+      asWorkers[iThread].iSuccesses = 0;
+   }
+   runWorkers(runPrivate, asWorkers);
+
+   ASSURE(SymTable_getLength(oSymTable) ==
+      (size_t)THREAD_COUNT * (size_t)((iBindingCount + 1) / 2));
+   for (iThread = 0; iThread < THREAD_COUNT; iThread++)
+      for (i = 0; i < iBindingCount; i++)
+      {
+         privateKey(acKey, iThread, i);
+         ASSURE(SymTable_get(oSymTable, acKey) ==
+            (i % 2 ? NULL : &asWorkers[iThread]));
+      }
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test THREAD_COUNT threads racing to put, and then to remove, the same
+   iBindingCount keys. Each key must be put exactly once and removed
+   exactly once, and keep the value of the thread whose put succeeded. */
+
+static void testContendedKeys(int iBindingCount)
+{
+   SymTable_T oSymTable;
+   struct Worker asWorkers[THREAD_COUNT];
+   char acKey[MAX_KEY_LENGTH];
+   int iThread;
+   int iWinners;
+   int iWinner;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing threads that race on the same keys.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   for (iThread = 0; iThread < THREAD_COUNT; iThread++)
+   {
+      asWorkers[iThread].oSymTable = oSymTable;
+      asWorkers[iThread].iId = iThread;
+      asWorkers[iThread].iCount = iBindingCount;
+      asWorkers[iThread].piResults =
+         (int*)calloc((size_t)iBindingCount + 1, sizeof(int));
+      ASSURE(asWorkers[iThread].piResults != NULL);
+      asWorkers[iThread].iSuccesses = 0;
+   }
+
+   runWorkers(runContendedPut, asWorkers);
+   ASSURE(SymTable_getLength(oSymTable) == (size_t)iBindingCount);
+   for (i = 0; i < iBindingCount; i++)
+   {
+      iWinners = 0;
+      iWinner = 0;
+      for (iThread = 0; iThread < THREAD_COUNT; iThread++)
+         if (asWorkers[iThread].piResults[i])
+         {
+            iWinners++;
+            iWinner = iThread;
+         }
+      ASSURE(iWinners == 1);
+      sprintf(acKey, "shared%d", i);
+      ASSURE(SymTable_get(oSymTable, acKey) == &asWorkers[iWinner]);
+   }
+
+   runWorkers(runContendedRemove, asWorkers);
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+   for (i = 0; i < iBindingCount; i++)
+   {
+      iWinners = 0;
+      for (iThread = 0; iThread < THREAD_COUNT; iThread++)
+         iWinners += asWorkers[iThread].piResults[i];
+      ASSURE(iWinners == 1);
+   }
+
+   for (iThread = 0; iThread < THREAD_COUNT; iThread++)
+      free(asWorkers[iThread].piResults);
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test readers of iBindingCount stable keys while writers grow the
+   table around them. Every read must find its key. */
+
+static void testReadersDuringGrowth(int iBindingCount)
+{
+   SymTable_T oSymTable;
+   struct Worker asWorkers[THREAD_COUNT];
+   char acKey[MAX_KEY_LENGTH];
+   int *piValues;
+   int iThread;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing readers while writers grow the table.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   piValues = (int*)calloc((size_t)iBindingCount + 1, sizeof(int));
+   ASSURE(piValues != NULL);
+   for (i = 0; i < iBindingCount; i++)
+   {
+      piValues[i] = i;
+      sprintf(acKey, "stable%d", i);
+      ASSURE(SymTable_put(oSymTable, acKey, &piValues[i]));
+   }
+
+   for (iThread = 0; iThread < THREAD_COUNT; iThread++)
+   {
+      asWorkers[iThread].oSymTable = oSymTable;
+      asWorkers[iThread].iId = iThread;
+      asWorkers[iThread].iCount = iBindingCount;
+      asWorkers[iThread].piResults = NULL;
+      asWorkers[iThread].iSuccesses = 0;
+   }
+   runWorkers(runReadersAndWriters, asWorkers);
+
+   /* Each writer leaves its odd-numbered fresh keys behind. */
+   for (iThread = 1; iThread < THREAD_COUNT; iThread += 2)
+      ASSURE(asWorkers[iThread].iSuccesses == iBindingCount);
+   ASSURE(SymTable_getLength(oSymTable) ==
+      (size_t)iBindingCount
+      + (size_t)(THREAD_COUNT / 2) * (size_t)(iBindingCount / 2));
+
+   SymTable_free(oSymTable);
+   free(piValues);
+}
+
+/*--------------------------------------------------------------------*/
+
+#ifdef SYMTABLE_CONC_STRIPES
+
+/* Test that iBindingCount identifier keys, and as many decimal integer
+   keys, spread evenly over the stripes of the striped implementation.
+   No stripe may hold much more than twice its share, or the stripe
+   grows the table early and its lock takes most of the contention. */
+
+static void testStripeBalance(int iBindingCount)
+{
+   static const char *const apcFormats[] = {"identifier_%d", "%d"};
+
+   int aiCounts[SYMTABLECONC_STRIPE_COUNT];
+   char acKey[MAX_KEY_LENGTH];
+   int iFormat;
+   int iStripe;
+   int iMax;
+   int iEmpty;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the balance of keys over the stripes.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   for (iFormat = 0; iFormat < 2; iFormat++)
+   {
+      for (iStripe = 0; iStripe < SYMTABLECONC_STRIPE_COUNT; iStripe++)
+         aiCounts[iStripe] = 0;
+      for (i = 0; i < iBindingCount; i++)
+      {
+         sprintf(acKey, apcFormats[iFormat], i);
+         aiCounts[SymTableConc_stripeOf(acKey)]++;
+      }
+
+      iMax = 0;
+      iEmpty = 0;
+      for (iStripe = 0; iStripe < SYMTABLECONC_STRIPE_COUNT; iStripe++)
+      {
+         if (aiCounts[iStripe] > iMax) iMax = aiCounts[iStripe];
+         if (aiCounts[iStripe] == 0) iEmpty++;
+      }
+      ASSURE(iMax <= 2 * (iBindingCount / SYMTABLECONC_STRIPE_COUNT) + 16);
+      if (iBindingCount >= 16 * SYMTABLECONC_STRIPE_COUNT)
+         ASSURE(iEmpty == 0);
+   }
+}
+
+#endif
+
+/*--------------------------------------------------------------------*/
+
+/* Test a thread-safe SymTable implementation with THREAD_COUNT
+   threads.  Write the output of the tests to stdout.  argv[1] is the
+   number of keys each thread works on.  Exit with EXIT_FAILURE if
+   argv[1] is missing or not numeric.  Otherwise return 0. */
+
+int main(int argc, char *argv[])
+{
+   int iBindingCount;
+
+   if (argc != 2)
+   {
+      fprintf(stderr, "Usage: %s bindingcount\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   if ((sscanf(argv[1], "%d", &iBindingCount) != 1)
+       || (iBindingCount < 0))
+   {
+      fprintf(stderr, "bindingcount must be a nonnegative number\n");
+      exit(EXIT_FAILURE);
+   }
+
+   testPrivateKeys(iBindingCount);
+   testContendedKeys(iBindingCount);
+   testReadersDuringGrowth(iBindingCount);
+#ifdef SYMTABLE_CONC_STRIPES
+   testStripeBalance(iBindingCount);
+#endif
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}